@@ -0,0 +1,136 @@
+/*
+ * Headless LV2 host measuring the CPU cost of the DeepFilterNet plugin per block, at the block
+ * sizes audio hosts typically run. Blocks shorter than the model's hop cost nothing until one
+ * completes a hop, so the tail percentiles are what an audio callback has to budget for.
+ * Usage: Lv2HostBenchmark <bundleDir> [seconds] [attenuationLimit]
+ */
+
+#include <dlfcn.h>
+#include <lv2/core/lv2.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr uint32_t LATENCY_PORT = 3;
+
+double getThreadCpuMicroseconds() {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec * 1e6 + time.tv_nsec * 1e-3;
+}
+
+/**
+ * @brief A voice-like harmonic tone over noise, so the model has something to separate.
+ */
+std::vector<float> generateSignal(size_t numSamples) {
+    std::mt19937 generator(1);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::vector<float> signal(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        double t = i / SAMPLE_RATE;
+        double voice = 0.0;
+        for (int harmonic = 1; harmonic <= 5; ++harmonic) {
+            voice += std::sin(2.0 * std::numbers::pi * 180.0 * harmonic * t) / harmonic;
+        }
+        signal[i] = static_cast<float>(0.2 * voice * (0.5 + 0.5 * std::sin(3.0 * t))) +
+                    noise(generator);
+    }
+    return signal;
+}
+
+void measure(const LV2_Descriptor* descriptor, const std::string& bundleDir,
+             const std::vector<float>& signal, uint32_t blockSize, float attenuationLimit) {
+    LV2_Handle instance =
+        descriptor->instantiate(descriptor, SAMPLE_RATE, bundleDir.c_str(), nullptr);
+    if (!instance) {
+        std::fprintf(stderr, "Could not instantiate the plugin.\n");
+        return;
+    }
+
+    std::vector<float> input(blockSize), output(blockSize);
+    float latency = 0.0f;
+    descriptor->connect_port(instance, 0, input.data());
+    descriptor->connect_port(instance, 1, output.data());
+    descriptor->connect_port(instance, 2, &attenuationLimit);
+    descriptor->connect_port(instance, LATENCY_PORT, &latency);
+    if (descriptor->activate) {
+        descriptor->activate(instance);
+    }
+
+    std::vector<double> costs;
+    for (size_t offset = 0; offset + blockSize <= signal.size(); offset += blockSize) {
+        std::copy_n(signal.begin() + offset, blockSize, input.begin());
+        double start = getThreadCpuMicroseconds();
+        descriptor->run(instance, blockSize);
+        costs.push_back(getThreadCpuMicroseconds() - start);
+    }
+
+    if (descriptor->deactivate) {
+        descriptor->deactivate(instance);
+    }
+    descriptor->cleanup(instance);
+    if (costs.empty()) {
+        return;
+    }
+
+    double total = 0.0;
+    for (double cost : costs) {
+        total += cost;
+    }
+    const double blockMicroseconds = blockSize / SAMPLE_RATE * 1e6;
+    std::sort(costs.begin(), costs.end());
+    auto percentile = [&costs](double p) {
+        return costs[std::min(costs.size() - 1, size_t(p * costs.size()))];
+    };
+    std::printf("%8u %10.1f %10.1f %10.1f %10.1f %10.1f %8.0f %9.3f\n", blockSize,
+                blockMicroseconds, total / costs.size(), percentile(0.5), percentile(0.99),
+                costs.back(), latency, total / (costs.size() * blockMicroseconds));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <bundleDir> [seconds] [attenuationLimit]\n", argv[0]);
+        return 1;
+    }
+    const std::string bundleDir = argv[1];
+    const double seconds = argc > 2 ? std::stod(argv[2]) : 10.0;
+    const float attenuationLimit = argc > 3 ? std::stof(argv[3]) : 100.0f;
+
+    const std::string binaryPath = bundleDir + "/DeepFilterLv2.so";
+    void* library = dlopen(binaryPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!library) {
+        std::fprintf(stderr, "Could not load %s: %s\n", binaryPath.c_str(), dlerror());
+        return 1;
+    }
+    auto getDescriptor =
+        reinterpret_cast<LV2_Descriptor_Function>(dlsym(library, "lv2_descriptor"));
+    const LV2_Descriptor* descriptor = getDescriptor ? getDescriptor(0) : nullptr;
+    if (!descriptor) {
+        std::fprintf(stderr, "%s exports no LV2 plugin.\n", binaryPath.c_str());
+        dlclose(library);
+        return 1;
+    }
+
+    const std::vector<float> signal = generateSignal(static_cast<size_t>(seconds * SAMPLE_RATE));
+    std::printf("%s, %.1f s at 48 kHz, attenuation limit %.0f dB\n", descriptor->URI, seconds,
+                attenuationLimit);
+    std::printf("%8s %10s %10s %10s %10s %10s %8s %9s\n", "block", "period us", "mean us",
+                "p50 us", "p99 us", "max us", "latency", "rt load");
+    for (uint32_t blockSize : {64u, 128u, 256u, 480u, 512u, 1024u}) {
+        measure(descriptor, bundleDir, signal, blockSize, attenuationLimit);
+    }
+
+    dlclose(library);
+    return 0;
+}
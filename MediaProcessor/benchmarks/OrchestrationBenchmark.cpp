@@ -0,0 +1,78 @@
+/*
+ * Times AudioProcessor::isolateVocals() with the FFmpeg and FFprobe calls replayed from a
+ * command cassette, so what is measured is the orchestration around them: chunk scheduling,
+ * the DeepFilterNet inference and the crossfades, without the codecs' cost or their noise.
+ * Record the cassette once on a machine with FFmpeg by running this with the config's
+ * `command_cassette` mode set to "record", then set it to "replay". The output path is part of
+ * the recorded commands, so it has to stay the same between the two.
+ * Usage: OrchestrationBenchmark <config.json> <input> <output> [repetitions]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../src/AudioProcessor.h"
+#include "../src/ConfigManager.h"
+
+namespace fs = std::filesystem;
+
+int main(int argc, char* argv[]) {
+    using namespace MediaProcessor;
+
+    if (argc < 4) {
+        std::fprintf(stderr,
+                     "Usage: OrchestrationBenchmark <config.json> <input> <output> "
+                     "[repetitions]\n");
+        return 1;
+    }
+    const fs::path inputPath = argv[2];
+    const fs::path outputPath = argv[3];
+    const int repetitions = argc > 4 ? std::stoi(argv[4]) : 10;
+
+    ConfigManager& configManager = ConfigManager::getInstance();
+    CassetteMode mode;
+    try {
+        configManager.loadConfig(argv[1]);
+        mode = configManager.getCommandCassette().mode;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    if (mode == CassetteMode::Off) {
+        std::fprintf(stderr, "command_cassette is off, so FFmpeg would be timed as well.\n");
+        return 1;
+    }
+
+    // A recording run has nothing to compare with; it only fills the cassette
+    const int runs = mode == CassetteMode::Record ? 1 : repetitions + 1;
+    std::vector<double> seconds;
+    for (int i = 0; i < runs; ++i) {
+        AudioProcessor audioProcessor(inputPath, outputPath);
+        auto start = std::chrono::steady_clock::now();
+        if (!audioProcessor.isolateVocals()) {
+            std::fprintf(stderr, "Run %d failed; is every command recorded?\n", i);
+            return 1;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        seconds.push_back(elapsed.count());
+    }
+    if (mode == CassetteMode::Record) {
+        std::printf("recorded in %.3f s\n", seconds.front());
+        return 0;
+    }
+
+    seconds.erase(seconds.begin());  // the first run loads the model and warms the caches
+    std::sort(seconds.begin(), seconds.end());
+    const double mean = std::accumulate(seconds.begin(), seconds.end(), 0.0) / seconds.size();
+    std::printf("%d replayed runs of %s, seconds\n", repetitions, inputPath.filename().c_str());
+    std::printf("%10s %10s %10s %10s\n", "min", "median", "mean", "max");
+    std::printf("%10.4f %10.4f %10.4f %10.4f\n", seconds.front(), seconds[seconds.size() / 2],
+                mean, seconds.back());
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Compares the PcmPipeline loops specialised on channel layout with the runtime-generic
+ * DYNAMIC_CHANNELS version, for the layouts instantiated explicitly.
+ * Usage: PcmPipelineBenchmark [seconds] [repetitions]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../src/PcmPipeline.h"
+
+namespace {
+
+using namespace MediaProcessor;
+
+template <class Body>
+double measureNanosecondsPerFrame(size_t numFrames, int repetitions, Body body) {
+    body();  // warm up caches and page in the buffers
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; ++i) {
+        body();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (double(numFrames) * repetitions);
+}
+
+template <typename Sample, int Channels>
+void compare(const char* layout, size_t numFrames, int repetitions) {
+    using Specialised = PcmPipeline<Sample, Channels>;
+    using Generic = PcmPipeline<Sample, DYNAMIC_CHANNELS>;
+
+    const size_t numSamples = numFrames * Channels;
+    std::vector<Sample> tail(numSamples), head(numSamples), output(numSamples);
+    std::vector<float> floats(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        floats[i] = float((i * 7919) % 2001) / 2000.0f - 0.5f;
+    }
+    Generic::fromFloat(floats.data(), tail.data(), numFrames, Channels);
+    Generic::fromFloat(floats.data(), head.data(), numFrames, Channels);
+
+    auto report = [&](const char* kernel, auto generic, auto specialised) {
+        double genericCost = measureNanosecondsPerFrame(numFrames, repetitions, generic);
+        double specialisedCost = measureNanosecondsPerFrame(numFrames, repetitions, specialised);
+        std::printf("%-14s %-10s %12.3f %12.3f %8.2fx\n", layout, kernel, genericCost,
+                    specialisedCost, genericCost / specialisedCost);
+    };
+
+    report(
+        "crossfade",
+        [&] {
+            Generic::crossfade(tail.data(), head.data(), output.data(), 0, numFrames, numFrames,
+                               Channels);
+        },
+        [&] {
+            Specialised::crossfade(tail.data(), head.data(), output.data(), 0, numFrames,
+                                   numFrames, Channels);
+        });
+    // Unity gain keeps the buffer unchanged across repetitions
+    report(
+        "gain", [&] { Generic::applyGain(output.data(), numFrames, Channels, 1.0f); },
+        [&] { Specialised::applyGain(output.data(), numFrames, Channels, 1.0f); });
+    report(
+        "toFloat", [&] { Generic::toFloat(tail.data(), floats.data(), numFrames, Channels); },
+        [&] { Specialised::toFloat(tail.data(), floats.data(), numFrames, Channels); });
+    report(
+        "fromFloat", [&] { Generic::fromFloat(floats.data(), output.data(), numFrames, Channels); },
+        [&] { Specialised::fromFloat(floats.data(), output.data(), numFrames, Channels); });
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const double seconds = argc > 1 ? std::stod(argv[1]) : 2.0;
+    const int repetitions = argc > 2 ? std::stoi(argv[2]) : 200;
+    const size_t numFrames = static_cast<size_t>(seconds * PIPELINE_SAMPLE_RATE);
+
+    std::printf("%zu frames per buffer, %d repetitions, ns per frame\n", numFrames, repetitions);
+    std::printf("%-14s %-10s %12s %12s %9s\n", "layout", "kernel", "generic", "specialised",
+                "speedup");
+    compare<int16_t, 1>("int16 mono", numFrames, repetitions);
+    compare<int16_t, 2>("int16 stereo", numFrames, repetitions);
+    compare<float, 1>("float mono", numFrames, repetitions);
+    compare<float, 2>("float stereo", numFrames, repetitions);
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * Measures the per-task cost of the ThreadPool submission paths with tiny task bodies, where
+ * queueing overhead dominates. Usage: ThreadPoolBenchmark [numTasks] [numThreads]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <latch>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace {
+
+std::atomic<size_t> allocationCount{0};
+
+struct Measurement {
+    double nanosecondsPerTask;
+    double allocationsPerTask;
+};
+
+void work(size_t workUnits, std::atomic<size_t>& sink) {
+    size_t value = 0;
+    for (size_t i = 0; i < workUnits; ++i) {
+        value += i ^ (value << 1);
+    }
+    sink.fetch_add(value | 1, std::memory_order_relaxed);
+}
+
+template <class Submit>
+Measurement measure(size_t numTasks, Submit submit) {
+    size_t allocationsBefore = allocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+
+    submit();
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    size_t allocations = allocationCount.load() - allocationsBefore;
+    return {std::chrono::duration<double, std::nano>(elapsed).count() / numTasks,
+            static_cast<double>(allocations) / numTasks};
+}
+
+void report(const char* name, size_t workUnits, const Measurement& measurement) {
+    std::printf("%-28s %10zu %14.1f %14.2f\n", name, workUnits, measurement.nanosecondsPerTask,
+                measurement.allocationsPerTask);
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+int main(int argc, char* argv[]) {
+    const size_t numTasks = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t numThreads = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+
+    ThreadPool pool(numThreads);
+    std::atomic<size_t> sink{0};
+
+    std::printf("%zu tasks on %zu threads\n", numTasks, numThreads);
+    std::printf("%-28s %10s %14s %14s\n", "path", "work units", "ns/task", "allocs/task");
+
+    for (size_t workUnits : {0, 64, 1024}) {
+        // What every task used to cost: bind + shared packaged_task + std::function
+        report("enqueue (bind+shared_ptr)", workUnits, measure(numTasks, [&]() {
+                   std::vector<std::future<void>> results;
+                   results.reserve(numTasks);
+                   for (size_t i = 0; i < numTasks; ++i) {
+                       auto task = std::make_shared<std::packaged_task<void()>>(
+                           std::bind(work, workUnits, std::ref(sink)));
+                       results.push_back(task->get_future());
+                       pool.post(std::function<void()>([task]() { (*task)(); }));
+                   }
+                   for (auto& result : results) {
+                       result.get();
+                   }
+               }));
+
+        report("enqueue", workUnits, measure(numTasks, [&]() {
+                   std::vector<std::future<void>> results;
+                   results.reserve(numTasks);
+                   for (size_t i = 0; i < numTasks; ++i) {
+                       results.push_back(pool.enqueue(work, workUnits, std::ref(sink)));
+                   }
+                   for (auto& result : results) {
+                       result.get();
+                   }
+               }));
+
+        report("post + latch", workUnits, measure(numTasks, [&]() {
+                   std::latch done(numTasks);
+                   for (size_t i = 0; i < numTasks; ++i) {
+                       pool.post([&sink, workUnits]() { work(workUnits, sink); }, done);
+                   }
+                   done.wait();
+               }));
+
+        report("postBulk", workUnits, measure(numTasks, [&]() {
+                   std::latch done(numTasks);
+                   auto body = [&sink, workUnits](size_t) { work(workUnits, sink); };
+                   pool.postBulk(numTasks, body, done);
+                   done.wait();
+               }));
+    }
+
+    return sink.load() == 0;  // keeps the work from being optimized away
+}
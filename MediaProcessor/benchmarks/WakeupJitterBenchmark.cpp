@@ -0,0 +1,114 @@
+/*
+ * Measures how long a task posted to an idle ThreadPool worker waits before it starts, per
+ * idle strategy, at the pace of a real-time stream of frame blocks. Also reports the CPU the
+ * process burnt meanwhile, which is what polling trades for the lower latency.
+ * Usage: WakeupJitterBenchmark [numSamples] [periodMicroseconds] [realtimePriority]
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <latch>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+struct Strategy {
+    const char* name;
+    IdleStrategy idleStrategy;
+};
+
+double getProcessCpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+WorkerHooks realtimeHooks(int priority) {
+    if (priority <= 0) {
+        return {};
+    }
+    return {[priority](size_t) {
+                sched_param param{};
+                param.sched_priority = priority;
+                if (int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param)) {
+                    std::fprintf(stderr, "SCHED_FIFO %d: %s\n", priority, std::strerror(error));
+                }
+            },
+            nullptr, nullptr};
+}
+
+void measure(const Strategy& strategy, size_t numSamples, std::chrono::microseconds period,
+             int priority) {
+    ThreadPool pool(ElasticLimits{1, 1}, realtimeHooks(priority), strategy.idleStrategy);
+    std::vector<double> latencies(numSamples);
+
+    double cpuBefore = getProcessCpuSeconds();
+    auto wallStart = Clock::now();
+    auto nextPost = wallStart;
+    for (size_t i = 0; i < numSamples; ++i) {
+        nextPost += period;
+        std::this_thread::sleep_until(nextPost);
+
+        std::latch done(1);
+        auto posted = Clock::now();
+        pool.post(
+            [&latencies, i, posted]() {
+                latencies[i] =
+                    std::chrono::duration<double, std::micro>(Clock::now() - posted).count();
+            },
+            done);
+        done.wait();
+    }
+    double wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+    double cpuShare = (getProcessCpuSeconds() - cpuBefore) / wallSeconds;
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies[std::min(latencies.size() - 1, size_t(p * latencies.size()))];
+    };
+    std::printf("%-22s %10.1f %10.1f %10.1f %10.1f %10.0f%%\n", strategy.name, percentile(0.5),
+                percentile(0.99), percentile(0.999), latencies.back(), cpuShare * 100.0);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t numSamples = argc > 1 ? std::stoul(argv[1]) : 5000;
+    const std::chrono::microseconds period(argc > 2 ? std::stoul(argv[2]) : 1000);
+    const int priority = argc > 3 ? std::stoi(argv[3]) : 0;
+
+    // The stream period decides which phase a worker is in when the next block arrives
+    const Strategy strategies[] = {
+        {"park", {}},
+        {"yield 2 periods", {0us, 2 * period}},
+        {"spin 2 periods", {2 * period, 0us}},
+        {"spin 50us, yield 2p", {50us, 2 * period}},
+    };
+
+    std::printf("%zu samples every %lld us, realtime priority %d\n", numSamples,
+                static_cast<long long>(period.count()), priority);
+    std::printf("%-22s %10s %10s %10s %10s %11s\n", "strategy", "p50 us", "p99 us", "p99.9 us",
+                "max us", "cpu");
+    if (numSamples == 0) {
+        return 0;
+    }
+    for (const Strategy& strategy : strategies) {
+        measure(strategy, numSamples, period, priority);
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+# Micro-benchmarks. They report timings rather than pass/fail, so they are not added to CTest.
+
+macro(add_benchmark_executable name)
+    add_executable(${name} ${ARGN})
+    target_link_libraries(${name} PRIVATE Threads::Threads)
+    set_target_properties(${name} PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/benchmarks"
+    )
+endmacro()
+
+add_benchmark_executable(ThreadPoolBenchmark
+    ${CMAKE_SOURCE_DIR}/benchmarks/ThreadPoolBenchmark.cpp
+)
+
+add_benchmark_executable(WakeupJitterBenchmark
+    ${CMAKE_SOURCE_DIR}/benchmarks/WakeupJitterBenchmark.cpp
+)
+
+add_benchmark_executable(PcmPipelineBenchmark
+    ${CMAKE_SOURCE_DIR}/benchmarks/PcmPipelineBenchmark.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmPipeline.cpp
+)
+
+# Replays FFmpeg from a command cassette, see the usage at the top of the source
+add_benchmark_executable(OrchestrationBenchmark
+    ${CMAKE_SOURCE_DIR}/benchmarks/OrchestrationBenchmark.cpp
+    ${CMAKE_SOURCE_DIR}/src/AudioProcessor.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmPipeline.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterStream.cpp
+    ${CMAKE_SOURCE_DIR}/src/SpeechDetector.cpp
+    ${CMAKE_SOURCE_DIR}/src/CostModel.cpp
+    ${CMAKE_SOURCE_DIR}/src/AsyncRuntime.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandExecutor.cpp
+    ${CMAKE_SOURCE_DIR}/src/WorkerContext.cpp
+    ${CMAKE_SOURCE_DIR}/src/ProcessReactor.cpp
+    ${CMAKE_SOURCE_DIR}/src/TaskGraph.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp
+    ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+    ${CMAKE_SOURCE_DIR}/src/HardwareUtils.cpp
+    ${CMAKE_SOURCE_DIR}/src/ConfigManager.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+)
+target_link_libraries(OrchestrationBenchmark PRIVATE
+    ${CMAKE_SOURCE_DIR}/lib/libdf.so ${SNDFILE_LIBRARIES} nlohmann_json::nlohmann_json fmt::fmt
+)
@@ -0,0 +1,46 @@
+# LV2 plugin running the DeepFilterNet frame loop inside a host's audio graph. The bundle is
+# self-contained: the plugin, its Turtle descriptions, libdf and the model.
+
+pkg_check_modules(LV2 REQUIRED lv2)
+
+set(LV2_BUNDLE_DIR "${CMAKE_BINARY_DIR}/deepfilter.lv2")
+
+add_library(DeepFilterLv2 MODULE
+    ${CMAKE_SOURCE_DIR}/plugins/DeepFilterLv2.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterStream.cpp
+)
+target_include_directories(DeepFilterLv2 PRIVATE ${LV2_INCLUDE_DIRS})
+target_link_libraries(DeepFilterLv2 PRIVATE ${DF_LIBRARY})
+set_target_properties(DeepFilterLv2 PROPERTIES
+    PREFIX ""
+    LIBRARY_OUTPUT_DIRECTORY "${LV2_BUNDLE_DIR}"
+    CXX_VISIBILITY_PRESET hidden
+    BUILD_RPATH "$ORIGIN"
+    INSTALL_RPATH "$ORIGIN"
+)
+
+configure_file(${CMAKE_SOURCE_DIR}/plugins/deepfilter.lv2/manifest.ttl.in
+               ${LV2_BUNDLE_DIR}/manifest.ttl @ONLY)
+configure_file(${CMAKE_SOURCE_DIR}/plugins/deepfilter.lv2/deepfilter.ttl
+               ${LV2_BUNDLE_DIR}/deepfilter.ttl COPYONLY)
+
+add_custom_command(TARGET DeepFilterLv2 POST_BUILD
+    COMMAND ${CMAKE_COMMAND} -E copy_if_different
+        ${DF_LIBRARY}
+        ${CMAKE_SOURCE_DIR}/res/DeepFilterNet3_ll_onnx.tar.gz
+        ${LV2_BUNDLE_DIR}
+    # The model's parameters, for the delay reported to the host
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${LV2_BUNDLE_DIR}/DeepFilterNet3_ll_onnx
+    COMMAND ${CMAKE_COMMAND} -E copy_if_different
+        ${CMAKE_SOURCE_DIR}/res/DeepFilterNet3_ll_onnx/tmp/export/config.ini
+        ${LV2_BUNDLE_DIR}/DeepFilterNet3_ll_onnx/config.ini)
+
+if(BUILD_BENCHMARKS)
+    # Headless host: `Lv2HostBenchmark <build>/deepfilter.lv2` reports per-block CPU cost
+    add_benchmark_executable(Lv2HostBenchmark
+        ${CMAKE_SOURCE_DIR}/benchmarks/Lv2HostBenchmark.cpp
+    )
+    target_include_directories(Lv2HostBenchmark PRIVATE ${LV2_INCLUDE_DIRS})
+    target_link_libraries(Lv2HostBenchmark PRIVATE ${CMAKE_DL_LIBS})
+    add_dependencies(Lv2HostBenchmark DeepFilterLv2)
+endif()
@@ -4,13 +4,36 @@ add_executable(MediaProcessor
     ${CMAKE_SOURCE_DIR}/src/main.cpp
     ${CMAKE_SOURCE_DIR}/src/ConfigManager.cpp
     ${CMAKE_SOURCE_DIR}/src/AudioProcessor.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmPipeline.cpp
+    ${CMAKE_SOURCE_DIR}/src/SpeechDetector.cpp
     ${CMAKE_SOURCE_DIR}/src/VideoProcessor.cpp
+    ${CMAKE_SOURCE_DIR}/src/RenditionEncoder.cpp
     ${CMAKE_SOURCE_DIR}/src/Engine.cpp
+    ${CMAKE_SOURCE_DIR}/src/RuntimeServices.cpp
     ${CMAKE_SOURCE_DIR}/src/Utils.cpp
     ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp
     ${CMAKE_SOURCE_DIR}/src/HardwareUtils.cpp
     ${CMAKE_SOURCE_DIR}/src/FFmpegSettingsManager.cpp
     ${CMAKE_SOURCE_DIR}/src/DeepFilterCommandBuilder.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+    ${CMAKE_SOURCE_DIR}/src/AsyncRuntime.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/ProcessReactor.cpp
+    ${CMAKE_SOURCE_DIR}/src/TaskGraph.cpp
+    ${CMAKE_SOURCE_DIR}/src/WorkerContext.cpp
+    ${CMAKE_SOURCE_DIR}/src/CostModel.cpp
+    ${CMAKE_SOURCE_DIR}/src/JobScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandExecutor.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+    ${CMAKE_SOURCE_DIR}/src/MetricsServer.cpp
+    ${CMAKE_SOURCE_DIR}/src/SocketListener.cpp
+    ${CMAKE_SOURCE_DIR}/src/HttpServer.cpp
+    ${CMAKE_SOURCE_DIR}/src/MediaFrontend.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterStream.cpp
+    ${CMAKE_SOURCE_DIR}/src/SharedPcmRing.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmStreamServer.cpp
+    ${CMAKE_SOURCE_DIR}/src/FolderWatcher.cpp
+    ${CMAKE_SOURCE_DIR}/src/WatchFolder.cpp
 )
 
 # Link DeepFilter wrt platform
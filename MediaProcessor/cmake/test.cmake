@@ -14,6 +14,9 @@ endif()
 
 # Setup test media directory
 set(TEST_MEDIA_DIR "${CMAKE_SOURCE_DIR}/tests/TestMedia" CACHE PATH "Path to test media files")
+# "off" runs FFmpeg, "record" (needs FFmpeg) writes TEST_MEDIA_DIR/cassette and "replay" runs
+# the tests from it, failing them while it is not recorded
+set(TEST_COMMAND_CASSETTE "off" CACHE STRING "Command cassette mode of the processor tests")
 
 FetchContent_Declare(
     fmt
@@ -28,7 +31,9 @@ set(COMMON_LIBRARIES gtest_main ${CMAKE_SOURCE_DIR}/lib/libdf.so ${SNDFILE_LIBRA
 # Macro for adding a test executable
 macro(add_test_executable name)
     add_executable(${name} ${ARGN})
-    target_compile_definitions(${name} PRIVATE TEST_MEDIA_DIR="${TEST_MEDIA_DIR}")
+    target_compile_definitions(${name} PRIVATE
+        TEST_MEDIA_DIR="${TEST_MEDIA_DIR}" TEST_COMMAND_CASSETTE="${TEST_COMMAND_CASSETTE}"
+    )
     target_link_libraries(${name} PRIVATE ${COMMON_LIBRARIES})
     add_test(NAME ${name} COMMAND ${name})
 endmacro()
@@ -39,33 +44,55 @@ add_test_executable(ConfigManagerTester
     ${CMAKE_SOURCE_DIR}/src/ConfigManager.cpp 
     ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp 
     ${CMAKE_SOURCE_DIR}/src/HardwareUtils.cpp 
-    ${CMAKE_SOURCE_DIR}/src/Utils.cpp 
+    ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp 
     ${CMAKE_SOURCE_DIR}/tests/TestUtils.cpp
 )
 
 add_test_executable(UtilsTester 
     ${CMAKE_SOURCE_DIR}/tests/UtilsTester.cpp 
     ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
     ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp 
 )
 
 add_test_executable(AudioProcessorTester
     ${CMAKE_SOURCE_DIR}/tests/AudioProcessorTester.cpp 
     ${CMAKE_SOURCE_DIR}/src/AudioProcessor.cpp 
+    ${CMAKE_SOURCE_DIR}/src/PcmPipeline.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterStream.cpp
+    ${CMAKE_SOURCE_DIR}/src/SpeechDetector.cpp
+    ${CMAKE_SOURCE_DIR}/src/CostModel.cpp
+    ${CMAKE_SOURCE_DIR}/src/AsyncRuntime.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandExecutor.cpp
+    ${CMAKE_SOURCE_DIR}/src/WorkerContext.cpp
+    ${CMAKE_SOURCE_DIR}/src/ProcessReactor.cpp
+    ${CMAKE_SOURCE_DIR}/src/TaskGraph.cpp
     ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp 
-    ${CMAKE_SOURCE_DIR}/src/Utils.cpp 
+    ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp 
     ${CMAKE_SOURCE_DIR}/src/HardwareUtils.cpp 
     ${CMAKE_SOURCE_DIR}/src/ConfigManager.cpp 
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
     ${CMAKE_SOURCE_DIR}/tests/TestUtils.cpp
 )
 
 add_test_executable(VideoProcessorTester
     ${CMAKE_SOURCE_DIR}/tests/VideoProcessorTester.cpp 
     ${CMAKE_SOURCE_DIR}/src/VideoProcessor.cpp 
+    ${CMAKE_SOURCE_DIR}/src/CostModel.cpp
+    ${CMAKE_SOURCE_DIR}/src/AsyncRuntime.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandExecutor.cpp
+    ${CMAKE_SOURCE_DIR}/src/WorkerContext.cpp
+    ${CMAKE_SOURCE_DIR}/src/ProcessReactor.cpp
     ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp 
-    ${CMAKE_SOURCE_DIR}/src/Utils.cpp 
+    ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp 
     ${CMAKE_SOURCE_DIR}/src/ConfigManager.cpp 
     ${CMAKE_SOURCE_DIR}/src/HardwareUtils.cpp 
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
     ${CMAKE_SOURCE_DIR}/tests/TestUtils.cpp
 )
 
@@ -73,5 +100,218 @@ add_test_executable(CommandBuilderTester
     ${CMAKE_SOURCE_DIR}/tests/CommandBuilderTester.cpp 
     ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp 
     ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+)
+
+add_test_executable(CancellationTokenTester
+    ${CMAKE_SOURCE_DIR}/tests/CancellationTokenTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+)
+
+add_test_executable(AsyncRuntimeTester
+    ${CMAKE_SOURCE_DIR}/tests/AsyncRuntimeTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/AsyncRuntime.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandExecutor.cpp
+    ${CMAKE_SOURCE_DIR}/src/WorkerContext.cpp
+    ${CMAKE_SOURCE_DIR}/src/ProcessReactor.cpp
+    ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+)
+
+add_test_executable(TaskGraphTester
+    ${CMAKE_SOURCE_DIR}/tests/TaskGraphTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/TaskGraph.cpp
+)
+
+add_test_executable(ThreadPoolTester
+    ${CMAKE_SOURCE_DIR}/tests/ThreadPoolTester.cpp
+)
+
+add_test_executable(CommandExecutorTester
+    ${CMAKE_SOURCE_DIR}/tests/CommandExecutorTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandExecutor.cpp
+    ${CMAKE_SOURCE_DIR}/src/AsyncRuntime.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/WorkerContext.cpp
+    ${CMAKE_SOURCE_DIR}/src/ProcessReactor.cpp
+    ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+)
+
+add_test_executable(CostModelTester
+    ${CMAKE_SOURCE_DIR}/tests/CostModelTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/CostModel.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+)
+
+add_test_executable(RenditionEncoderTester
+    ${CMAKE_SOURCE_DIR}/tests/RenditionEncoderTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/RenditionEncoder.cpp
+    ${CMAKE_SOURCE_DIR}/src/CostModel.cpp
+    ${CMAKE_SOURCE_DIR}/src/AsyncRuntime.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandExecutor.cpp
+    ${CMAKE_SOURCE_DIR}/src/WorkerContext.cpp
+    ${CMAKE_SOURCE_DIR}/src/ProcessReactor.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp
+    ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+    ${CMAKE_SOURCE_DIR}/src/ConfigManager.cpp
+    ${CMAKE_SOURCE_DIR}/src/HardwareUtils.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+    ${CMAKE_SOURCE_DIR}/tests/TestUtils.cpp
+)
+
+add_test_executable(SpeechDetectorTester
+    ${CMAKE_SOURCE_DIR}/tests/SpeechDetectorTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/SpeechDetector.cpp
+)
+
+add_test_executable(FairSchedulerTester
+    ${CMAKE_SOURCE_DIR}/tests/FairSchedulerTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+)
+
+add_test_executable(MetricsTester
+    ${CMAKE_SOURCE_DIR}/tests/MetricsTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+    ${CMAKE_SOURCE_DIR}/src/MetricsServer.cpp
+    ${CMAKE_SOURCE_DIR}/src/SocketListener.cpp
+)
+
+add_test_executable(HttpServerTester
+    ${CMAKE_SOURCE_DIR}/tests/HttpServerTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/HttpServer.cpp
+    ${CMAKE_SOURCE_DIR}/src/SocketListener.cpp
+    ${CMAKE_SOURCE_DIR}/tests/TestUtils.cpp
+)
+
+add_test_executable(DeepFilterStreamTester
+    ${CMAKE_SOURCE_DIR}/tests/DeepFilterStreamTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterStream.cpp
+)
+
+add_test_executable(PcmStreamTester
+    ${CMAKE_SOURCE_DIR}/tests/PcmStreamTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/SharedPcmRing.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmStreamServer.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmStreamClient.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterStream.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+)
+
+add_test_executable(PcmPipelineTester
+    ${CMAKE_SOURCE_DIR}/tests/PcmPipelineTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmPipeline.cpp
+)
+
+add_test_executable(FolderWatcherTester
+    ${CMAKE_SOURCE_DIR}/tests/FolderWatcherTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/FolderWatcher.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+)
+
+add_test_executable(WatchFolderTester
+    ${CMAKE_SOURCE_DIR}/tests/WatchFolderTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/WatchFolder.cpp
+    ${CMAKE_SOURCE_DIR}/src/FolderWatcher.cpp
+    ${CMAKE_SOURCE_DIR}/src/JobScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/Engine.cpp
+    ${CMAKE_SOURCE_DIR}/src/RuntimeServices.cpp
+    ${CMAKE_SOURCE_DIR}/src/AudioProcessor.cpp
+    ${CMAKE_SOURCE_DIR}/src/VideoProcessor.cpp
+    ${CMAKE_SOURCE_DIR}/src/RenditionEncoder.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmPipeline.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterStream.cpp
+    ${CMAKE_SOURCE_DIR}/src/SpeechDetector.cpp
+    ${CMAKE_SOURCE_DIR}/src/FFmpegSettingsManager.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterCommandBuilder.cpp
+    ${CMAKE_SOURCE_DIR}/src/CostModel.cpp
+    ${CMAKE_SOURCE_DIR}/src/AsyncRuntime.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandExecutor.cpp
+    ${CMAKE_SOURCE_DIR}/src/WorkerContext.cpp
+    ${CMAKE_SOURCE_DIR}/src/ProcessReactor.cpp
+    ${CMAKE_SOURCE_DIR}/src/TaskGraph.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp
+    ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+    ${CMAKE_SOURCE_DIR}/src/HardwareUtils.cpp
+    ${CMAKE_SOURCE_DIR}/src/ConfigManager.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+    ${CMAKE_SOURCE_DIR}/src/MetricsServer.cpp
+    ${CMAKE_SOURCE_DIR}/src/SocketListener.cpp
+    ${CMAKE_SOURCE_DIR}/tests/TestUtils.cpp
 )
 
+add_test_executable(MediaFrontendTester
+    ${CMAKE_SOURCE_DIR}/tests/MediaFrontendTester.cpp
+    ${CMAKE_SOURCE_DIR}/src/MediaFrontend.cpp
+    ${CMAKE_SOURCE_DIR}/src/HttpServer.cpp
+    ${CMAKE_SOURCE_DIR}/src/SocketListener.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmStreamServer.cpp
+    ${CMAKE_SOURCE_DIR}/src/SharedPcmRing.cpp
+    ${CMAKE_SOURCE_DIR}/src/JobScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/Engine.cpp
+    ${CMAKE_SOURCE_DIR}/src/RuntimeServices.cpp
+    ${CMAKE_SOURCE_DIR}/src/AudioProcessor.cpp
+    ${CMAKE_SOURCE_DIR}/src/VideoProcessor.cpp
+    ${CMAKE_SOURCE_DIR}/src/RenditionEncoder.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmPipeline.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterStream.cpp
+    ${CMAKE_SOURCE_DIR}/src/SpeechDetector.cpp
+    ${CMAKE_SOURCE_DIR}/src/FFmpegSettingsManager.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterCommandBuilder.cpp
+    ${CMAKE_SOURCE_DIR}/src/CostModel.cpp
+    ${CMAKE_SOURCE_DIR}/src/AsyncRuntime.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandExecutor.cpp
+    ${CMAKE_SOURCE_DIR}/src/WorkerContext.cpp
+    ${CMAKE_SOURCE_DIR}/src/ProcessReactor.cpp
+    ${CMAKE_SOURCE_DIR}/src/TaskGraph.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp
+    ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+    ${CMAKE_SOURCE_DIR}/src/HardwareUtils.cpp
+    ${CMAKE_SOURCE_DIR}/src/ConfigManager.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+    ${CMAKE_SOURCE_DIR}/src/MetricsServer.cpp
+    ${CMAKE_SOURCE_DIR}/tests/TestUtils.cpp
+)
+
+add_test_executable(QualityMetricsTester
+    ${CMAKE_SOURCE_DIR}/tests/QualityMetricsTester.cpp
+    ${CMAKE_SOURCE_DIR}/tests/QualityMetrics.cpp
+)
+
+# Quality gate for performance work: `ctest -L quality` runs the reference clips through the
+# pipeline and enforces the thresholds in tests/TestMedia/quality_thresholds.json
+add_test_executable(AudioQualityTester
+    ${CMAKE_SOURCE_DIR}/tests/AudioQualityTester.cpp
+    ${CMAKE_SOURCE_DIR}/tests/QualityMetrics.cpp
+    ${CMAKE_SOURCE_DIR}/src/AudioProcessor.cpp
+    ${CMAKE_SOURCE_DIR}/src/PcmPipeline.cpp
+    ${CMAKE_SOURCE_DIR}/src/DeepFilterStream.cpp
+    ${CMAKE_SOURCE_DIR}/src/SpeechDetector.cpp
+    ${CMAKE_SOURCE_DIR}/src/CostModel.cpp
+    ${CMAKE_SOURCE_DIR}/src/AsyncRuntime.cpp
+    ${CMAKE_SOURCE_DIR}/src/FairScheduler.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandExecutor.cpp
+    ${CMAKE_SOURCE_DIR}/src/WorkerContext.cpp
+    ${CMAKE_SOURCE_DIR}/src/ProcessReactor.cpp
+    ${CMAKE_SOURCE_DIR}/src/TaskGraph.cpp
+    ${CMAKE_SOURCE_DIR}/src/CommandBuilder.cpp
+    ${CMAKE_SOURCE_DIR}/src/Utils.cpp
+    ${CMAKE_SOURCE_DIR}/src/CancellationToken.cpp
+    ${CMAKE_SOURCE_DIR}/src/HardwareUtils.cpp
+    ${CMAKE_SOURCE_DIR}/src/ConfigManager.cpp
+    ${CMAKE_SOURCE_DIR}/src/Metrics.cpp
+    ${CMAKE_SOURCE_DIR}/tests/TestUtils.cpp
+)
+set_tests_properties(QualityMetricsTester AudioQualityTester PROPERTIES LABELS "quality")
@@ -3,54 +3,428 @@
 #ifndef THREAD_POOL_H
 #define THREAD_POOL_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
+#include <latch>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
+#include <optional>
 #include <stdexcept>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// Move-only `void()` callable with inline storage. Callables that fit into the buffer (which
+// covers lambdas capturing a few pointers, a coroutine handle or a packaged_task) are stored
+// without touching the heap; larger ones fall back to a single allocation.
+class MoveOnlyTask {
+   public:
+    static constexpr size_t INLINE_CAPACITY = 6 * sizeof(void*);
+
+    MoveOnlyTask() noexcept = default;
+
+    template <class F, class Fn = std::decay_t<F>,
+              class = std::enable_if_t<!std::is_same_v<Fn, MoveOnlyTask> &&
+                                       std::is_invocable_v<Fn&>>>
+    MoveOnlyTask(F&& f) {
+        if constexpr (storedInline<Fn>()) {
+            ::new (static_cast<void*>(storage)) Fn(std::forward<F>(f));
+        } else {
+            ::new (static_cast<void*>(storage)) Fn*(new Fn(std::forward<F>(f)));
+        }
+        ops = &operationsFor<Fn>;
+    }
+
+    MoveOnlyTask(MoveOnlyTask&& other) noexcept : ops(other.ops) {
+        if (ops) {
+            ops->relocate(storage, other.storage);
+            other.ops = nullptr;
+        }
+    }
+
+    MoveOnlyTask& operator=(MoveOnlyTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops) {
+                other.ops->relocate(storage, other.storage);
+                ops = std::exchange(other.ops, nullptr);
+            }
+        }
+        return *this;
+    }
+
+    MoveOnlyTask(const MoveOnlyTask&) = delete;
+    MoveOnlyTask& operator=(const MoveOnlyTask&) = delete;
+
+    ~MoveOnlyTask() { reset(); }
+
+    void operator()() { ops->invoke(storage); }
+
+    explicit operator bool() const noexcept { return ops != nullptr; }
+
+    template <class Fn>
+    static constexpr bool storedInline() {
+        return sizeof(Fn) <= INLINE_CAPACITY && alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+   private:
+    struct Operations {
+        void (*invoke)(void*);
+        void (*relocate)(void* dst, void* src) noexcept;  // move-construct, then destroy src
+        void (*destroy)(void*) noexcept;
+    };
+
+    template <class Fn>
+    static constexpr Operations operationsFor = [] {
+        if constexpr (storedInline<Fn>()) {
+            return Operations{
+                [](void* self) { (*std::launder(static_cast<Fn*>(self)))(); },
+                [](void* dst, void* src) noexcept {
+                    Fn* source = std::launder(static_cast<Fn*>(src));
+                    ::new (dst) Fn(std::move(*source));
+                    source->~Fn();
+                },
+                [](void* self) noexcept { std::launder(static_cast<Fn*>(self))->~Fn(); }};
+        } else {
+            return Operations{
+                [](void* self) { (**std::launder(static_cast<Fn**>(self)))(); },
+                [](void* dst, void* src) noexcept {
+                    ::new (dst) Fn*(*std::launder(static_cast<Fn**>(src)));
+                },
+                [](void* self) noexcept { delete *std::launder(static_cast<Fn**>(self)); }};
+        }
+    }();
+
+    void reset() noexcept {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage[INLINE_CAPACITY];
+    const Operations* ops = nullptr;
+};
+
+// Called on each worker thread with its index: onStart before it takes its first task, onStop
+// after the queue has drained or when the worker retires. Used to set up and tear down
+// worker-local resources. onIdle is called on a worker that is kept although it has been idle
+// for the pool's idle timeout, once per idle period.
+struct WorkerHooks {
+    std::function<void(size_t)> onStart;
+    std::function<void(size_t)> onStop;
+    std::function<void(size_t)> onIdle;
+};
+
+// Elastic sizing: the pool starts minThreads workers and adds one whenever a task is queued
+// while no worker is idle, up to maxThreads. Workers above minThreads retire after idleTimeout
+// without work. A zero idleTimeout never retires workers.
+struct ElasticLimits {
+    size_t minThreads;
+    size_t maxThreads;
+    std::chrono::milliseconds idleTimeout{0};
+};
+
+// Spin-then-yield-then-park: an idle worker first polls the queue for spinTime, busy-waiting,
+// then for yieldTime, giving up its core between polls, and only then blocks on the condition
+// variable. A task posted meanwhile starts without a futex wakeup: a polling worker claims it,
+// and posting only notifies a parked worker for tasks no poller is left to claim. Both zero
+// (the default) parks right away.
+struct IdleStrategy {
+    std::chrono::microseconds spinTime{0};
+    std::chrono::microseconds yieldTime{0};
+};
+
+struct PoolSizeSample {
+    std::chrono::steady_clock::time_point time;
+    size_t threads;
+};
+
+struct PoolStats {
+    size_t threads;  // running workers
+    size_t idle;     // workers waiting for a task
+    size_t queued;   // tasks not yet taken
+    size_t peak;     // most workers ever running at once
+    size_t started;  // workers started, including the initial ones
+    size_t retired;  // workers retired after idling
+};
+
 class ThreadPool {
    public:
+    // the most recent pool size changes kept for sizeHistory()
+    static constexpr size_t SIZE_HISTORY_CAPACITY = 256;
+
     ThreadPool(size_t);
+    ThreadPool(size_t, WorkerHooks hooks);
+    ThreadPool(ElasticLimits limits, WorkerHooks hooks = {}, IdleStrategy idleStrategy = {});
     template <class F, class... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type>;
+
+    // fire-and-forget: no future, no shared state; `f` must not throw
+    template <class F>
+    void post(F&& f);
+
+    // as post(), counting `done` down once `f` has run
+    template <class F>
+    void post(F&& f, std::latch& done);
+
+    // runs f(0) ... f(count - 1) queued under a single lock, counting `done` down per call;
+    // `f` is shared by reference and must stay alive until `done` is released
+    template <class F>
+    void postBulk(size_t count, const F& f, std::latch& done);
+
+    // running workers; between limits.minThreads and maxSize()
+    size_t size() const {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        return threads;
+    }
+
+    size_t maxSize() const { return workers.size(); }
+
+    PoolStats stats() const {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        return {threads, idle, tasks.size(), peak, started, retired};
+    }
+
+    // the pool size after each of its recent changes, oldest first
+    std::vector<PoolSizeSample> sizeHistory() const {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        return {history.begin(), history.end()};
+    }
+
+    // index of the calling thread within this pool, if it is one of its workers
+    std::optional<size_t> currentWorkerIndex() const {
+        const auto& [pool, index] = currentWorker();
+        if (pool != this) return std::nullopt;
+        return index;
+    }
+
     ~ThreadPool();
 
    private:
-    // need to keep track of threads so we can join them
+    static std::pair<const ThreadPool*, size_t>& currentWorker() {
+        static thread_local std::pair<const ThreadPool*, size_t> worker{nullptr, 0};
+        return worker;
+    }
+
+    template <class F>
+    static auto noexceptTask(F&& f) {
+        return [f = std::forward<F>(f)]() mutable noexcept { f(); };
+    }
+
+    // all called with queue_mutex held
+    void startWorker();
+    void growIfNeeded();
+    void recordSize();
+    // returns whether a parked worker has to be notified of a newly queued task
+    bool publishQueued();
+
+    // polls the queue without the lock as configured by the idle strategy; true if a task
+    // showed up and was claimed, in which case the caller releases the claim under the lock
+    bool pollForTask();
+    // claims one of the queued tasks no other poller has claimed yet, for the calling poller
+    bool claimTask();
+    // queued tasks that neither a polling worker nor a claim accounts for
+    size_t unclaimedTasks() const;
+
+    void workerLoop(size_t index);
+
+    // one slot per possible worker, so a worker keeps its index for its whole life; slots of
+    // retired workers are reused
     std::vector<std::thread> workers;
+    std::vector<size_t> freeSlots;
     // the task queue
-    std::queue<std::function<void()> > tasks;
+    std::deque<MoveOnlyTask> tasks;
 
     // synchronization
-    std::mutex queue_mutex;
+    mutable std::mutex queue_mutex;
     std::condition_variable condition;
     bool stop;
+    // tasks.size() as of the last change, readable without the lock
+    std::atomic<size_t> queued{0};
+    // workers polling for a task
+    std::atomic<size_t> polling{0};
+    // queued tasks a poller has claimed and is about to take under the lock
+    std::atomic<size_t> claimed{0};
+
+    ElasticLimits limits;
+    WorkerHooks hooks;
+    IdleStrategy idleStrategy;
+
+    size_t threads = 0;
+    size_t idle = 0;
+    size_t peak = 0;
+    size_t started = 0;
+    size_t retired = 0;
+    std::deque<PoolSizeSample> history;
 };
 
-// the constructor just launches some amount of workers
-inline ThreadPool::ThreadPool(size_t threads) : stop(false) {
-    for (size_t i = 0; i < threads; ++i)
-        workers.emplace_back([this] {
-            for (;;) {
-                std::function<void()> task;
-
-                {
-                    std::unique_lock<std::mutex> lock(this->queue_mutex);
-                    this->condition.wait(lock,
-                                         [this] { return this->stop || !this->tasks.empty(); });
-                    if (this->stop && this->tasks.empty()) return;
-                    task = std::move(this->tasks.front());
-                    this->tasks.pop();
-                }
-
-                task();
+inline ThreadPool::ThreadPool(size_t threads) : ThreadPool(threads, WorkerHooks{}) {}
+
+inline ThreadPool::ThreadPool(size_t threads, WorkerHooks workerHooks)
+    : ThreadPool(ElasticLimits{threads, threads}, std::move(workerHooks)) {}
+
+// the constructor just launches the minimum amount of workers
+inline ThreadPool::ThreadPool(ElasticLimits elasticLimits, WorkerHooks workerHooks,
+                              IdleStrategy workerIdleStrategy)
+    : workers(std::max(elasticLimits.minThreads, elasticLimits.maxThreads)),
+      stop(false),
+      limits(elasticLimits),
+      hooks(std::move(workerHooks)),
+      idleStrategy(workerIdleStrategy) {
+    limits.maxThreads = workers.size();
+    for (size_t i = workers.size(); i > 0; --i) freeSlots.push_back(i - 1);
+
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    for (size_t i = 0; i < limits.minThreads; ++i) startWorker();
+}
+
+inline void ThreadPool::startWorker() {
+    size_t index = freeSlots.back();
+    freeSlots.pop_back();
+
+    ++threads;
+    ++started;
+    peak = std::max(peak, threads);
+    recordSize();
+    // a retired worker may still be running its stop hook; the new one joins it first, so the
+    // hooks of a slot never overlap and the queue is not locked meanwhile
+    workers[index] = std::thread([this, index, retired = std::move(workers[index])]() mutable {
+        if (retired.joinable()) retired.join();
+        workerLoop(index);
+    });
+}
+
+inline size_t ThreadPool::unclaimedTasks() const {
+    // a poller leaves `polling` before it claims, so read in this order it is never counted
+    // twice, at worst not at all, which only costs a spare wakeup
+    size_t pending = tasks.size() - std::min(tasks.size(), claimed.load());
+    return pending - std::min(pending, polling.load());
+}
+
+inline void ThreadPool::growIfNeeded() {
+    // polling workers are about to take a task as well
+    while (unclaimedTasks() > idle && threads < limits.maxThreads && !freeSlots.empty())
+        startWorker();
+}
+
+inline void ThreadPool::recordSize() {
+    if (history.size() == SIZE_HISTORY_CAPACITY) history.pop_front();
+    history.push_back({std::chrono::steady_clock::now(), threads});
+}
+
+inline bool ThreadPool::publishQueued() {
+    queued.store(tasks.size());
+    growIfNeeded();
+    // a polling worker sees the task through `queued`; once it stops polling it takes the lock
+    // before parking, so it either finds the task or counts as idle here
+    return idle > 0 && unclaimedTasks() > 0;
+}
+
+inline bool ThreadPool::claimTask() {
+    --polling;
+    size_t claims = claimed.load();
+    while (claims < queued.load()) {
+        if (claimed.compare_exchange_weak(claims, claims + 1)) return true;
+    }
+    ++polling;
+    return false;
+}
+
+inline bool ThreadPool::pollForTask() {
+    if (idleStrategy.spinTime.count() == 0 && idleStrategy.yieldTime.count() == 0) return false;
+
+    ++polling;
+    auto start = std::chrono::steady_clock::now();
+    auto spinDeadline = start + idleStrategy.spinTime;
+    auto yieldDeadline = spinDeadline + idleStrategy.yieldTime;
+    bool spinning = idleStrategy.spinTime.count() > 0;
+    for (size_t i = 1;; ++i) {
+        if (queued.load() > claimed.load() && claimTask()) return true;
+        // reading the clock costs more than a poll, so it is only checked every few polls
+        if (i % 64 == 0) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= yieldDeadline) break;
+            spinning = now < spinDeadline;
+        }
+        if (spinning) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    --polling;
+    return false;
+}
+
+inline void ThreadPool::workerLoop(size_t index) {
+    currentWorker() = {this, index};
+    if (this->hooks.onStart) this->hooks.onStart(index);
+
+    bool idleReported = false;
+    for (;;) {
+        MoveOnlyTask task;
+
+        // an idle period that was already reported only ends with new work, so it parks
+        bool claimedTask = !idleReported && pollForTask();
+
+        {
+            std::unique_lock<std::mutex> lock(this->queue_mutex);
+            // another worker may have taken the claimed task meanwhile, then this one parks
+            if (claimedTask) --this->claimed;
+            auto ready = [this] { return this->stop || !this->tasks.empty(); };
+
+            ++this->idle;
+            bool woken = true;
+            if (this->limits.idleTimeout.count() == 0 || idleReported) {
+                this->condition.wait(lock, ready);
+            } else {
+                woken = this->condition.wait_for(lock, this->limits.idleTimeout, ready);
             }
-        });
+            --this->idle;
+
+            if (!woken && this->threads > this->limits.minThreads) {
+                // the slot is free at once, so a task queued while the stop hook runs can still
+                // start a worker in it
+                --this->threads;
+                ++this->retired;
+                this->freeSlots.push_back(index);
+                recordSize();
+                break;
+            }
+            if (woken) {
+                if (this->stop && this->tasks.empty()) break;
+                task = std::move(this->tasks.front());
+                this->tasks.pop_front();
+                this->queued.store(this->tasks.size());
+            }
+        }
+
+        if (task) {
+            idleReported = false;
+            task();
+        } else {
+            idleReported = true;
+            if (this->hooks.onIdle) this->hooks.onIdle(index);
+        }
+    }
+
+    if (this->hooks.onStop) this->hooks.onStop(index);
+    currentWorker() = {nullptr, 0};
 }
 
 // add new work item to the pool
@@ -59,22 +433,64 @@ auto ThreadPool::enqueue(F&& f,
                          Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type> {
     using return_type = typename std::invoke_result<F, Args...>::type;
 
-    auto task = std::make_shared<std::packaged_task<return_type()> >(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    // the packaged_task is move-only, so it lives in the queue entry itself
+    std::packaged_task<return_type()> task(
+        [f = std::forward<F>(f), ... args = std::forward<Args>(args)]() mutable -> return_type {
+            return std::invoke(f, args...);
+        });
 
-    std::future<return_type> res = task->get_future();
+    std::future<return_type> res = task.get_future();
+    bool wake;
     {
         std::unique_lock<std::mutex> lock(queue_mutex);
 
         // don't allow enqueueing after stopping the pool
         if (stop) throw std::runtime_error("enqueue on stopped ThreadPool");
 
-        tasks.emplace([task]() { (*task)(); });
+        tasks.emplace_back(std::move(task));
+        wake = publishQueued();
     }
-    condition.notify_one();
+    if (wake) condition.notify_one();
     return res;
 }
 
+template <class F>
+void ThreadPool::post(F&& f) {
+    bool wake;
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        if (stop) throw std::runtime_error("post on stopped ThreadPool");
+        tasks.emplace_back(noexceptTask(std::forward<F>(f)));
+        wake = publishQueued();
+    }
+    if (wake) condition.notify_one();
+}
+
+template <class F>
+void ThreadPool::post(F&& f, std::latch& done) {
+    post([f = std::forward<F>(f), &done]() mutable {
+        f();
+        done.count_down();
+    });
+}
+
+template <class F>
+void ThreadPool::postBulk(size_t count, const F& f, std::latch& done) {
+    if (count == 0) return;
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        if (stop) throw std::runtime_error("post on stopped ThreadPool");
+        for (size_t i = 0; i < count; ++i) {
+            tasks.emplace_back(noexceptTask([&f, i, &done]() {
+                f(i);
+                done.count_down();
+            }));
+        }
+        publishQueued();
+    }
+    condition.notify_all();
+}
+
 // the destructor joins all threads
 inline ThreadPool::~ThreadPool() {
     {
@@ -82,7 +498,8 @@ inline ThreadPool::~ThreadPool() {
         stop = true;
     }
     condition.notify_all();
-    for (std::thread& worker : workers) worker.join();
+    for (std::thread& worker : workers)
+        if (worker.joinable()) worker.join();
 }
 
 #endif
@@ -90,6 +507,8 @@ inline ThreadPool::~ThreadPool() {
 /*
     Copyright (c) 2012 Jakob Progsch, Václav Zeman
     Updated for C++17 and later compatibility by Omer Yusuf Yagci, 2024.
+    Altered to queue move-only tasks with inline storage, to add post/postBulk and worker
+    hooks, to size the pool elastically and to poll before parking idle workers, 2026.
 
     This software is provided 'as-is', without any express or implied
     warranty. In no event will the authors be held liable for any damages
@@ -0,0 +1,104 @@
+/*
+ * LV2 plugin isolating vocals with DeepFilterNet inside a host's audio graph.
+ *
+ * Mono, 48 kHz only. The model is loaded from the plugin's bundle on instantiation; the
+ * attenuation limit is a control port and the delay, the hop of buffering the model needs plus
+ * its STFT overlap and lookahead, is reported to the host through the latency port, so it can
+ * compensate. See deepfilter.lv2/deepfilter.ttl.
+ */
+
+#include <lv2/core/lv2.h>
+
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+
+#include "../src/DeepFilterStream.h"
+
+namespace {
+
+using MediaProcessor::DeepFilterStream;
+
+constexpr const char* PLUGIN_URI =
+    "https://github.com/omeryusufyagci/fast-music-remover#deepfilter";
+constexpr const char* BUNDLED_MODEL = "DeepFilterNet3_ll_onnx.tar.gz";
+
+enum Port : uint32_t { Input = 0, Output = 1, AttenuationLimit = 2, Latency = 3 };
+
+struct Plugin {
+    DeepFilterStream stream;
+    const float* input = nullptr;
+    float* output = nullptr;
+    const float* attenuationLimit = nullptr;
+    float* latency = nullptr;
+
+    Plugin(const std::filesystem::path& modelPath, float attenuationLimit)
+        : stream(modelPath, attenuationLimit) {}
+};
+
+LV2_Handle instantiate(const LV2_Descriptor*, double sampleRate, const char* bundlePath,
+                       const LV2_Feature* const*) {
+    if (sampleRate != MediaProcessor::DEEPFILTER_SAMPLE_RATE) {
+        std::cerr << "Error: DeepFilterNet only runs at 48 kHz, not " << sampleRate << " Hz."
+                  << std::endl;
+        return nullptr;
+    }
+
+    try {
+        return new Plugin(std::filesystem::path(bundlePath) / BUNDLED_MODEL, 100.0f);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void connectPort(LV2_Handle instance, uint32_t port, void* data) {
+    auto* plugin = static_cast<Plugin*>(instance);
+    switch (port) {
+        case Port::Input:
+            plugin->input = static_cast<const float*>(data);
+            break;
+        case Port::Output:
+            plugin->output = static_cast<float*>(data);
+            break;
+        case Port::AttenuationLimit:
+            plugin->attenuationLimit = static_cast<const float*>(data);
+            break;
+        case Port::Latency:
+            plugin->latency = static_cast<float*>(data);
+            break;
+    }
+}
+
+void activate(LV2_Handle instance) {
+    static_cast<Plugin*>(instance)->stream.reset();
+}
+
+void run(LV2_Handle instance, uint32_t numSamples) {
+    auto* plugin = static_cast<Plugin*>(instance);
+    if (plugin->attenuationLimit) {
+        plugin->stream.setAttenuationLimit(*plugin->attenuationLimit);
+    }
+    if (plugin->latency) {
+        *plugin->latency = static_cast<float>(plugin->stream.getLatency());
+    }
+    plugin->stream.process(plugin->input, plugin->output, numSamples);
+}
+
+void cleanup(LV2_Handle instance) {
+    delete static_cast<Plugin*>(instance);
+}
+
+const void* extensionData(const char*) {
+    return nullptr;
+}
+
+const LV2_Descriptor descriptor = {PLUGIN_URI, instantiate, connectPort, activate,
+                                   run,        nullptr,     cleanup,     extensionData};
+
+}  // namespace
+
+LV2_SYMBOL_EXPORT const LV2_Descriptor* lv2_descriptor(uint32_t index) {
+    return index == 0 ? &descriptor : nullptr;
+}
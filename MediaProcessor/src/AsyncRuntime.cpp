@@ -0,0 +1,133 @@
+#include "AsyncRuntime.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "CommandExecutor.h"
+#include "Utils.h"
+
+namespace MediaProcessor {
+
+AsyncRuntime::AsyncRuntime(size_t numWorkers, size_t numIOThreads)
+    : AsyncRuntime(ElasticLimits{numWorkers, numWorkers}, numIOThreads) {}
+
+AsyncRuntime::AsyncRuntime(ElasticLimits workerLimits, size_t numIOThreads,
+                           WorkerScheduling workerScheduling)
+    : m_realtimePriority(workerScheduling.realtimePriority),
+      m_workerContexts(std::max(workerLimits.minThreads, workerLimits.maxThreads)),
+      m_workers(workerLimits,
+                WorkerHooks{[this](size_t index) { onWorkerStart(index); },
+                            [this](size_t index) { onWorkerStop(index); },
+                            [this](size_t index) { onWorkerIdle(index); }},
+                workerScheduling.idleStrategy),
+      m_ioPool(numIOThreads),
+      m_fairScheduler(m_workers, m_workers.maxSize()),
+      m_reactor(m_workers),
+      m_commandExecutor(std::make_shared<SystemCommandExecutor>(m_reactor)) {}
+
+ThreadPool& AsyncRuntime::getWorkers() {
+    return m_workers;
+}
+
+WorkerMetrics AsyncRuntime::getWorkerMetrics() const {
+    return {m_workers.stats(), m_workers.sizeHistory(), m_freedFilterStates.load(),
+            m_fairScheduler.getUsage()};
+}
+
+void AsyncRuntime::onWorkerStart(size_t index) {
+    m_workerContexts[index] = std::make_unique<WorkerContext>(index);
+    if (m_realtimePriority <= 0) {
+        return;
+    }
+
+    // Usually needs CAP_SYS_NICE or an RLIMIT_RTPRIO; without it the worker keeps running
+    sched_param param{};
+    param.sched_priority = m_realtimePriority;
+    int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (error != 0 && !m_priorityWarned.exchange(true)) {
+        std::cerr << "Warning: Could not give inference workers realtime priority "
+                  << m_realtimePriority << ": " << std::strerror(error) << std::endl;
+    }
+}
+
+void AsyncRuntime::onWorkerIdle(size_t index) {
+    // The model is reloaded on the worker's next chunk
+    if (m_workerContexts[index]->hasFilterState()) {
+        m_workerContexts[index]->releaseFilterState();
+        ++m_freedFilterStates;
+    }
+}
+
+void AsyncRuntime::onWorkerStop(size_t index) {
+    if (m_workerContexts[index]->hasFilterState()) {
+        ++m_freedFilterStates;
+    }
+    m_workerContexts[index].reset();
+}
+
+FairScheduler& AsyncRuntime::getFairScheduler() {
+    return m_fairScheduler;
+}
+
+WorkerContext& AsyncRuntime::getWorkerContext() {
+    std::optional<size_t> workerIndex = m_workers.currentWorkerIndex();
+    if (!workerIndex) {
+        throw std::logic_error("Worker context requested outside of a runtime worker.");
+    }
+    return *m_workerContexts[*workerIndex];
+}
+
+std::shared_ptr<ICommandExecutor> AsyncRuntime::getCommandExecutor() const {
+    return m_commandExecutor;
+}
+
+void AsyncRuntime::setCommandExecutor(std::shared_ptr<ICommandExecutor> executor) {
+    m_commandExecutor = std::move(executor);
+}
+
+Task<bool> AsyncRuntime::runCommand(std::string command, CancellationToken token) {
+    CommandOutcome outcome = co_await m_commandExecutor->execute(command, true, token);
+    co_return reportOutcome(command, outcome, token);
+}
+
+Task<std::optional<std::string>> AsyncRuntime::runCommandCapture(std::string command,
+                                                                  CancellationToken token) {
+    CommandOutcome outcome = co_await m_commandExecutor->execute(command, false, token);
+    if (!reportOutcome(command, outcome, token) || outcome.output.empty()) {
+        co_return std::nullopt;
+    }
+    co_return std::move(outcome.output);
+}
+
+Task<double> AsyncRuntime::getMediaDuration(fs::path mediaPath, CancellationToken token) {
+    std::optional<std::string> probeOutput =
+        co_await runCommandCapture(Utils::buildMediaDurationCommand(mediaPath), token);
+    co_return Utils::parseMediaDuration(probeOutput);
+}
+
+bool AsyncRuntime::reportOutcome(const std::string& command, const CommandOutcome& outcome,
+                                 const CancellationToken& token) {
+    if (!outcome.launched && !outcome.cancelled) {
+        std::cerr << "Error: Failed to run command: " << command << std::endl;
+        return false;
+    }
+
+    if (outcome.cancelled) {
+        std::cerr << "Command cancelled (" << token.getReason() << "): " << command << std::endl;
+        return false;
+    }
+
+    if (outcome.returnCode != 0) {
+        std::cerr << "Command failed with return code " << outcome.returnCode << ":" << std::endl;
+        std::cerr << outcome.output << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,154 @@
+#ifndef ASYNCRUNTIME_H
+#define ASYNCRUNTIME_H
+
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "AsyncTask.h"
+#include "CancellationToken.h"
+#include "FairScheduler.h"
+#include "ICommandExecutor.h"
+#include "ProcessReactor.h"
+#include "ThreadPool.h"
+#include "WorkerContext.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr size_t DEFAULT_NUM_IO_THREADS = 2;
+
+/**
+ * @brief Snapshot of the worker pool, for metrics.
+ */
+struct WorkerMetrics {
+    PoolStats pool;
+    std::vector<PoolSizeSample> sizeHistory;
+    size_t freedFilterStates;  // DFStates freed by idle or retiring workers
+    std::map<std::string, TenantUsage> tenants;
+};
+
+/**
+ * @brief How the inference workers wait for work and are scheduled by the OS.
+ *
+ * Realtime workers must not poll for long, or they starve the regular threads on their cores;
+ * ConfigManager::getResourceBudget() rejects such combinations.
+ */
+struct WorkerScheduling {
+    IdleStrategy idleStrategy;
+    int realtimePriority = 0;  // SCHED_FIFO priority of the workers; 0 keeps the default policy
+};
+
+/**
+ * @brief Executors shared by all coroutine-based processing stages.
+ *
+ * - Workers run CPU-bound work such as DeepFilterNet inference. Each owns a WorkerContext
+ *   that lives as long as the worker thread. The pool can be elastic: workers are added with
+ *   the queue depth and retire after idling, and a kept worker frees its DFState once idle.
+ * - The I/O pool absorbs blocking file system calls so they never stall a worker.
+ * - The process reactor waits on child processes without holding any thread.
+ * - The fair scheduler shares the workers between tenants by weight.
+ *
+ * One runtime can serve many jobs at once; a job only occupies a thread while it computes.
+ */
+class AsyncRuntime {
+   public:
+    explicit AsyncRuntime(size_t numWorkers, size_t numIOThreads = DEFAULT_NUM_IO_THREADS);
+    AsyncRuntime(ElasticLimits workerLimits, size_t numIOThreads,
+                 WorkerScheduling workerScheduling = {});
+
+    AsyncRuntime(const AsyncRuntime&) = delete;
+    AsyncRuntime& operator=(const AsyncRuntime&) = delete;
+
+    ThreadPool& getWorkers();
+
+    WorkerMetrics getWorkerMetrics() const;
+
+    /**
+     * @brief Returns the calling worker's own context.
+     *
+     * @throws std::logic_error if not called from one of this runtime's workers.
+     */
+    WorkerContext& getWorkerContext();
+
+    /**
+     * @brief Gets the scheduler chunk inference of all tenants is admitted through; it admits
+     *        as many tasks at once as there can be workers.
+     */
+    FairScheduler& getFairScheduler();
+
+    /**
+     * @brief Gets the executor commands run through; initially one starting real processes.
+     */
+    std::shared_ptr<ICommandExecutor> getCommandExecutor() const;
+
+    /**
+     * @brief Routes all commands through `executor`, e.g. to record or replay them.
+     *
+     * Must not be called while commands are running.
+     */
+    void setCommandExecutor(std::shared_ptr<ICommandExecutor> executor);
+
+    /**
+     * @brief Runs a CPU-bound callable on a worker and awaits its result.
+     */
+    template <typename F>
+    Task<std::invoke_result_t<F>> runOnWorkers(F function) {
+        return runOn(m_workers, std::move(function));
+    }
+
+    /**
+     * @brief Runs a blocking file system callable on the I/O pool and awaits its result.
+     */
+    template <typename F>
+    Task<std::invoke_result_t<F>> runBlockingIO(F function) {
+        return runOn(m_ioPool, std::move(function));
+    }
+
+    /**
+     * @brief Asynchronous counterpart of Utils::runCommand(const std::string&, ...).
+     *
+     * @return true if the command exits successfully, false otherwise.
+     */
+    Task<bool> runCommand(std::string command, CancellationToken token);
+
+    /**
+     * @brief Asynchronous counterpart of Utils::runCommand(const std::string&, bool, ...).
+     *
+     * @return The command's stdout, or std::nullopt if it failed or printed nothing.
+     */
+    Task<std::optional<std::string>> runCommandCapture(std::string command,
+                                                       CancellationToken token);
+
+    /**
+     * @brief Asynchronous counterpart of Utils::getMediaDuration().
+     */
+    Task<double> getMediaDuration(fs::path mediaPath, CancellationToken token);
+
+   private:
+    static bool reportOutcome(const std::string& command, const CommandOutcome& outcome,
+                              const CancellationToken& token);
+
+    void onWorkerStart(size_t index);
+    void onWorkerIdle(size_t index);
+    void onWorkerStop(size_t index);
+
+    int m_realtimePriority;
+    std::atomic<bool> m_priorityWarned = false;
+    std::atomic<size_t> m_freedFilterStates = 0;
+    std::vector<std::unique_ptr<WorkerContext>> m_workerContexts;  // outlives m_workers
+    ThreadPool m_workers;
+    ThreadPool m_ioPool;
+    FairScheduler m_fairScheduler;
+    ProcessReactor m_reactor;  // declared after the pools: stopped before it resumes onto them
+    std::shared_ptr<ICommandExecutor> m_commandExecutor;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // ASYNCRUNTIME_H
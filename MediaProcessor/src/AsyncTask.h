@@ -0,0 +1,352 @@
+#ifndef ASYNCTASK_H
+#define ASYNCTASK_H
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <semaphore>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace MediaProcessor {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+/**
+ * @brief Promise state shared by all Task specializations.
+ *
+ * Tasks are lazy: they start when awaited and resume their awaiter through symmetric
+ * transfer when they finish, so chains of tasks do not grow the stack.
+ */
+struct TaskPromiseBase {
+    struct FinalAwaiter {
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            auto continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() {
+        exception = std::current_exception();
+    }
+
+    void rethrowIfFailed() const {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    Task<T> get_return_object();
+
+    template <typename U>
+    void return_value(U&& value) {
+        result.emplace(std::forward<U>(value));
+    }
+
+    T takeResult() {
+        rethrowIfFailed();
+        return std::move(*result);
+    }
+
+    std::optional<T> result;
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object();
+
+    void return_void() noexcept {}
+
+    void takeResult() const {
+        rethrowIfFailed();
+    }
+};
+
+/**
+ * @brief Eagerly started coroutine that destroys itself on completion.
+ *
+ * Only used internally to drive Tasks from non-coroutine code (syncWait, whenAll).
+ */
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+};
+
+template <typename T>
+struct ResultSlot {
+    std::optional<T> value;
+    std::exception_ptr exception;
+};
+
+template <>
+struct ResultSlot<void> {
+    std::exception_ptr exception;
+};
+
+template <typename T>
+struct SyncWaitState {
+    ResultSlot<T> slot;
+    std::binary_semaphore done{0};
+};
+
+// The state is shared so the releasing thread never touches a semaphore the waiter freed
+template <typename T>
+DetachedTask awaitIntoSyncState(Task<T> task, std::shared_ptr<SyncWaitState<T>> state) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(task);
+        } else {
+            state->slot.value.emplace(co_await std::move(task));
+        }
+    } catch (...) {
+        state->slot.exception = std::current_exception();
+    }
+    state->done.release();
+}
+
+struct WhenAllCounter {
+    std::atomic<size_t> remaining;
+    std::coroutine_handle<> continuation;
+};
+
+template <typename T>
+DetachedTask awaitWhenAllMember(Task<T> task, ResultSlot<T>* slot, WhenAllCounter* counter) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(task);
+        } else {
+            slot->value.emplace(co_await std::move(task));
+        }
+    } catch (...) {
+        slot->exception = std::current_exception();
+    }
+
+    if (counter->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        counter->continuation.resume();
+    }
+}
+
+template <typename T>
+struct WhenAllAwaiter {
+    std::vector<Task<T>>& tasks;
+    std::vector<ResultSlot<T>>& slots;
+    WhenAllCounter counter{};
+
+    bool await_ready() const noexcept {
+        return tasks.empty();
+    }
+
+    bool await_suspend(std::coroutine_handle<> continuation) {
+        counter.continuation = continuation;
+        // The extra count keeps the continuation from resuming while tasks are still launched
+        counter.remaining.store(tasks.size() + 1, std::memory_order_relaxed);
+
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            awaitWhenAllMember(std::move(tasks[i]), &slots[i], &counter);
+        }
+
+        return counter.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+}  // namespace detail
+
+/**
+ * @brief Lazily started coroutine producing a value of type T.
+ *
+ * A Task runs on whichever thread resumes it; use `schedule()` or `runOn()` to move work to
+ * an executor, and `syncWait()` to block on a Task from regular code.
+ */
+template <typename T>
+class [[nodiscard]] Task {
+   public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle) : m_handle(handle) {}
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            Handle handle;
+
+            bool await_ready() const noexcept {
+                return !handle || handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+                handle.promise().continuation = continuation;
+                return handle;
+            }
+
+            T await_resume() {
+                return handle.promise().takeResult();
+            }
+        };
+        return Awaiter{m_handle};
+    }
+
+   private:
+    Handle m_handle;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+}  // namespace detail
+
+/**
+ * @brief Runs a Task to completion, blocking the calling thread.
+ *
+ * Must not be called from a thread the Task itself depends on (e.g. a pool worker of the
+ * executor the Task schedules onto).
+ */
+template <typename T>
+T syncWait(Task<T> task) {
+    auto state = std::make_shared<detail::SyncWaitState<T>>();
+
+    detail::awaitIntoSyncState(std::move(task), state);
+    state->done.acquire();
+
+    if (state->slot.exception) {
+        std::rethrow_exception(state->slot.exception);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*state->slot.value);
+    }
+}
+
+/**
+ * @brief Starts all tasks concurrently and completes once every one of them has finished.
+ *
+ * The first exception thrown by any task is rethrown after all tasks are done.
+ */
+template <typename T>
+Task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> whenAll(
+    std::vector<Task<T>> tasks) {
+    std::vector<detail::ResultSlot<T>> slots(tasks.size());
+    co_await detail::WhenAllAwaiter<T>{tasks, slots};
+
+    for (auto& slot : slots) {
+        if (slot.exception) {
+            std::rethrow_exception(slot.exception);
+        }
+    }
+
+    if constexpr (!std::is_void_v<T>) {
+        std::vector<T> results;
+        results.reserve(slots.size());
+        for (auto& slot : slots) {
+            results.push_back(std::move(*slot.value));
+        }
+        co_return results;
+    }
+}
+
+/**
+ * @brief Awaitable that resumes the awaiting coroutine on a ThreadPool worker.
+ */
+inline auto schedule(ThreadPool& pool) {
+    struct ScheduleAwaiter {
+        ThreadPool& pool;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            pool.post([handle]() { handle.resume(); });
+        }
+
+        void await_resume() const noexcept {}
+    };
+    return ScheduleAwaiter{pool};
+}
+
+/**
+ * @brief Runs a regular callable on a ThreadPool and awaits its result.
+ *
+ * The awaiting coroutine continues on the pool thread that ran the callable.
+ */
+template <typename F>
+Task<std::invoke_result_t<F>> runOn(ThreadPool& pool, F function) {
+    co_await schedule(pool);
+    if constexpr (std::is_void_v<std::invoke_result_t<F>>) {
+        function();
+    } else {
+        co_return function();
+    }
+}
+
+}  // namespace MediaProcessor
+
+#endif  // ASYNCTASK_H
@@ -2,121 +2,194 @@
 
 #include <sndfile.h>
 
-#include <future>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <optional>
 #include <sstream>
-#include <thread>
 
 #include "CommandBuilder.h"
-#include "ThreadPool.h"
+#include "CommandExecutor.h"
+#include "DeepFilterStream.h"
+#include "Metrics.h"
+#include "PcmPipeline.h"
+#include "SpeechDetector.h"
+#include "TaskGraph.h"
 #include "Utils.h"
 
 namespace fs = std::filesystem;
 
 namespace MediaProcessor {
 
-AudioProcessor::AudioProcessor(const fs::path& inputVideoPath, const fs::path& outputAudioPath)
+namespace {
+
+/**
+ * @brief The watchdog token of a chunk stage, created when the stage's first node asks for it,
+ *        so the stage deadline does not count the stages running before it.
+ */
+class StageDeadline {
+   public:
+    explicit StageDeadline(std::function<CancellationToken()> createToken)
+        : m_createToken(std::move(createToken)) {}
+
+    const CancellationToken& getToken() {
+        std::call_once(m_started, [this]() { m_token = m_createToken(); });
+        return *m_token;
+    }
+
+    /**
+     * @brief Gets the token if the stage started; only read once its nodes are done.
+     */
+    const CancellationToken* getStartedToken() const {
+        return m_token ? &*m_token : nullptr;
+    }
+
+   private:
+    std::function<CancellationToken()> m_createToken;
+    std::once_flag m_started;
+    std::optional<CancellationToken> m_token;
+};
+
+}  // namespace
+
+AudioProcessor::AudioProcessor(const fs::path& inputVideoPath, const fs::path& outputAudioPath,
+                               const CancellationToken& cancellationToken)
     : m_inputVideoPath(inputVideoPath),
       m_outputAudioPath(outputAudioPath),
       m_overlapDuration(DEFAULT_OVERLAP_DURATION),
-      m_configManager(ConfigManager::getInstance()) {
+      m_configManager(ConfigManager::getInstance()),
+      m_cancellationToken(cancellationToken) {
     m_outputPath = m_outputAudioPath.parent_path();
-    m_chunksPath = m_outputPath / "chunks";
-    m_processedChunksPath = m_outputPath / "processed_chunks";
 
-    m_numChunks = m_configManager.getOptimalThreadCount();
-    std::cout << "INFO: using " << m_numChunks << " threads." << std::endl;
+    // Per-output intermediates, so jobs sharing an output directory can run concurrently
+    const std::string jobPrefix = m_outputAudioPath.stem().string() + "_";
+    m_chunksPath = m_outputPath / (jobPrefix + "chunks");
+    m_processedChunksPath = m_outputPath / (jobPrefix + "processed_chunks");
+    m_segmentsPath = m_outputPath / (jobPrefix + "segments");
+
+    ResourceBudget budget = m_configManager.getResourceBudget();
+    m_numChunks = budget.inferenceWorkers;
+    m_codecThreads = budget.codecThreads;
+    std::cout << "INFO: using " << m_numChunks << " threads, "
+              << (m_codecThreads > 0 ? std::to_string(m_codecThreads) : "FFmpeg's default")
+              << " per FFmpeg process." << std::endl;
 
     m_filterAttenuationLimit = m_configManager.getFilterAttenuationLimit();
     std::cout << "INFO: using " << m_filterAttenuationLimit << " as filter attenaution limit."
               << std::endl;
+
+    m_speechConfig = m_configManager.getSpeechSegmentConfig();
+    m_filterModelPath = m_configManager.getDeepFilterTarballPath();
 }
 
 bool AudioProcessor::isolateVocals() {
+    AsyncRuntime runtime(m_numChunks);
+    if (!installCommandCassette(runtime, m_configManager.getCommandCassette())) {
+        return false;
+    }
+    return syncWait(isolateVocalsAsync(runtime));
+}
+
+void AudioProcessor::setProgress(JobProgress* progress) {
+    m_progress = progress;
+}
+
+void AudioProcessor::setFilterModelPath(const fs::path& modelPath) {
+    m_filterModelPath = modelPath;
+}
+
+void AudioProcessor::setTenant(const std::string& tenant) {
+    m_tenant = tenant;
+}
+
+void AudioProcessor::setPreviewDuration(double seconds) {
+    m_previewDuration = seconds;
+}
+
+Task<bool> AudioProcessor::isolateVocalsAsync(AsyncRuntime& runtime) {
     /*
      * Extracts vocals from a video by chunking, parallel processing, and merging the audio.
      */
 
-    // Ensure output directory exists and remove output file if it exists
-    Utils::ensureDirectoryExists(m_outputPath);
-    Utils::removeFileIfExists(m_outputAudioPath);
+    co_await runtime.runBlockingIO([this]() {
+        // Ensure output directory exists and remove output file if it exists
+        Utils::ensureDirectoryExists(m_outputPath);
+        Utils::removeFileIfExists(m_outputAudioPath);
+    });
 
     std::cout << "Input video path: " << m_inputVideoPath << std::endl;
     std::cout << "Output audio path: " << m_outputAudioPath << std::endl;
 
-    if (!extractAudio()) {
-        return false;
+    // Extraction and splitting make up the decode stage, half each
+    if (!co_await runTimedStep(JobStage::Decode, 0.5, "extract", extractAudio(runtime))) {
+        co_return false;
     }
 
-    m_totalDuration = Utils::getMediaDuration(m_outputAudioPath);
+    m_totalDuration = co_await runtime.getMediaDuration(m_outputAudioPath, m_cancellationToken);
     if (m_totalDuration <= 0) {
         std::cerr << "Error: Invalid audio duration." << std::endl;
-        return false;
+        co_return false;
     }
 
-    if (!splitAudioIntoChunks()) {
-        return false;
+    if (!co_await processChunks(runtime)) {
+        co_return false;
     }
 
-    if (!filterChunks()) {
-        return false;
-    }
-
-    if (!mergeChunks()) {
-        return false;
+    // Built from the per-chunk segments, so it has to happen before they are removed
+    if (m_speechConfig.enabled &&
+        !co_await runtime.runBlockingIO([this]() { return writeSpeechSegments(); })) {
+        co_return false;
     }
 
     // Intermediary files
-    fs::remove_all(m_chunksPath);
-    fs::remove_all(m_processedChunksPath);
+    co_await runtime.runBlockingIO([this]() {
+        fs::remove_all(m_chunksPath);
+        fs::remove_all(m_processedChunksPath);
+        fs::remove_all(m_segmentsPath);
+    });
 
-    return true;
+    co_return true;
 }
 
-bool AudioProcessor::extractAudio() {
+Task<bool> AudioProcessor::extractAudio(AsyncRuntime& runtime) {
     fs::path ffmpegPath = m_configManager.getFFmpegPath();
 
     // Extract the audio with FFmpeg
     CommandBuilder cmd;
     cmd.addArgument(ffmpegPath.string());
     cmd.addFlag("-y");
+    Utils::addFFmpegThreads(cmd, m_codecThreads);
     cmd.addFlag("-i", m_inputVideoPath.string());
-    cmd.addFlag("-ar", "48000");
-    cmd.addFlag("-ac", "1");
+    if (m_previewDuration > 0) {
+        cmd.addFlag("-t", std::to_string(m_previewDuration));
+    }
+    cmd.addFlag("-ar", std::to_string(PIPELINE_SAMPLE_RATE));
+    cmd.addFlag("-ac", std::to_string(PIPELINE_CHANNELS));
     cmd.addFlag("-c:a", "pcm_s16le");
+    cmd.addFlag(Utils::FFMPEG_RF64_FLAG, Utils::FFMPEG_RF64_MODE);  // long inputs exceed 4 GiB
+    Utils::addFFmpegThreads(cmd, m_codecThreads);
     cmd.addArgument(m_outputAudioPath.string());
 
-    if (!Utils::runCommand(cmd.build())) {
+    if (!co_await runtime.runCommand(cmd.build(), createStageToken("extract_audio"))) {
         std::cerr << "Error: Failed to extract and convert audio using FFmpeg." << std::endl;
-        return false;
+        co_return false;
     }
 
     std::cout << "Audio extracted successfully to: " << m_outputAudioPath << std::endl;
-    return true;
+    co_return true;
 }
 
-bool AudioProcessor::splitAudioIntoChunks() {
-    fs::path ffmpegPath = m_configManager.getFFmpegPath();
-
-    Utils::ensureDirectoryExists(m_chunksPath);
-
-    std::vector<double> chunkStartTimes;
-    std::vector<double> chunkDurations;
-    populateChunkDurations(chunkStartTimes, chunkDurations);
-
-    for (int i = 0; i < m_numChunks; ++i) {
-        if (!generateChunkFile(i, chunkStartTimes[i], chunkDurations[i], ffmpegPath)) {
-            std::cerr << "Error: Failed to split audio into chunks." << std::endl;
-            return false;
-        }
+Task<bool> AudioProcessor::generateChunkFile(AsyncRuntime& runtime, int index,
+                                             const double startTime, const double duration,
+                                             fs::path ffmpegPath, CancellationToken token) {
+    const fs::path chunkPath = m_chunkColPath[index];
+    if (isChunkProcessed(index)) {
+        co_return true;  // resumed: the filtered chunk is already there
     }
-    return true;
-}
-
-bool AudioProcessor::generateChunkFile(int index, const double startTime, const double duration,
-                                       const fs::path& ffmpegPath) {
-    fs::path chunkPath = m_chunksPath / ("chunk_" + std::to_string(index) + ".wav");
 
     // Set higher precision for chunk boundaries
     std::ostringstream ssStartTime, ssDuration;
@@ -128,18 +201,20 @@ bool AudioProcessor::generateChunkFile(int index, const double startTime, const
     cmd.addFlag("-y");
     cmd.addFlag("-ss", ssStartTime.str());
     cmd.addFlag("-t", ssDuration.str());
+    Utils::addFFmpegThreads(cmd, m_codecThreads);
     cmd.addFlag("-i", m_outputAudioPath.string());
-    cmd.addFlag("-ar", "48000");
-    cmd.addFlag("-ac", "1");
+    cmd.addFlag("-ar", std::to_string(PIPELINE_SAMPLE_RATE));
+    cmd.addFlag("-ac", std::to_string(PIPELINE_CHANNELS));
     cmd.addFlag("-c:a", "pcm_s16le");
+    cmd.addFlag(Utils::FFMPEG_RF64_FLAG, Utils::FFMPEG_RF64_MODE);
+    Utils::addFFmpegThreads(cmd, m_codecThreads);
     cmd.addArgument(chunkPath.string());
 
-    if (!Utils::runCommand(cmd.build())) {
-        return false;
+    if (!co_await runtime.runCommand(cmd.build(), token)) {
+        std::cerr << "Error: Failed to split audio chunk " << index << "." << std::endl;
+        co_return false;
     }
-
-    m_chunkColPath.push_back(chunkPath);
-    return true;
+    co_return true;
 }
 
 bool AudioProcessor::invokeDeepFilter(fs::path chunkPath) {
@@ -163,9 +238,11 @@ bool AudioProcessor::invokeDeepFilter(fs::path chunkPath) {
     return true;
 }
 
-bool AudioProcessor::invokeDeepFilterFFI(fs::path chunkPath, DFState* df_state,
-                                         std::vector<float>& inputBuffer,
-                                         std::vector<float>& outputBuffer) {
+bool AudioProcessor::invokeDeepFilterFFI(fs::path chunkPath, const fs::path& processedChunkPath,
+                                         DFState* df_state, FrameBuffer& inputBuffer,
+                                         FrameBuffer& outputBuffer,
+                                         const CancellationToken& token,
+                                         std::vector<SpeechSegment>* speechSegments) {
     SF_INFO sfInfoIn;
     SNDFILE* inputFile = sf_open(chunkPath.c_str(), SFM_READ, &sfInfoIn);
     if (!inputFile) {
@@ -173,86 +250,410 @@ bool AudioProcessor::invokeDeepFilterFFI(fs::path chunkPath, DFState* df_state,
         return false;
     }
 
-    // Prepare output file
-    fs::path processedChunkPath = m_processedChunksPath / chunkPath.filename();
-    SNDFILE* outputFile = sf_open(processedChunkPath.c_str(), SFM_WRITE, &sfInfoIn);
+    // Prepare output file, switching to RF64 if the chunk outgrows the RIFF limit
+    SF_INFO sfInfoOut = sfInfoIn;
+    SNDFILE* outputFile = Utils::openWavForWrite(processedChunkPath, sfInfoOut);
     if (!outputFile) {
-        std::cerr << "Error: Could not open output WAV file: " << processedChunkPath << std::endl;
         sf_close(inputFile);
         return false;
     }
 
-    // Process frames
+    // Speech is detected from the statistics of the filtering loop itself
+    std::optional<SpeechDetector> speechDetector;
+    if (speechSegments) {
+        speechDetector.emplace(sfInfoIn.samplerate, m_speechConfig);
+    }
+
+    // The hop loop shared with the plugin and the PCM stream server; its delay, a hop of
+    // buffering plus the model's own, is dropped from the output, and the frames still owed at
+    // the end are flushed with silence, as `deep-filter --compensate-delay` does
+    DeepFilterStream stream(df_state, m_filterModelPath, m_filterAttenuationLimit);
+    const sf_count_t hopLength = stream.getHopLength();
+    sf_count_t framesRead = 0;
+    sf_count_t framesWritten = 0;
+    sf_count_t framesToDiscard = stream.getLatency();
+    uint64_t numHops = 0;
+
+    auto onHop = [&](float lsnr, const float* filteredHop) {
+        // The padding of the last hop is not part of the chunk
+        const sf_count_t hopFrames =
+            std::min(hopLength, framesRead - static_cast<sf_count_t>(numHops++) * hopLength);
+        if (speechDetector && hopFrames > 0) {
+            speechDetector->addFrame(lsnr, filteredHop, hopFrames);
+        }
+    };
+    auto writeFiltered = [&](const float* samples, sf_count_t count) {
+        const sf_count_t discarded = std::min(count, framesToDiscard);
+        framesToDiscard -= discarded;
+        const sf_count_t numFrames = std::min(count - discarded, framesRead - framesWritten);
+        if (numFrames > 0 &&
+            sf_writef_float(outputFile, samples + discarded, numFrames) != numFrames) {
+            std::cerr << "Error: Short write to processed chunk: " << processedChunkPath
+                      << std::endl;
+            return false;
+        }
+        framesWritten += std::max<sf_count_t>(numFrames, 0);
+        return true;
+    };
+
+    bool success = true;
     sf_count_t numFrames;
     while ((numFrames = sf_readf_float(inputFile, inputBuffer.data(), inputBuffer.size())) > 0) {
-        df_process_frame(df_state, inputBuffer.data(), outputBuffer.data());
-        sf_writef_float(outputFile, outputBuffer.data(), numFrames);
+        if (token.isCancelled()) {
+            success = false;
+            break;
+        }
+
+        framesRead += numFrames;
+        stream.process(inputBuffer.data(), outputBuffer.data(), numFrames, onHop);
+        if (!writeFiltered(outputBuffer.data(), numFrames)) {
+            success = false;
+            break;
+        }
+    }
+    // The worker's buffers hold one hop, so the delay is flushed a buffer at a time
+    std::fill(inputBuffer.begin(), inputBuffer.end(), 0.0f);
+    for (size_t owed = stream.getLatency(); success && owed > 0;) {
+        const size_t count = std::min(owed, inputBuffer.size());
+        stream.process(inputBuffer.data(), outputBuffer.data(), count, onHop);
+        success = writeFiltered(outputBuffer.data(), count);
+        owed -= count;
     }
 
     sf_close(inputFile);
     sf_close(outputFile);
+    Metrics::getInstance().framesFiltered.increment(numHops);
 
-    return true;
+    if (success && speechDetector) {
+        *speechSegments = speechDetector->finish();
+    }
+    return success;
+}
+
+std::vector<std::string> AudioProcessor::drainDeepFilterLog(DFState* df_state) {
+    std::vector<std::string> messages;
+    while (char* message = df_next_log_msg(df_state)) {
+        messages.emplace_back(message);
+        df_free_log_msg(message);
+    }
+    return messages;
+}
+
+Task<bool> AudioProcessor::filterChunkFairly(AsyncRuntime& runtime, int index, double share,
+                                             fs::path deepFilterTarballPath,
+                                             unsigned int maxAttempts, CancellationToken token,
+                                             ChunkFailure& failure) {
+    const std::string stepName = "filter_" + std::to_string(index);
+    if (isChunkProcessed(index)) {
+        Metrics::getInstance().chunkCacheHits.increment();
+        std::cout << "INFO: chunk " << index << " already processed, reusing it." << std::endl;
+        co_return runTimedStep(JobStage::Inference, share, stepName, []() { return true; });
+    }
+
+    Metrics::getInstance().chunkCacheMisses.increment();
+
+    // Timed from admission on, so the cost model does not learn other tenants' backlog
+    FairScheduler::Lease lease =
+        co_await runtime.getFairScheduler().acquire(m_tenant, m_chunkDurations[index]);
+    co_return runTimedStep(JobStage::Inference, share, stepName, [&]() {
+        return filterChunkWithRetry(index, runtime.getWorkerContext(), deepFilterTarballPath,
+                                    maxAttempts, token, failure);
+    });
+}
+
+bool AudioProcessor::filterChunkWithRetry(int index, WorkerContext& workerContext,
+                                          const fs::path& deepFilterTarballPath,
+                                          unsigned int maxAttempts,
+                                          const CancellationToken& token, ChunkFailure& failure) {
+    const fs::path processedChunkPath = getProcessedChunkPath(index);
+    fs::path partialChunkPath = processedChunkPath;
+    partialChunkPath += ".partial";
+
+    failure = {index, m_chunkStartTimes[index], m_chunkStartTimes[index] + m_chunkDurations[index],
+               0, {}};
+
+    for (unsigned int attempt = 1; attempt <= maxAttempts; ++attempt) {
+        if (token.isCancelled()) {
+            failure.logMessages.push_back("cancelled: " + token.getReason());
+            return false;
+        }
+        failure.attempts = attempt;
+
+        // The worker keeps its DFState across chunks; it is only recreated after a failure
+        DFState* df_state = workerContext.acquireFilterState(
+            deepFilterTarballPath, m_filterAttenuationLimit, DEEPFILTER_LOG_LEVEL);
+        if (!df_state) {
+            failure.logMessages.push_back("attempt " + std::to_string(attempt) +
+                                          ": failed to instantiate DFState");
+            continue;
+        }
+
+        std::vector<SpeechSegment> speechSegments;
+        bool success = invokeDeepFilterFFI(
+            m_chunkColPath[index], partialChunkPath, df_state, workerContext.getInputBuffer(),
+            workerContext.getOutputBuffer(), token,
+            m_speechConfig.enabled ? &speechSegments : nullptr);
+
+        for (auto& message : drainDeepFilterLog(df_state)) {
+            failure.logMessages.push_back("attempt " + std::to_string(attempt) + ": " + message);
+        }
+
+        // Segments are stored before the chunk is renamed, so a reused chunk always has them
+        if (success && m_speechConfig.enabled) {
+            success = SpeechDetector::save(getSpeechSegmentsPath(index), speechSegments);
+        }
+
+        if (success) {
+            fs::rename(partialChunkPath, processedChunkPath);
+            return true;
+        }
+
+        // A corrupted model state must not poison the retry or the worker's next chunk
+        workerContext.releaseFilterState();
+        fs::remove(partialChunkPath);
+        if (token.isCancelled()) {
+            failure.logMessages.push_back("cancelled: " + token.getReason());
+            return false;
+        }
+
+        std::cerr << "Warning: Chunk " << index << " failed on attempt " << attempt << " of "
+                  << maxAttempts << "." << std::endl;
+    }
+
+    return false;
+}
+
+void AudioProcessor::prepareResume() {
+    const fs::path manifestPath = m_processedChunksPath / RESUME_MANIFEST_FILENAME;
+
+    bool canResume = false;
+    std::ifstream manifestFile(manifestPath);
+    if (manifestFile.is_open()) {
+        try {
+            nlohmann::json manifest = nlohmann::json::parse(manifestFile);
+            canResume = true;
+            for (const auto& [key, value] : getResumeKey().items()) {
+                canResume = canResume && manifest.at(key) == value;
+            }
+        } catch (const nlohmann::json::exception& e) {
+            std::cerr << "Warning: Ignoring unreadable resume manifest: " << e.what()
+                      << std::endl;
+        }
+    }
+
+    if (!canResume) {
+        // Stale chunks from a different job layout would be stitched at the wrong offsets, and
+        // ones filtered by another model or limit would not match the rest of the output
+        fs::remove_all(m_processedChunksPath);
+        Utils::ensureDirectoryExists(m_processedChunksPath);
+    }
+}
+
+nlohmann::json AudioProcessor::getResumeKey() const {
+    return {{"input", m_inputVideoPath.string()},
+            {"num_chunks", m_numChunks},
+            {"total_duration", m_totalDuration},
+            {"overlap_duration", m_overlapDuration},
+            {"preview_duration", m_previewDuration},
+            {"model", m_filterModelPath.string()},
+            {"attenuation_limit", m_filterAttenuationLimit}};
+}
+
+void AudioProcessor::writeResumeManifest(const std::vector<ChunkFailure>& failures) const {
+    nlohmann::json manifest = getResumeKey();
+    manifest["failed_chunks"] = nlohmann::json::array();
+
+    for (const auto& failure : failures) {
+        manifest["failed_chunks"].push_back({{"index", failure.index},
+                                             {"start_time", failure.startTime},
+                                             {"end_time", failure.endTime},
+                                             {"attempts", failure.attempts},
+                                             {"log", failure.logMessages}});
+    }
+
+    std::ofstream(m_processedChunksPath / RESUME_MANIFEST_FILENAME) << manifest.dump(4);
 }
 
-bool AudioProcessor::filterChunks() {
-    Utils::ensureDirectoryExists(m_processedChunksPath);
+bool AudioProcessor::writeSpeechSegments() const {
+    std::vector<std::vector<SpeechSegment>> chunkSegments;
+    for (int i = 0; i < m_numChunks; ++i) {
+        auto segments = SpeechDetector::load(getSpeechSegmentsPath(i));
+        if (!segments) {
+            std::cerr << "Error: Missing speech segments of chunk " << i << "." << std::endl;
+            return false;
+        }
+        chunkSegments.push_back(std::move(*segments));
+    }
 
-    const auto deepFilterTarballPath = m_configManager.getDeepFilterTarballPath();
+    fs::path sidecarPath = m_outputAudioPath;
+    sidecarPath.replace_extension(SPEECH_SEGMENTS_EXTENSION);
+    std::vector<SpeechSegment> segments = SpeechDetector::mergeChunks(
+        chunkSegments, m_chunkStartTimes, m_speechConfig.minGapSeconds);
+    if (!SpeechDetector::save(sidecarPath, segments)) {
+        return false;
+    }
+
+    std::cout << "Speech segments written: " << sidecarPath << " (" << segments.size()
+              << " segments)." << std::endl;
+    return true;
+}
+
+Task<bool> AudioProcessor::processChunks(AsyncRuntime& runtime) {
+    const fs::path ffmpegPath = m_configManager.getFFmpegPath();
+    const fs::path deepFilterTarballPath = m_filterModelPath;
+    const unsigned int maxAttempts = m_configManager.getChunkMaxAttempts();
 
     try {
         m_filterAttenuationLimit = m_configManager.getFilterAttenuationLimit();
     } catch (std::runtime_error& ex) {
         std::cout << "Error while getting filter_attenuation_limit: " << ex.what() << std::endl;
-        return false;
+        co_return false;
     }
 
-    ThreadPool pool(m_numChunks);
-    std::vector<std::future<bool>> results;
+    m_chunkStartTimes.clear();
+    m_chunkDurations.clear();
+    populateChunkDurations(m_chunkStartTimes, m_chunkDurations);
 
+    m_chunkColPath.clear();
     for (int i = 0; i < m_numChunks; ++i) {
-        results.emplace_back(pool.enqueue([&, i]() {
-            // Per-thread DFState instance
-            DFState* df_state =
-                df_create(deepFilterTarballPath.c_str(), m_filterAttenuationLimit, nullptr);
-            if (!df_state) {
-                std::cerr << "Error: Failed to insantiate DFState in thread." << std::endl;
-                return false;
-            }
+        m_chunkColPath.push_back(m_chunksPath / ("chunk_" + std::to_string(i) + ".wav"));
+    }
+
+    co_await runtime.runBlockingIO([this]() {
+        Utils::ensureDirectoryExists(m_chunksPath);
+        Utils::ensureDirectoryExists(m_segmentsPath);
+        prepareResume();
+        writeResumeManifest({});
+    });
 
-            size_t frameLength = df_get_frame_length(df_state);
-            std::vector<float> inputBuffer(frameLength);
-            std::vector<float> outputBuffer(frameLength);
+    StageDeadline splitStage([this]() { return createStageToken("split_audio"); });
+    StageDeadline filterStage([this]() { return createStageToken("filter_chunks"); });
+    StageDeadline mergeStage([this]() { return createStageToken("merge_chunks"); });
 
-            bool success =
-                invokeDeepFilterFFI(m_chunkColPath[i], df_state, inputBuffer, outputBuffer);
-            df_free(df_state);
-            return success;
+    /*
+     * Per chunk: split -> filter -> encode, plus a crossfade for every seam between neighbours.
+     * A node starts as soon as its own inputs are ready, so early chunks are filtered and
+     * encoded while later ones are still being cut.
+     */
+    TaskGraph graph(runtime.getWorkers());
+    std::vector<ChunkFailure> failures(m_numChunks);
+    std::vector<std::vector<short>> seams(m_numChunks - 1);
+    std::vector<TaskGraph::NodeId> filterNodes;
+    std::vector<TaskGraph::NodeId> crossfadeNodes;
+
+    // Share of its stage's estimate each node reports; crossfades are timed but not tracked
+    const double splitShare = 0.5 / m_numChunks;
+    const double filterShare = 1.0 / m_numChunks;
+    const double encodeShare = 0.5 / m_numChunks;
+
+    TaskGraph::NodeId concatNode = graph.addNode("concat", [this, &mergeStage]() {
+        return runTimedStep(JobStage::Encode, 0.5, "concat",
+                            [&]() { return concatSegments(mergeStage.getToken()); });
+    });
+
+    for (int i = 0; i < m_numChunks; ++i) {
+        const std::string suffix = "_" + std::to_string(i);
+
+        TaskGraph::NodeId splitNode = graph.addNode("split" + suffix, [&, i, suffix]() {
+            return runTimedStep(JobStage::Decode, splitShare, "split" + suffix,
+                                generateChunkFile(runtime, i, m_chunkStartTimes[i],
+                                                  m_chunkDurations[i], ffmpegPath,
+                                                  splitStage.getToken()));
+        });
+
+        filterNodes.push_back(graph.addNode("filter" + suffix, [&, i]() {
+            return filterChunkFairly(runtime, i, filterShare, deepFilterTarballPath, maxAttempts,
+                                     filterStage.getToken(), failures[i]);
         }));
+        graph.addEdge(splitNode, filterNodes[i]);
     }
 
-    // Wait for all threads to complete
-    bool allSuccess = true;
-    for (auto& result : results) {
-        allSuccess &= result.get();
+    for (int i = 0; i < m_numChunks - 1; ++i) {
+        const std::string name = "crossfade_" + std::to_string(i);
+        crossfadeNodes.push_back(graph.addNode(name, [&, i, name]() {
+            return runTimedStep(JobStage::Encode, 0.0, name,
+                                crossfadeSeam(runtime, i, seams[i], mergeStage.getToken()));
+        }));
+        graph.addEdge(filterNodes[i], crossfadeNodes[i]);
+        graph.addEdge(filterNodes[i + 1], crossfadeNodes[i]);
     }
 
-    if (!allSuccess) {
-        std::cerr << "Error: One or more chunks failed to process." << std::endl;
-        return false;
+    for (int i = 0; i < m_numChunks; ++i) {
+        const std::string name = "encode_" + std::to_string(i);
+        TaskGraph::NodeId encodeNode = graph.addNode(name, [&, i, name]() {
+            return runTimedStep(JobStage::Encode, encodeShare, name,
+                                [&]() { return writeSegment(i, seams, mergeStage.getToken()); });
+        });
+        graph.addEdge(filterNodes[i], encodeNode);
+        if (i > 0) {
+            graph.addEdge(crossfadeNodes[i - 1], encodeNode);
+        }
+        if (i < m_numChunks - 1) {
+            graph.addEdge(crossfadeNodes[i], encodeNode);
+        }
+        graph.addEdge(encodeNode, concatNode);
     }
 
-    // Update processed chunk paths
-    for (const auto& chunkPath : m_chunkColPath) {
-        fs::path processedChunkPath = m_processedChunksPath / chunkPath.filename();
-        m_processedChunkColPath.push_back(processedChunkPath);
+    bool success = co_await graph.run();
+
+    // A failed chunk does not discard the others
+    std::vector<ChunkFailure> persistentFailures;
+    for (int i = 0; i < m_numChunks; ++i) {
+        if (graph.getNodeState(filterNodes[i]) == TaskGraph::NodeState::Failed) {
+            persistentFailures.push_back(failures[i]);
+        }
     }
 
-    return true;
+    for (const StageDeadline* stage : {&splitStage, &filterStage, &mergeStage}) {
+        const CancellationToken* token = stage->getStartedToken();
+        if (token && token->isCancelled()) {
+            std::cerr << "Error: Chunk processing cancelled (" << token->getReason()
+                      << "). Completed chunks are kept in " << m_processedChunksPath << "."
+                      << std::endl;
+            co_return false;
+        }
+    }
+
+    if (!persistentFailures.empty()) {
+        for (const auto& failure : persistentFailures) {
+            std::cerr << "Error: Chunk " << failure.index << " [" << failure.startTime << "s, "
+                      << failure.endTime << "s] failed after " << failure.attempts
+                      << " attempt(s)." << std::endl;
+            for (const auto& message : failure.logMessages) {
+                std::cerr << "  DeepFilterNet: " << message << std::endl;
+            }
+        }
+        co_await runtime.runBlockingIO(
+            [this, &persistentFailures]() { writeResumeManifest(persistentFailures); });
+
+        std::cerr << "Error: " << persistentFailures.size() << " of " << m_numChunks
+                  << " chunks failed to process. Completed chunks are kept in "
+                  << m_processedChunksPath << " and will be reused on the next run."
+                  << std::endl;
+        co_return false;
+    }
+
+    if (!success) {
+        std::cerr << "Error: Failed to merge back processed audio chunks with crossfading."
+                  << std::endl;
+        co_return false;
+    }
+
+    co_return true;
 }
 
 void AudioProcessor::populateChunkDurations(std::vector<double>& startTimes,
-                                            std::vector<double>& durations) const {
+                                            std::vector<double>& durations) {
+    // Twice the overlap leaves every chunk a body between its seams despite frame rounding
+    if (m_overlapDuration > 0) {
+        const int maxChunks = static_cast<int>(m_totalDuration / (2 * m_overlapDuration));
+        if (maxChunks < m_numChunks) {
+            m_numChunks = std::max(maxChunks, 1);
+            std::cout << "INFO: input is short, splitting it into " << m_numChunks
+                      << " chunk(s)." << std::endl;
+        }
+    }
+
     double chunkDuration = m_totalDuration / m_numChunks;
     for (int i = 0; i < m_numChunks; ++i) {
         double startTime = i * chunkDuration;
@@ -268,63 +669,194 @@ void AudioProcessor::populateChunkDurations(std::vector<double>& startTimes,
     }
 }
 
-std::string AudioProcessor::buildFilterComplex() const {
-    // Build filter complex, i.e. a set of instructions for FFmpeg (called filter graph)
-    std::string filterComplex = "";
-    int filterIndex = 0;
+fs::path AudioProcessor::getProcessedChunkPath(int index) const {
+    return m_processedChunksPath / m_chunkColPath[index].filename();
+}
+
+fs::path AudioProcessor::getSpeechSegmentsPath(int index) const {
+    fs::path speechSegmentsPath = getProcessedChunkPath(index);
+    speechSegmentsPath += SPEECH_SEGMENTS_EXTENSION;
+    return speechSegmentsPath;
+}
+
+bool AudioProcessor::isChunkProcessed(int index) const {
+    // A chunk filtered without speech detection is redone when detection is on
+    return fs::exists(getProcessedChunkPath(index)) &&
+           (!m_speechConfig.enabled || fs::exists(getSpeechSegmentsPath(index)));
+}
+
+fs::path AudioProcessor::getSegmentPath(int index) const {
+    return m_segmentsPath / ("segment_" + std::to_string(index) + ".wav");
+}
+
+CancellationToken AudioProcessor::createStageToken(const std::string& stageName) const {
+    return m_cancellationToken.withTimeout(m_configManager.getStageTimeout(stageName));
+}
 
-    if (m_processedChunkColPath.size() < 2) {
-        return filterComplex;  // Return empty string if not enough chunks
+Task<bool> AudioProcessor::runTimedStep(JobStage stage, double share, std::string stepName,
+                                        Task<bool> step) {
+    auto start = std::chrono::steady_clock::now();
+    bool success = co_await std::move(step);
+    if (success && m_progress) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        m_progress->completeStep(stage, elapsed.count(), share, stepName);
     }
+    co_return success;
+}
 
-    // TODO: extract this into an `applyCrossFade()` method.
-    for (int i = 0; i < static_cast<int>(m_processedChunkColPath.size()) - 1; ++i) {
-        if (i == 0) {
-            // Generate a `crossfade` for the first chunk pair (0 and 1)
-            filterComplex += "[" + std::to_string(i) + ":a][" + std::to_string(i + 1) +
-                             ":a]acrossfade=d=" + std::to_string(m_overlapDuration) +
-                             ":c1=tri:c2=tri[a" + std::to_string(filterIndex) + "]; ";
-        } else {
-            // For the rest, use the result of the previous crossfade (a<filterIndex-1>)
-            // and apply a new crossfade with the next chunk (chunk i+1)
-            filterComplex += "[a" + std::to_string(filterIndex - 1) + "][" + std::to_string(i + 1) +
-                             ":a]acrossfade=d=" + std::to_string(m_overlapDuration) +
-                             ":c1=tri:c2=tri[a" + std::to_string(filterIndex) + "]; ";
+bool AudioProcessor::runTimedStep(JobStage stage, double share, const std::string& stepName,
+                                  const std::function<bool()>& step) {
+    auto start = std::chrono::steady_clock::now();
+    bool success = step();
+    if (success && m_progress) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        m_progress->completeStep(stage, elapsed.count(), share, stepName);
+    }
+    return success;
+}
+
+bool AudioProcessor::readOverlap(int index, std::vector<short>& tail, std::vector<short>& head,
+                                 int& channels) const {
+    SF_INFO sfInfoLeft, sfInfoRight;
+    SNDFILE* leftFile = sf_open(getProcessedChunkPath(index).c_str(), SFM_READ, &sfInfoLeft);
+    SNDFILE* rightFile = sf_open(getProcessedChunkPath(index + 1).c_str(), SFM_READ, &sfInfoRight);
+    if (!leftFile || !rightFile) {
+        std::cerr << "Error: Could not open processed chunks " << index << " and " << index + 1
+                  << " for crossfading." << std::endl;
+        if (leftFile) {
+            sf_close(leftFile);
+        }
+        if (rightFile) {
+            sf_close(rightFile);
         }
-        filterIndex++;
+        return false;
     }
 
-    // Merge the output of the last crossfade into a final output audio stream
-    filterComplex += "[a" + std::to_string(filterIndex - 1) + "]amerge=inputs=1[outa]";
-    return filterComplex;
+    channels = sfInfoLeft.channels;
+    sf_count_t overlapFrames = std::min<sf_count_t>(
+        {std::llround(m_overlapDuration * sfInfoLeft.samplerate), sfInfoLeft.frames,
+         sfInfoRight.frames});
+
+    tail.resize(overlapFrames * channels);
+    head.resize(overlapFrames * channels);
+    bool success = sf_seek(leftFile, sfInfoLeft.frames - overlapFrames, SEEK_SET) != -1 &&
+                   sf_readf_short(leftFile, tail.data(), overlapFrames) == overlapFrames &&
+                   sf_readf_short(rightFile, head.data(), overlapFrames) == overlapFrames;
+
+    sf_close(leftFile);
+    sf_close(rightFile);
+    return success;
 }
 
-bool AudioProcessor::mergeChunks() {
-    fs::path ffmpegPath = m_configManager.getFFmpegPath();
+Task<bool> AudioProcessor::crossfadeSeam(AsyncRuntime& runtime, int index,
+                                         std::vector<short>& seam, CancellationToken token) {
+    if (token.isCancelled()) {
+        co_return false;
+    }
 
-    // Merge processed chunks with `crossfade`
-    CommandBuilder cmd;
-    cmd.addArgument(ffmpegPath.string());
-    cmd.addFlag("-y");
-    for (const auto& chunkPath : m_processedChunkColPath) {
-        cmd.addFlag("-i", chunkPath.string());
+    std::vector<short> tail, head;
+    int channels = 1;
+    bool overlapRead =
+        co_await runtime.runBlockingIO([&]() { return readOverlap(index, tail, head, channels); });
+    if (!overlapRead) {
+        co_return false;
     }
 
-    if (static_cast<int>(m_processedChunkColPath.size()) >= 2) {
-        cmd.addFlag("-filter_complex", buildFilterComplex());
-        cmd.addFlag("-map", "[outa]");
+    const size_t numFrames = tail.size() / channels;
+    const PcmKernels<int16_t> kernels = getPcmKernels<int16_t>(channels);
+    auto mixFrames = [&](size_t first, size_t last) {
+        kernels.crossfade(tail.data(), head.data(), seam.data(), first, last, numFrames, channels);
+    };
+
+    seam.resize(tail.size());
+    co_await parallelFor(runtime.getWorkers(), 0, numFrames, CROSSFADE_GRAIN_FRAMES, mixFrames);
+    co_return true;
+}
+
+bool AudioProcessor::writeSegment(int index, const std::vector<std::vector<short>>& seams,
+                                  const CancellationToken& token) const {
+    const fs::path processedChunkPath = getProcessedChunkPath(index);
+    SF_INFO sfInfoIn;
+    SNDFILE* inputFile = sf_open(processedChunkPath.c_str(), SFM_READ, &sfInfoIn);
+    if (!inputFile) {
+        std::cerr << "Error: Could not open processed chunk: " << processedChunkPath << std::endl;
+        return false;
     }
 
-    cmd.addFlag("-c:a", "pcm_s16le");
-    cmd.addFlag("-ar", "48000");
-    cmd.addArgument(m_outputAudioPath.string());
+    // The head is covered by the previous seam, the tail is replaced by this chunk's seam
+    const int channels = sfInfoIn.channels;
+    sf_count_t headFrames = index > 0 ? seams[index - 1].size() / channels : 0;
+    sf_count_t tailFrames = index < m_numChunks - 1 ? seams[index].size() / channels : 0;
+    sf_count_t bodyFrames = sfInfoIn.frames - headFrames - tailFrames;
+    if (bodyFrames < 0) {
+        std::cerr << "Error: Chunk " << index << " is shorter than its crossfades." << std::endl;
+        sf_close(inputFile);
+        return false;
+    }
 
-    if (!Utils::runCommand(cmd.build())) {
-        std::cerr << "Error: Failed to merge back processed audio chunks with crossfading."
-                  << std::endl;
+    SF_INFO sfInfoOut = sfInfoIn;
+    SNDFILE* outputFile = Utils::openWavForWrite(getSegmentPath(index), sfInfoOut);
+    if (!outputFile) {
+        sf_close(inputFile);
         return false;
     }
 
+    bool success = sf_seek(inputFile, headFrames, SEEK_SET) != -1 &&
+                   copyFrames(inputFile, outputFile, channels, bodyFrames, token);
+    if (success && tailFrames > 0) {
+        success = sf_writef_short(outputFile, seams[index].data(), tailFrames) == tailFrames;
+    }
+
+    sf_close(inputFile);
+    sf_close(outputFile);
+    return success;
+}
+
+bool AudioProcessor::concatSegments(const CancellationToken& token) const {
+    SNDFILE* outputFile = nullptr;
+    bool success = true;
+
+    for (int i = 0; i < m_numChunks && success; ++i) {
+        SF_INFO sfInfoIn;
+        SNDFILE* segmentFile = sf_open(getSegmentPath(i).c_str(), SFM_READ, &sfInfoIn);
+        if (!segmentFile) {
+            std::cerr << "Error: Could not open segment: " << getSegmentPath(i) << std::endl;
+            success = false;
+            break;
+        }
+
+        if (!outputFile) {
+            SF_INFO sfInfoOut = sfInfoIn;
+            outputFile = Utils::openWavForWrite(m_outputAudioPath, sfInfoOut);
+        }
+        success = outputFile &&
+                  copyFrames(segmentFile, outputFile, sfInfoIn.channels, sfInfoIn.frames, token);
+        sf_close(segmentFile);
+    }
+
+    if (outputFile) {
+        sf_close(outputFile);
+    }
+    return success;
+}
+
+bool AudioProcessor::copyFrames(SNDFILE* inputFile, SNDFILE* outputFile, int channels,
+                                sf_count_t numFrames, const CancellationToken& token) {
+    std::vector<short> buffer(PCM_COPY_BLOCK_FRAMES * channels);
+    while (numFrames > 0) {
+        if (token.isCancelled()) {
+            return false;
+        }
+
+        sf_count_t blockFrames = std::min<sf_count_t>(numFrames, PCM_COPY_BLOCK_FRAMES);
+        if (sf_readf_short(inputFile, buffer.data(), blockFrames) != blockFrames ||
+            sf_writef_short(outputFile, buffer.data(), blockFrames) != blockFrames) {
+            std::cerr << "Error: Short read or write while assembling the output audio."
+                      << std::endl;
+            return false;
+        }
+        numFrames -= blockFrames;
+    }
     return true;
 }
 
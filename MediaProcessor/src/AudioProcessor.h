@@ -1,17 +1,41 @@
 #ifndef AUDIOPROCESSOR_H
 #define AUDIOPROCESSOR_H
 
+#include <sndfile.h>
+
 #include <filesystem>
+#include <functional>
+#include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
 
+#include "AsyncRuntime.h"
+#include "AsyncTask.h"
+#include "CancellationToken.h"
 #include "ConfigManager.h"
+#include "CostModel.h"
 #include "DeepFilterNetFFI.h"
+#include "SpeechDetector.h"
 
 namespace fs = std::filesystem;
 
 namespace MediaProcessor {
 constexpr double DEFAULT_OVERLAP_DURATION = 0.5;
+constexpr const char* DEEPFILTER_LOG_LEVEL = "warn";
+constexpr const char* RESUME_MANIFEST_FILENAME = "resume.json";
+constexpr size_t CROSSFADE_GRAIN_FRAMES = 8192;
+constexpr sf_count_t PCM_COPY_BLOCK_FRAMES = 4096;
+
+/**
+ * @brief Diagnostics for a chunk that kept failing after all retry attempts.
+ */
+struct ChunkFailure {
+    int index;
+    double startTime;
+    double endTime;
+    unsigned int attempts;
+    std::vector<std::string> logMessages;
+};
 
 /**
  * @brief Handles audio processing tasks, such as extracting, chunking,
@@ -21,8 +45,12 @@ class AudioProcessor {
    public:
     /**
      * @brief Initializes the AudioProcessor with input and output paths.
+     *
+     * @param cancellationToken Checked between frame blocks and while waiting on child
+     *        processes; each stage additionally gets its configured watchdog deadline.
      */
-    AudioProcessor(const fs::path& inputVideoPath, const fs::path& outputAudioPath);
+    AudioProcessor(const fs::path& inputVideoPath, const fs::path& outputAudioPath,
+                   const CancellationToken& cancellationToken = CancellationToken());
 
     /**
      * @brief Isolates vocals from the input video by processing the audio.
@@ -34,38 +62,176 @@ class AudioProcessor {
      */
     bool isolateVocals();
 
+    /**
+     * @brief Coroutine form of isolateVocals() running on a shared runtime.
+     *
+     * FFmpeg waits are parked on the runtime's process reactor and chunk filtering runs on its
+     * workers, so several jobs can be in flight on the same runtime.
+     */
+    Task<bool> isolateVocalsAsync(AsyncRuntime& runtime);
+
+    /**
+     * @brief Reports the time of every pipeline step to `progress`, which must outlive the
+     *        processing; nullptr disables reporting.
+     */
+    void setProgress(JobProgress* progress);
+
+    /**
+     * @brief Filters with the DeepFilterNet model at `modelPath` instead of the configured one.
+     */
+    void setFilterModelPath(const fs::path& modelPath);
+
+    /**
+     * @brief Only processes the first `seconds` of the input; zero processes all of it.
+     */
+    void setPreviewDuration(double seconds);
+
+    /**
+     * @brief Names the tenant whose share of the workers this job's chunk filtering uses.
+     */
+    void setTenant(const std::string& tenant);
+
    private:
     fs::path m_inputVideoPath;
     fs::path m_outputAudioPath;
     fs::path m_outputPath;
     fs::path m_chunksPath;
     fs::path m_processedChunksPath;
+    fs::path m_segmentsPath;
     std::vector<fs::path> m_chunkColPath;
-    std::vector<fs::path> m_processedChunkColPath;
+
+    std::vector<double> m_chunkStartTimes;
+    std::vector<double> m_chunkDurations;
 
     int m_numChunks;
+    unsigned int m_codecThreads;
 
     double m_totalDuration;
     double m_overlapDuration;
     float m_filterAttenuationLimit;
+    fs::path m_filterModelPath;
+    double m_previewDuration = 0.0;
+    std::string m_tenant = DEFAULT_TENANT;
+    SpeechSegmentConfig m_speechConfig;
 
     ConfigManager& m_configManager;
+    CancellationToken m_cancellationToken;
+    JobProgress* m_progress = nullptr;
 
-    bool extractAudio();
-    bool splitAudioIntoChunks();
-    bool generateChunkFile(int index, const double startTime, const double duration,
-                           const fs::path& ffmpegPath);
-    bool filterChunks();
-    bool mergeChunks();
+    Task<bool> extractAudio(AsyncRuntime& runtime);
+
+    /**
+     * @brief Splits, filters, crossfades and reassembles the chunks as one task graph.
+     *
+     * Each chunk gets its own split, filter and encode node, and each seam between two
+     * neighbouring chunks a crossfade node, so work from different stages overlaps.
+     */
+    Task<bool> processChunks(AsyncRuntime& runtime);
+    Task<bool> generateChunkFile(AsyncRuntime& runtime, int index, const double startTime,
+                                 const double duration, fs::path ffmpegPath,
+                                 CancellationToken token);
+
+    /**
+     * @brief Filters a chunk once the runtime's fair scheduler admits it for this tenant, or
+     *        reuses the chunk processed by a previous run.
+     */
+    Task<bool> filterChunkFairly(AsyncRuntime& runtime, int index, double share,
+                                 fs::path deepFilterTarballPath, unsigned int maxAttempts,
+                                 CancellationToken token, ChunkFailure& failure);
+
+    /**
+     * @brief Filters a single chunk with the worker's DFState, retrying on a fresh DFState
+     *        until it succeeds or `maxAttempts` is exhausted.
+     *
+     * The processed chunk is written to a temporary file and only renamed into place on
+     * success, so an existing processed chunk is always complete and can be reused on resume.
+     *
+     * @return true on success, false with `failure` populated otherwise.
+     */
+    bool filterChunkWithRetry(int index, WorkerContext& workerContext,
+                              const fs::path& deepFilterTarballPath, unsigned int maxAttempts,
+                              const CancellationToken& token, ChunkFailure& failure);
+
+    /**
+     * @brief Keeps previously processed chunks if they belong to the same job layout, model
+     *        and attenuation limit, discards them otherwise.
+     */
+    void prepareResume();
+    /**
+     * @brief Gets what previously processed chunks must have been made with to be reused.
+     */
+    nlohmann::json getResumeKey() const;
+    void writeResumeManifest(const std::vector<ChunkFailure>& failures) const;
+
+    /**
+     * @brief Joins the speech segments of all chunks into the output's `.speech.json` sidecar.
+     */
+    bool writeSpeechSegments() const;
+
+    /**
+     * @brief Reads the overlapping frames of processed chunks `index` and `index + 1`.
+     */
+    bool readOverlap(int index, std::vector<short>& tail, std::vector<short>& head,
+                     int& channels) const;
+
+    /**
+     * @brief Mixes the seam between chunks `index` and `index + 1` into `seam`.
+     */
+    Task<bool> crossfadeSeam(AsyncRuntime& runtime, int index, std::vector<short>& seam,
+                             CancellationToken token);
+
+    /**
+     * @brief Writes the part of chunk `index` that belongs to no other chunk, followed by its
+     *        crossfaded seam with the next chunk.
+     */
+    bool writeSegment(int index, const std::vector<std::vector<short>>& seams,
+                      const CancellationToken& token) const;
+    bool concatSegments(const CancellationToken& token) const;
+    static bool copyFrames(SNDFILE* inputFile, SNDFILE* outputFile, int channels,
+                           sf_count_t numFrames, const CancellationToken& token);
     bool invokeDeepFilter(fs::path chunkPath);
 
-    bool invokeDeepFilterFFI(fs::path chunkPath, DFState* df_state, std::vector<float>& inputBuffer,
-                             std::vector<float>& outputBuffer);
+    /**
+     * @brief Filters a chunk frame by frame.
+     *
+     * @param speechSegments If not nullptr, receives the speech segments detected in the chunk.
+     */
+    bool invokeDeepFilterFFI(fs::path chunkPath, const fs::path& processedChunkPath,
+                             DFState* df_state, FrameBuffer& inputBuffer,
+                             FrameBuffer& outputBuffer, const CancellationToken& token,
+                             std::vector<SpeechSegment>* speechSegments = nullptr);
+
+    /**
+     * @brief Collects and frees all pending DeepFilterNet log messages of a state.
+     */
+    static std::vector<std::string> drainDeepFilterLog(DFState* df_state);
+
+    /**
+     * @brief Splits the input into chunks, fewer than workers if the input is too short for
+     *        every chunk to outlast the crossfades at both of its ends.
+     */
+    void populateChunkDurations(std::vector<double>& startTimes, std::vector<double>& durations);
 
-    std::string buildFilterComplex() const;
+    fs::path getProcessedChunkPath(int index) const;
+    fs::path getSpeechSegmentsPath(int index) const;
 
-    void populateChunkDurations(std::vector<double>& startTimes,
-                                std::vector<double>& durations) const;
+    /**
+     * @brief Whether chunk `index` was already filtered by an earlier run and can be reused.
+     */
+    bool isChunkProcessed(int index) const;
+    fs::path getSegmentPath(int index) const;
+
+    /**
+     * @brief Derives a stage token carrying the stage's watchdog deadline, if configured.
+     */
+    CancellationToken createStageToken(const std::string& stageName) const;
+
+    /**
+     * @brief Runs a pipeline step and, if it succeeds, reports its time as `share` of `stage`.
+     */
+    Task<bool> runTimedStep(JobStage stage, double share, std::string stepName, Task<bool> step);
+    bool runTimedStep(JobStage stage, double share, const std::string& stepName,
+                      const std::function<bool()>& step);
 };
 
 }  // namespace MediaProcessor
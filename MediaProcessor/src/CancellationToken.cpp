@@ -0,0 +1,66 @@
+#include "CancellationToken.h"
+
+namespace MediaProcessor {
+
+CancellationToken::CancellationToken() : m_state(std::make_shared<State>()) {}
+
+CancellationToken::CancellationToken(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+void CancellationToken::cancel(const std::string& reason) {
+    cancelState(*m_state, reason);
+}
+
+bool CancellationToken::isCancelled() const {
+    return isStateCancelled(*m_state);
+}
+
+std::string CancellationToken::getReason() const {
+    // Walk up to the first cancelled token so children report their parent's reason
+    for (State* state = m_state.get(); state; state = state->parent.get()) {
+        if (isStateCancelled(*state)) {
+            std::lock_guard<std::mutex> lock(state->reasonMutex);
+            if (!state->reason.empty()) {
+                return state->reason;
+            }
+        }
+    }
+    return "";
+}
+
+CancellationToken CancellationToken::withTimeout(Clock::duration timeout) const {
+    auto child = std::make_shared<State>();
+    child->parent = m_state;
+    if (timeout > Clock::duration::zero()) {
+        child->deadline = Clock::now() + timeout;
+    }
+    return CancellationToken(child);
+}
+
+bool CancellationToken::isStateCancelled(State& state) {
+    if (state.cancelled.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    if (state.deadline && Clock::now() >= *state.deadline) {
+        cancelState(state, "stage deadline exceeded");
+        return true;
+    }
+
+    if (state.parent && isStateCancelled(*state.parent)) {
+        cancelState(state, "");  // parent keeps the reason
+        return true;
+    }
+
+    return false;
+}
+
+void CancellationToken::cancelState(State& state, const std::string& reason) {
+    std::lock_guard<std::mutex> lock(state.reasonMutex);
+    if (state.cancelled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    state.reason = reason;
+    state.cancelled.store(true, std::memory_order_release);
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,70 @@
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace MediaProcessor {
+
+/**
+ * @brief Cooperative cancellation flag shared between a job and everything it spawns.
+ *
+ * Copies share the same state, so a token can be handed to pool tasks and child process
+ * waits by value. Child tokens created with `withTimeout()` act as per-stage watchdogs: they
+ * are cancelled when their deadline passes or when any of their parents is cancelled, while
+ * cancelling a child never affects the parent.
+ */
+class CancellationToken {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    CancellationToken();
+
+    /**
+     * @brief Requests cancellation. Only the first reason is kept.
+     */
+    void cancel(const std::string& reason = "cancelled by request");
+
+    /**
+     * @brief Checks whether this token, one of its parents, or a deadline has fired.
+     *
+     * Cheap enough to be polled between frame blocks.
+     */
+    bool isCancelled() const;
+
+    /**
+     * @brief Returns why the token was cancelled, or an empty string if it was not.
+     */
+    std::string getReason() const;
+
+    /**
+     * @brief Creates a child token that is additionally cancelled after `timeout`.
+     *
+     * A zero timeout creates a child without a deadline.
+     */
+    CancellationToken withTimeout(Clock::duration timeout) const;
+
+   private:
+    struct State {
+        std::atomic<bool> cancelled{false};
+        mutable std::mutex reasonMutex;
+        std::string reason;
+        std::optional<Clock::time_point> deadline;
+        std::shared_ptr<State> parent;
+    };
+
+    explicit CancellationToken(std::shared_ptr<State> state);
+
+    static bool isStateCancelled(State& state);
+    static void cancelState(State& state, const std::string& reason);
+
+    std::shared_ptr<State> m_state;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // CANCELLATIONTOKEN_H
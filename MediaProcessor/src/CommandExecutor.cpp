@@ -0,0 +1,306 @@
+#include "CommandExecutor.h"
+
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+#include "AsyncRuntime.h"
+#include "Metrics.h"
+#include "Utils.h"
+
+namespace MediaProcessor {
+
+namespace {
+
+struct FileState {
+    fs::file_time_type lastWriteTime;
+    uintmax_t size;
+};
+
+/**
+ * @brief Captures the state of every argument that names a regular file below `rootPath`.
+ */
+std::unordered_map<std::string, FileState> snapshotFiles(const std::vector<std::string>& arguments,
+                                                         const fs::path& rootPath) {
+    std::unordered_map<std::string, FileState> states;
+    for (const auto& argument : arguments) {
+        std::error_code ec;
+        fs::path path = fs::absolute(argument, ec).lexically_normal();
+        fs::path relativePath = path.lexically_relative(rootPath);
+        if (ec || relativePath.empty() || *relativePath.begin() == "..") {
+            continue;
+        }
+
+        if (fs::is_regular_file(path, ec)) {
+            states[path.string()] = {fs::last_write_time(path, ec), fs::file_size(path, ec)};
+        }
+    }
+    return states;
+}
+
+}  // namespace
+
+SystemCommandExecutor::SystemCommandExecutor(ProcessReactor& reactor) : m_reactor(reactor) {}
+
+Task<CommandOutcome> SystemCommandExecutor::execute(std::string command, bool mergeStderr,
+                                                    CancellationToken token) {
+    co_return co_await m_reactor.run(std::move(command), mergeStderr, std::move(token));
+}
+
+CommandCassette::CommandCassette(const fs::path& directory, const fs::path& rootPath)
+    : m_directory(directory), m_rootPath(fs::absolute(rootPath).lexically_normal()) {
+    // Without the trailing separator the root is also found inside sibling paths
+    if (!m_rootPath.has_filename()) {
+        m_rootPath = m_rootPath.parent_path();
+    }
+}
+
+bool CommandCassette::load() {
+    std::ifstream indexFile(m_directory / CASSETTE_INDEX_FILENAME);
+    if (!indexFile.is_open()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    try {
+        nlohmann::json index = nlohmann::json::parse(indexFile);
+        for (const auto& entry : index.at("commands")) {
+            RecordedCommand recording;
+            recording.returnCode = entry.at("return_code").get<int>();
+            recording.output = entry.at("output").get<std::string>();
+            for (const auto& artefact : entry.at("artefacts")) {
+                recording.artefacts.emplace_back(artefact.at("path").get<std::string>());
+                recording.blobs.emplace_back(artefact.at("blob").get<std::string>());
+            }
+            m_recordings[entry.at("command").get<std::string>()] = std::move(recording);
+        }
+        m_nextBlob = index.value("next_blob", size_t(0));
+    } catch (const nlohmann::json::exception& e) {
+        std::cerr << "Error: Unreadable command cassette " << m_directory << ": " << e.what()
+                  << std::endl;
+        m_recordings.clear();
+        return false;
+    }
+    return true;
+}
+
+std::optional<RecordedCommand> CommandCassette::find(const std::string& command) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_recordings.find(normalize(command));
+    if (it == m_recordings.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool CommandCassette::record(const std::string& command, const CommandOutcome& outcome,
+                             const std::vector<fs::path>& artefacts) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    RecordedCommand recording;
+    recording.returnCode = outcome.returnCode;
+    recording.output = outcome.output;
+
+    std::error_code ec;
+    fs::create_directories(m_directory / "artefacts", ec);
+    for (const auto& artefact : artefacts) {
+        fs::path blob = fs::path("artefacts") / (std::to_string(m_nextBlob++) + ".bin");
+        if (!fs::copy_file(artefact, m_directory / blob, fs::copy_options::overwrite_existing,
+                           ec)) {
+            std::cerr << "Error: Could not record artefact " << artefact << ": " << ec.message()
+                      << std::endl;
+            return false;
+        }
+        recording.artefacts.push_back(artefact.lexically_relative(m_rootPath));
+        recording.blobs.push_back(blob);
+    }
+
+    m_recordings[normalize(command)] = std::move(recording);
+    return saveLocked();
+}
+
+bool CommandCassette::restoreArtefacts(const RecordedCommand& recording) const {
+    for (size_t i = 0; i < recording.artefacts.size(); ++i) {
+        fs::path target = m_rootPath / recording.artefacts[i];
+        std::error_code ec;
+        fs::create_directories(target.parent_path(), ec);
+        if (!fs::copy_file(m_directory / recording.blobs[i], target,
+                           fs::copy_options::overwrite_existing, ec)) {
+            std::cerr << "Error: Could not restore recorded artefact " << target << ": "
+                      << ec.message() << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> CommandCassette::splitArguments(const std::string& command) {
+    // Mirrors CommandBuilder::formatArgument(): arguments with whitespace are double-quoted
+    std::vector<std::string> arguments;
+    std::string current;
+    bool quoted = false;
+    for (char c : command) {
+        if (c == '"') {
+            quoted = !quoted;
+        } else if (c == ' ' && !quoted) {
+            if (!current.empty()) {
+                arguments.push_back(std::move(current));
+                current.clear();
+            }
+        } else {
+            current += c;
+        }
+    }
+    if (!current.empty()) {
+        arguments.push_back(std::move(current));
+    }
+    return arguments;
+}
+
+const fs::path& CommandCassette::getRootPath() const {
+    return m_rootPath;
+}
+
+std::string CommandCassette::normalize(const std::string& command) const {
+    // Per argument, so a root with whitespace does not leave its quotes behind in the key
+    const std::string root = m_rootPath.string();
+    std::string normalized;
+    for (std::string argument : splitArguments(command)) {
+        for (size_t pos = argument.find(root); pos != std::string::npos;
+             pos = argument.find(root, pos)) {
+            argument.replace(pos, root.size(), CASSETTE_ROOT_PLACEHOLDER);
+        }
+
+        if (!normalized.empty()) {
+            normalized += ' ';
+        }
+        normalized += Utils::containsWhitespace(argument) ? "\"" + argument + "\"" : argument;
+    }
+    return normalized;
+}
+
+bool CommandCassette::saveLocked() const {
+    nlohmann::json index = {{"commands", nlohmann::json::array()}, {"next_blob", m_nextBlob}};
+    for (const auto& [command, recording] : m_recordings) {
+        nlohmann::json artefacts = nlohmann::json::array();
+        for (size_t i = 0; i < recording.artefacts.size(); ++i) {
+            artefacts.push_back(
+                {{"path", recording.artefacts[i].string()}, {"blob", recording.blobs[i].string()}});
+        }
+        index["commands"].push_back({{"command", command},
+                                     {"return_code", recording.returnCode},
+                                     {"output", recording.output},
+                                     {"artefacts", artefacts}});
+    }
+
+    // Write and rename so an interrupted recording never leaves a truncated index
+    const fs::path indexPath = m_directory / CASSETTE_INDEX_FILENAME;
+    fs::path partialPath = indexPath;
+    partialPath += ".partial";
+    {
+        std::ofstream indexFile(partialPath);
+        if (!(indexFile << index.dump(4))) {
+            std::cerr << "Error: Could not write command cassette: " << indexPath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(partialPath, indexPath, ec);
+    return !ec;
+}
+
+RecordingCommandExecutor::RecordingCommandExecutor(std::shared_ptr<ICommandExecutor> inner,
+                                                   std::shared_ptr<CommandCassette> cassette)
+    : m_inner(std::move(inner)), m_cassette(std::move(cassette)) {}
+
+Task<CommandOutcome> RecordingCommandExecutor::execute(std::string command, bool mergeStderr,
+                                                       CancellationToken token) {
+    const std::vector<std::string> arguments = CommandCassette::splitArguments(command);
+    auto before = snapshotFiles(arguments, m_cassette->getRootPath());
+
+    CommandOutcome outcome = co_await m_inner->execute(command, mergeStderr, token);
+    if (!outcome.launched || outcome.cancelled) {
+        co_return outcome;  // says nothing about the command itself
+    }
+
+    std::vector<fs::path> artefacts;
+    for (const auto& [path, state] : snapshotFiles(arguments, m_cassette->getRootPath())) {
+        auto previous = before.find(path);
+        if (previous == before.end() || previous->second.lastWriteTime != state.lastWriteTime ||
+            previous->second.size != state.size) {
+            artefacts.emplace_back(path);
+        }
+    }
+
+    m_cassette->record(command, outcome, artefacts);
+    co_return outcome;
+}
+
+ReplayCommandExecutor::ReplayCommandExecutor(std::shared_ptr<CommandCassette> cassette,
+                                             std::shared_ptr<ICommandExecutor> fallback)
+    : m_cassette(std::move(cassette)), m_fallback(std::move(fallback)) {}
+
+Task<CommandOutcome> ReplayCommandExecutor::execute(std::string command, bool mergeStderr,
+                                                    CancellationToken token) {
+    CommandOutcome outcome;
+    if (token.isCancelled()) {
+        outcome.cancelled = true;
+        co_return outcome;
+    }
+
+    std::optional<RecordedCommand> recording = m_cassette->find(command);
+    if (!recording) {
+        Metrics::getInstance().cassetteMisses.increment();
+        if (m_fallback) {
+            co_return co_await m_fallback->execute(std::move(command), mergeStderr,
+                                                   std::move(token));
+        }
+        std::cerr << "Error: No recording for command: " << command << std::endl;
+        co_return outcome;
+    }
+
+    Metrics::getInstance().cassetteHits.increment();
+    if (!m_cassette->restoreArtefacts(*recording)) {
+        co_return outcome;
+    }
+
+    outcome.launched = true;
+    outcome.returnCode = recording->returnCode;
+    outcome.output = std::move(recording->output);
+    co_return outcome;
+}
+
+bool installCommandCassette(AsyncRuntime& runtime, const CommandCassetteConfig& config) {
+    if (config.mode == CassetteMode::Off) {
+        return true;
+    }
+
+    auto cassette = std::make_shared<CommandCassette>(config.path, config.rootPath);
+    bool loaded = cassette->load();
+    std::shared_ptr<ICommandExecutor> systemExecutor = runtime.getCommandExecutor();
+
+    switch (config.mode) {
+        case CassetteMode::Record:
+            runtime.setCommandExecutor(
+                std::make_shared<RecordingCommandExecutor>(systemExecutor, cassette));
+            break;
+        case CassetteMode::Replay:
+            if (!loaded) {
+                std::cerr << "Error: Could not load command cassette: " << config.path
+                          << std::endl;
+                return false;
+            }
+            runtime.setCommandExecutor(std::make_shared<ReplayCommandExecutor>(cassette));
+            break;
+        case CassetteMode::Auto:
+            runtime.setCommandExecutor(std::make_shared<ReplayCommandExecutor>(
+                cassette, std::make_shared<RecordingCommandExecutor>(systemExecutor, cassette)));
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,145 @@
+#ifndef COMMANDEXECUTOR_H
+#define COMMANDEXECUTOR_H
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ConfigManager.h"
+#include "ICommandExecutor.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr const char* CASSETTE_INDEX_FILENAME = "cassette.json";
+constexpr const char* CASSETTE_ROOT_PLACEHOLDER = "{root}";
+
+class AsyncRuntime;
+
+/**
+ * @brief Runs commands as real child processes through the runtime's ProcessReactor.
+ */
+class SystemCommandExecutor : public ICommandExecutor {
+   public:
+    explicit SystemCommandExecutor(ProcessReactor& reactor);
+
+    Task<CommandOutcome> execute(std::string command, bool mergeStderr,
+                                 CancellationToken token) override;
+
+   private:
+    ProcessReactor& m_reactor;
+};
+
+/**
+ * @brief A command's recorded result and the files it produced.
+ */
+struct RecordedCommand {
+    int returnCode = 0;
+    std::string output;
+    std::vector<fs::path> artefacts;  // relative to the cassette's root
+    std::vector<fs::path> blobs;      // stored copies, relative to the cassette directory
+};
+
+/**
+ * @brief On-disk store of recorded commands, keyed by their command line.
+ *
+ * Paths below `rootPath` are stored relative to it, so a cassette recorded in one checkout or
+ * temporary directory replays in another. Safe to share between concurrently running
+ * commands; every recording is written through immediately.
+ */
+class CommandCassette {
+   public:
+    CommandCassette(const fs::path& directory, const fs::path& rootPath);
+
+    /**
+     * @brief Loads a previously saved cassette.
+     *
+     * @return true if the cassette exists and could be read, false otherwise.
+     */
+    bool load();
+
+    std::optional<RecordedCommand> find(const std::string& command) const;
+
+    /**
+     * @brief Stores a command's outcome together with copies of `artefacts`.
+     */
+    bool record(const std::string& command, const CommandOutcome& outcome,
+                const std::vector<fs::path>& artefacts);
+
+    /**
+     * @brief Copies a recording's artefacts back to where the command wrote them.
+     */
+    bool restoreArtefacts(const RecordedCommand& recording) const;
+
+    /**
+     * @brief Splits a command line built by CommandBuilder into its arguments.
+     */
+    static std::vector<std::string> splitArguments(const std::string& command);
+
+    const fs::path& getRootPath() const;
+
+   private:
+    std::string normalize(const std::string& command) const;
+    bool saveLocked() const;
+
+    fs::path m_directory;
+    fs::path m_rootPath;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, RecordedCommand> m_recordings;
+    size_t m_nextBlob = 0;
+};
+
+/**
+ * @brief Runs commands on an inner executor and records their outcomes into a cassette.
+ *
+ * Every argument naming a file below the cassette's root that the command created or
+ * modified is recorded as one of its artefacts.
+ */
+class RecordingCommandExecutor : public ICommandExecutor {
+   public:
+    RecordingCommandExecutor(std::shared_ptr<ICommandExecutor> inner,
+                             std::shared_ptr<CommandCassette> cassette);
+
+    Task<CommandOutcome> execute(std::string command, bool mergeStderr,
+                                 CancellationToken token) override;
+
+   private:
+    std::shared_ptr<ICommandExecutor> m_inner;
+    std::shared_ptr<CommandCassette> m_cassette;
+};
+
+/**
+ * @brief Serves recorded outcomes and artefacts without starting any process.
+ *
+ * Commands missing from the cassette go to `fallback` if one is given (typically a
+ * RecordingCommandExecutor, so the cassette fills itself) and fail otherwise.
+ */
+class ReplayCommandExecutor : public ICommandExecutor {
+   public:
+    explicit ReplayCommandExecutor(std::shared_ptr<CommandCassette> cassette,
+                                   std::shared_ptr<ICommandExecutor> fallback = nullptr);
+
+    Task<CommandOutcome> execute(std::string command, bool mergeStderr,
+                                 CancellationToken token) override;
+
+   private:
+    std::shared_ptr<CommandCassette> m_cassette;
+    std::shared_ptr<ICommandExecutor> m_fallback;
+};
+
+/**
+ * @brief Wraps the runtime's command executor according to the `command_cassette` settings.
+ *
+ * @return false if a replay cassette could not be loaded, true otherwise.
+ */
+bool installCommandCassette(AsyncRuntime& runtime, const CommandCassetteConfig& config);
+
+}  // namespace MediaProcessor
+
+#endif  // COMMANDEXECUTOR_H
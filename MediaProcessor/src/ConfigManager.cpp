@@ -2,8 +2,10 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <unordered_map>
 
 #include "HardwareUtils.h"
 #include "Utils.h"
@@ -72,6 +74,265 @@ unsigned int ConfigManager::getOptimalThreadCount() {
     return determineNumThreads(configNumThreads, hardwareNumThreads);
 }
 
+unsigned int ConfigManager::getChunkMaxAttempts() const {
+    unsigned int maxAttempts =
+        getConfigValue<unsigned int>("chunk_max_attempts", DEFAULT_CHUNK_MAX_ATTEMPTS);
+
+    return std::max(maxAttempts, 1u);
+}
+
+std::chrono::seconds ConfigManager::getStageTimeout(const std::string& stageName) const {
+    auto stageTimeouts =
+        getConfigValue<nlohmann::json>("stage_timeouts", nlohmann::json::object());
+
+    return std::chrono::seconds(stageTimeouts.value(stageName, 0u));
+}
+
+fs::path ConfigManager::getCostModelPath() const {
+    return getConfigValue<std::string>("cost_model_path", DEFAULT_COST_MODEL_PATH);
+}
+
+fs::path ConfigManager::getPoolMetricsPath() const {
+    return getConfigValue<std::string>("pool_metrics_path", "");
+}
+
+std::string ConfigManager::getMetricsEndpoint() const {
+    return getConfigValue<std::string>("metrics_endpoint", "");
+}
+
+unsigned int ConfigManager::getMaxConcurrentJobs() const {
+    unsigned int maxJobs =
+        getConfigValue<unsigned int>("max_concurrent_jobs", DEFAULT_MAX_CONCURRENT_JOBS);
+
+    return std::max(maxJobs, 1u);
+}
+
+std::chrono::seconds ConfigManager::getMaxJobSeconds() const {
+    return std::chrono::seconds(getConfigValue<unsigned int>("max_job_seconds", 0u));
+}
+
+ResourceBudget ConfigManager::getResourceBudget() {
+    auto budgetConfig =
+        getConfigValue<nlohmann::json>("resource_budget", nlohmann::json::object());
+
+    ResourceBudget budget;
+    budget.totalCores = budgetConfig.value("total_cores", 0u);
+    if (budget.totalCores == 0) {
+        budget.totalCores = getOptimalThreadCount();
+    }
+
+    budget.inferenceWorkers = budgetConfig.value("inference_workers", 0u);
+    if (!Utils::isWithinRange(budget.inferenceWorkers, 1u, budget.totalCores)) {
+        budget.inferenceWorkers = budget.totalCores;
+    }
+
+    // Every inference worker may hold a DFState
+    const unsigned int memoryBudgetMb = budgetConfig.value("memory_budget_mb", 0u);
+    const unsigned int filterStateMb =
+        std::max(budgetConfig.value("filter_state_mb", DEFAULT_FILTER_STATE_MB), 1u);
+    if (memoryBudgetMb > 0) {
+        budget.inferenceWorkers =
+            std::clamp(memoryBudgetMb / filterStateMb, 1u, budget.inferenceWorkers);
+    }
+
+    budget.minInferenceWorkers =
+        budgetConfig.value("min_inference_workers", budget.inferenceWorkers);
+    if (!Utils::isWithinRange(budget.minInferenceWorkers, 1u, budget.inferenceWorkers)) {
+        budget.minInferenceWorkers = budget.inferenceWorkers;
+    }
+    budget.workerIdleTimeout =
+        std::chrono::seconds(budgetConfig.value("worker_idle_seconds", 0u));
+    budget.workerSpinTime =
+        std::chrono::microseconds(budgetConfig.value("worker_spin_microseconds", 0u));
+    budget.workerYieldTime =
+        std::chrono::microseconds(budgetConfig.value("worker_yield_microseconds", 0u));
+
+    budget.inferencePriority = budgetConfig.value("inference_realtime_priority", 0);
+    if (!Utils::isWithinRange(budget.inferencePriority, 0, MAX_REALTIME_PRIORITY)) {
+        throw std::runtime_error(
+            fmt::format("inference_realtime_priority must be within [0, {}], got {}.",
+                        MAX_REALTIME_PRIORITY, budget.inferencePriority));
+    }
+    if (budget.inferencePriority > 0 &&
+        (budget.workerYieldTime.count() > 0 ||
+         budget.workerSpinTime > std::chrono::microseconds(MAX_REALTIME_SPIN_MICROSECONDS))) {
+        throw std::runtime_error(fmt::format(
+            "inference_realtime_priority needs worker_yield_microseconds to be 0 and "
+            "worker_spin_microseconds at most {}, or the polling workers starve the others.",
+            MAX_REALTIME_SPIN_MICROSECONDS));
+    }
+
+    budget.ioThreads = budgetConfig.value("io_threads", 0u);
+    if (budget.ioThreads == 0) {
+        budget.ioThreads = DEFAULT_BUDGET_IO_THREADS;
+    }
+
+    // Without a configured split FFmpeg keeps its own threading; 0 adds no `-threads`
+    budget.codecThreads = budgetConfig.value("codec_threads", 0u);
+    const bool splitConfigured = budgetConfig.value("total_cores", 0u) > 0 ||
+                                 budgetConfig.value("inference_workers", 0u) > 0;
+    if (budget.codecThreads == 0 && splitConfigured) {
+        budget.codecThreads = std::max(budget.totalCores - budget.inferenceWorkers, 1u);
+    }
+
+    return budget;
+}
+
+CommandCassetteConfig ConfigManager::getCommandCassette() const {
+    auto cassetteConfig =
+        getConfigValue<nlohmann::json>("command_cassette", nlohmann::json::object());
+
+    static const std::unordered_map<std::string, CassetteMode> modes = {
+        {"off", CassetteMode::Off},
+        {"record", CassetteMode::Record},
+        {"replay", CassetteMode::Replay},
+        {"auto", CassetteMode::Auto}};
+
+    const std::string mode = cassetteConfig.value("mode", "off");
+    auto it = modes.find(mode);
+    if (it == modes.end()) {
+        throw std::runtime_error(fmt::format("Unknown command cassette mode '{}'.", mode));
+    }
+
+    CommandCassetteConfig config;
+    config.mode = it->second;
+    config.path = cassetteConfig.value("path", "");
+    config.rootPath = cassetteConfig.value("root", ".");
+    return config;
+}
+
+LoadSheddingConfig ConfigManager::getLoadShedding() const {
+    auto sheddingConfig =
+        getConfigValue<nlohmann::json>("load_shedding", nlohmann::json::object());
+
+    static const std::unordered_map<std::string, SheddingPolicy> policies = {
+        {"off", SheddingPolicy::Off},
+        {"reject", SheddingPolicy::Reject},
+        {"degrade", SheddingPolicy::Degrade}};
+    static const std::unordered_map<std::string, QualityTier> tiers = {
+        {"fast", QualityTier::Fast}, {"preview", QualityTier::Preview}};
+
+    const std::string policy = sheddingConfig.value("policy", "off");
+    auto policyIt = policies.find(policy);
+    if (policyIt == policies.end()) {
+        throw std::runtime_error(fmt::format("Unknown load shedding policy '{}'.", policy));
+    }
+    const std::string tier = sheddingConfig.value("degrade_to", "preview");
+    auto tierIt = tiers.find(tier);
+    if (tierIt == tiers.end()) {
+        throw std::runtime_error(fmt::format("Unknown quality tier '{}'.", tier));
+    }
+
+    LoadSheddingConfig config;
+    config.policy = policyIt->second;
+    config.maxQueueWait = std::chrono::seconds(sheddingConfig.value("max_queue_wait_seconds", 0u));
+    config.degradeTier = tierIt->second;
+    config.fastModelPath = sheddingConfig.value("fast_model_path", "");
+    config.fastInferenceFactor =
+        sheddingConfig.value("fast_inference_factor", config.fastInferenceFactor);
+    config.previewSeconds = sheddingConfig.value("preview_seconds", config.previewSeconds);
+
+    if (config.policy == SheddingPolicy::Degrade && config.degradeTier == QualityTier::Fast &&
+        config.fastModelPath.empty()) {
+        throw std::runtime_error("Degrading to the fast tier requires a fast_model_path.");
+    }
+    return config;
+}
+
+std::vector<Rendition> ConfigManager::getRenditions() const {
+    auto renditionsConfig = getConfigValue<nlohmann::json>("renditions", nlohmann::json::array());
+
+    std::vector<Rendition> renditions;
+    for (const auto& entry : renditionsConfig) {
+        Rendition rendition;
+        try {
+            rendition.name = entry.at("name").get<std::string>();
+            rendition.codec = entry.at("codec").get<std::string>();
+            rendition.extension = entry.at("extension").get<std::string>();
+            rendition.bitrate = entry.value("bitrate", "");
+            rendition.sampleRate = entry.value("sample_rate", 0u);
+            rendition.channels = entry.value("channels", 0u);
+        } catch (const nlohmann::json::exception& e) {
+            throw std::runtime_error("Invalid rendition in config: " + std::string(e.what()));
+        }
+        renditions.push_back(std::move(rendition));
+    }
+    return renditions;
+}
+
+SpeechSegmentConfig ConfigManager::getSpeechSegmentConfig() const {
+    auto speechConfig =
+        getConfigValue<nlohmann::json>("speech_segments", nlohmann::json::object());
+
+    SpeechSegmentConfig config;
+    config.enabled = speechConfig.value("enabled", config.enabled);
+    config.lsnrThresholdDb = speechConfig.value("lsnr_threshold_db", config.lsnrThresholdDb);
+    config.energyFloorDb = speechConfig.value("energy_floor_db", config.energyFloorDb);
+    config.minSpeechSeconds = speechConfig.value("min_speech_seconds", config.minSpeechSeconds);
+    config.minGapSeconds = speechConfig.value("min_gap_seconds", config.minGapSeconds);
+    return config;
+}
+
+std::map<std::string, double> ConfigManager::getTenantWeights() const {
+    auto weights = getConfigValue<std::map<std::string, double>>("tenant_weights", {});
+    for (const auto& [tenant, weight] : weights) {
+        if (weight <= 0.0) {
+            throw std::runtime_error("Weight of tenant '" + tenant + "' must be positive.");
+        }
+    }
+    return weights;
+}
+
+HttpServerConfig ConfigManager::getHttpServerConfig() const {
+    auto serverConfig = getConfigValue<nlohmann::json>("http_server", nlohmann::json::object());
+
+    HttpServerConfig config;
+    config.listen = serverConfig.value("listen", DEFAULT_HTTP_LISTEN);
+    config.connectionThreads =
+        std::max(serverConfig.value("connection_threads", DEFAULT_HTTP_CONNECTION_THREADS), 1u);
+    config.maxUploadBytes = serverConfig.value("max_upload_mb", uint64_t{0}) * 1024 * 1024;
+    config.uploadsPath = getConfigValue<std::string>("uploads_path", "uploads");
+    return config;
+}
+
+PcmStreamConfig ConfigManager::getPcmStreamConfig() const {
+    auto streamConfig = getConfigValue<nlohmann::json>("pcm_stream", nlohmann::json::object());
+
+    PcmStreamConfig config;
+    config.socketPath = streamConfig.value("socket", "");
+    config.maxSessions =
+        std::max(streamConfig.value("max_sessions", DEFAULT_PCM_STREAM_MAX_SESSIONS), 1u);
+    config.ringSeconds = streamConfig.value("ring_seconds", DEFAULT_PCM_RING_SECONDS);
+    if (config.ringSeconds <= 0.0) {
+        throw std::runtime_error(fmt::format(
+            "pcm_stream.ring_seconds {} is not valid. It must be positive", config.ringSeconds));
+    }
+    return config;
+}
+
+WatchFolderConfig ConfigManager::getWatchFolderConfig() const {
+    auto watchConfig = getConfigValue<nlohmann::json>("watch_folder", nlohmann::json::object());
+
+    WatchFolderConfig config;
+    for (const std::string& directory :
+         watchConfig.value("directories", std::vector<std::string>{})) {
+        config.directories.push_back(directory);
+    }
+    config.outputPath = watchConfig.value("output_path", DEFAULT_WATCH_OUTPUT_PATH);
+    config.batchWindow = std::chrono::milliseconds(
+        watchConfig.value("batch_window_ms", DEFAULT_WATCH_BATCH_WINDOW_MS));
+
+    const fs::path outputPath = fs::weakly_canonical(config.outputPath);
+    for (const fs::path& directory : config.directories) {
+        if (fs::weakly_canonical(directory) == outputPath) {
+            throw std::runtime_error(
+                fmt::format("watch_folder.output_path {} must not be a watched directory.",
+                            directory.string()));
+        }
+    }
+    return config;
+}
+
 unsigned int ConfigManager::getNumThreadsValue() {
     if (!getConfigValue<bool>("use_thread_cap")) {
         return 0;
@@ -1,13 +1,123 @@
 #ifndef CONFIGMANAGER_H
 #define CONFIGMANAGER_H
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <map>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
 
 namespace fs = std::filesystem;
 namespace MediaProcessor {
 
+constexpr unsigned int DEFAULT_CHUNK_MAX_ATTEMPTS = 3;
+constexpr const char* DEFAULT_COST_MODEL_PATH = "cost_model.json";
+constexpr unsigned int DEFAULT_MAX_CONCURRENT_JOBS = 1;
+constexpr unsigned int DEFAULT_BUDGET_IO_THREADS = 2;
+constexpr unsigned int DEFAULT_FILTER_STATE_MB = 64;
+constexpr int MAX_REALTIME_PRIORITY = 99;  // highest SCHED_FIFO priority on Linux
+constexpr unsigned int MAX_REALTIME_SPIN_MICROSECONDS = 100;
+constexpr const char* DEFAULT_HTTP_LISTEN = "127.0.0.1:8090";
+constexpr unsigned int DEFAULT_HTTP_CONNECTION_THREADS = 4;
+constexpr unsigned int DEFAULT_PCM_STREAM_MAX_SESSIONS = 4;
+constexpr double DEFAULT_PCM_RING_SECONDS = 1.0;
+constexpr const char* DEFAULT_WATCH_OUTPUT_PATH = "processed";
+constexpr unsigned int DEFAULT_WATCH_BATCH_WINDOW_MS = 500;
+
+/**
+ * @brief How the cores of the host are split between the parts of the pipeline.
+ */
+struct ResourceBudget {
+    unsigned int totalCores;                 // cores the process may keep busy
+    unsigned int inferenceWorkers;           // DeepFilterNet and in-process PCM workers, at most
+    unsigned int minInferenceWorkers;        // kept while idle; more start with the queue depth
+    unsigned int ioThreads;                  // threads for blocking file I/O
+    unsigned int codecThreads;               // `-threads` of every FFmpeg child, 0 for its own
+    std::chrono::seconds workerIdleTimeout;  // retires extra workers, frees idle DFStates
+    std::chrono::microseconds workerSpinTime;   // an idle worker busy-polls this long,
+    std::chrono::microseconds workerYieldTime;  // then yields this long before it sleeps
+    int inferencePriority;                      // SCHED_FIFO priority of inference workers
+};
+
+enum class CassetteMode { Off, Record, Replay, Auto };
+
+/**
+ * @brief Where commands are recorded to or replayed from instead of only being executed.
+ */
+struct CommandCassetteConfig {
+    CassetteMode mode = CassetteMode::Off;
+    fs::path path;      // cassette directory
+    fs::path rootPath;  // paths below it are stored relative, so cassettes are portable
+};
+
+/**
+ * @brief One deliverable encoding of the processed audio.
+ */
+struct Rendition {
+    std::string name;             // appended to the output file name
+    std::string codec;            // FFmpeg encoder, e.g. "aac", "libopus" or "pcm_s16le"
+    std::string bitrate;          // e.g. "128k"; empty for the encoder's default
+    unsigned int sampleRate = 0;  // 0 keeps the processed rate
+    unsigned int channels = 0;    // 0 keeps the processed layout
+    std::string extension;        // selects the container
+};
+
+enum class SheddingPolicy { Off, Reject, Degrade };
+enum class QualityTier { Full, Fast, Preview };
+
+/**
+ * @brief What a batch does with queued jobs whose estimated queue wait exceeds the limit.
+ */
+struct LoadSheddingConfig {
+    SheddingPolicy policy = SheddingPolicy::Off;
+    std::chrono::seconds maxQueueWait{0};            // zero disables shedding
+    QualityTier degradeTier = QualityTier::Preview;  // what Degrade downgrades to
+    fs::path fastModelPath;                          // DeepFilterNet model of the fast tier
+    double fastInferenceFactor = 0.5;                // its inference time relative to the full
+    double previewSeconds = 30.0;                    // only this much is processed in a preview
+};
+
+/**
+ * @brief Thresholds for the speech segments detected during filtering.
+ */
+struct SpeechSegmentConfig {
+    bool enabled = false;
+    float lsnrThresholdDb = 5.0f;    // DeepFilterNet's local SNR estimate a speech frame exceeds
+    float energyFloorDb = -50.0f;    // filtered frame level below which a frame is silence
+    double minSpeechSeconds = 0.25;  // shorter segments are dropped
+    double minGapSeconds = 0.3;      // shorter pauses do not end a segment
+};
+
+/**
+ * @brief Settings of the HTTP front end started with `--serve`.
+ */
+struct HttpServerConfig {
+    std::string listen;              // `<host>:<port>` or a port on 127.0.0.1
+    unsigned int connectionThreads;  // uploads and downloads served at once
+    uint64_t maxUploadBytes;         // 0 accepts uploads of any size
+    fs::path uploadsPath;            // where uploads and their outputs are kept
+};
+
+/**
+ * @brief Settings of the shared-memory PCM stream started with `--serve`.
+ */
+struct PcmStreamConfig {
+    fs::path socketPath;       // Unix socket sessions are opened on; empty disables the stream
+    unsigned int maxSessions;  // sessions filtered at once, each holding a DFState
+    double ringSeconds;        // audio each session's input and output ring holds
+};
+
+/**
+ * @brief Settings of the watch-folder ingest started with `--watch`.
+ */
+struct WatchFolderConfig {
+    std::vector<fs::path> directories;      // inboxes; files written into them are processed
+    fs::path outputPath;                    // where outputs and processed inputs are moved
+    std::chrono::milliseconds batchWindow;  // quiet time after the last arrival of a batch
+};
+
 /**
  * @brief Manages configuration settings for the application.
  */
@@ -47,6 +157,151 @@ class ConfigManager {
      */
     unsigned int getOptimalThreadCount();
 
+    /**
+     * @brief Gets the resource budget from the optional `resource_budget` object.
+     *
+     * Unset or zero entries are derived: `total_cores` from getOptimalThreadCount(),
+     * `inference_workers` from the total, `io_threads` from DEFAULT_BUDGET_IO_THREADS and
+     * `codec_threads` from the cores left to FFmpeg after inference (at least 1). Inference
+     * workers are capped at the total and at the DFStates (`filter_state_mb` each, default
+     * DEFAULT_FILTER_STATE_MB) fitting into `memory_budget_mb`, if set.
+     *
+     * `min_inference_workers` defaults to a fixed pool of `inference_workers`; a zero
+     * `worker_idle_seconds` never shrinks the pool.
+     *
+     * For real-time use, idle inference workers can poll for `worker_spin_microseconds` and
+     * then `worker_yield_microseconds` before sleeping, and run with `inference_realtime_priority`
+     * (1-99, SCHED_FIFO). All default to 0: sleep at once, regular scheduling.
+     *
+     * A SCHED_FIFO worker only gives up its core by blocking; sched_yield() hands it to other
+     * realtime threads at most, so polling starves the reactor, the IO pool and FFmpeg on it.
+     * With a realtime priority the yield phase must therefore be 0 and the spin phase at most
+     * MAX_REALTIME_SPIN_MICROSECONDS.
+     *
+     * @throws std::runtime_error if the realtime priority is outside [0, 99], or is combined
+     *         with a yield phase or a longer spin.
+     */
+    ResourceBudget getResourceBudget();
+
+    /**
+     * @brief Gets how many times a chunk is filtered before it is reported as failed.
+     *
+     * Every retry runs on a fresh DFState. Falls back to DEFAULT_CHUNK_MAX_ATTEMPTS when
+     * `chunk_max_attempts` is not configured, and never returns less than 1.
+     */
+    unsigned int getChunkMaxAttempts() const;
+
+    /**
+     * @brief Gets the watchdog deadline of a processing stage from `stage_timeouts`.
+     *
+     * The deadline runs from the start of the stage. The chunk stages overlap, so each of
+     * "split_audio", "filter_chunks" and "merge_chunks" starts with its first chunk.
+     *
+     * @param stageName Stage key, e.g. "extract_audio", "filter_chunks" or "merge_media".
+     * @return The stage timeout, or zero if the stage has no deadline configured.
+     */
+    std::chrono::seconds getStageTimeout(const std::string& stageName) const;
+
+    /**
+     * @brief Gets where the host's calibrated cost model is kept (`cost_model_path`).
+     */
+    fs::path getCostModelPath() const;
+
+    /**
+     * @brief Gets where the worker pool's size over time is written after a batch
+     *        (`pool_metrics_path`); empty if it is not recorded.
+     */
+    fs::path getPoolMetricsPath() const;
+
+    /**
+     * @brief Gets where Prometheus metrics are served while a batch runs (`metrics_endpoint`):
+     *        `unix:<path>`, `<host>:<port>` or a port on 127.0.0.1; empty if they are not.
+     */
+    std::string getMetricsEndpoint() const;
+
+    /**
+     * @brief Gets how many scheduled jobs may run at once on the shared runtime.
+     *
+     * Falls back to DEFAULT_MAX_CONCURRENT_JOBS and never returns less than 1.
+     */
+    unsigned int getMaxConcurrentJobs() const;
+
+    /**
+     * @brief Gets the admission limit on a job's predicted wall time.
+     *
+     * @return The limit, or zero if every job is admitted.
+     */
+    std::chrono::seconds getMaxJobSeconds() const;
+
+    /**
+     * @brief Gets the optional `command_cassette` settings.
+     *
+     * `mode` is one of "off" (default), "record", "replay" or "auto" (replay what is recorded,
+     * record the rest); `root` defaults to the working directory.
+     *
+     * @throws std::runtime_error if the mode is unknown.
+     */
+    CommandCassetteConfig getCommandCassette() const;
+
+    /**
+     * @brief Gets the optional `load_shedding` settings.
+     *
+     * `policy` is one of "off" (default), "reject" or "degrade"; `degrade_to` is "fast" or
+     * "preview" (default).
+     *
+     * @throws std::runtime_error if the policy or tier is unknown, or the fast tier has no
+     *         `fast_model_path`.
+     */
+    LoadSheddingConfig getLoadShedding() const;
+
+    /**
+     * @brief Gets the optional `renditions` list the processed audio is delivered in.
+     *
+     * @throws std::runtime_error if an entry lacks its name, codec or extension.
+     */
+    std::vector<Rendition> getRenditions() const;
+
+    /**
+     * @brief Reads the optional `speech_segments` settings; detection is off without them.
+     */
+    SpeechSegmentConfig getSpeechSegmentConfig() const;
+
+    /**
+     * @brief Gets the optional `tenant_weights`, each tenant's share of the inference workers.
+     *
+     * @throws std::runtime_error if a weight is not positive.
+     */
+    std::map<std::string, double> getTenantWeights() const;
+
+    /**
+     * @brief Gets the optional `http_server` settings and the `uploads_path` it serves.
+     *
+     * `listen` defaults to DEFAULT_HTTP_LISTEN, `connection_threads` to
+     * DEFAULT_HTTP_CONNECTION_THREADS (at least 1) and `max_upload_mb` to 0, no limit.
+     */
+    HttpServerConfig getHttpServerConfig() const;
+
+    /**
+     * @brief Gets the optional `pcm_stream` settings.
+     *
+     * `socket` defaults to empty, `max_sessions` to DEFAULT_PCM_STREAM_MAX_SESSIONS (at least 1)
+     * and `ring_seconds` to DEFAULT_PCM_RING_SECONDS.
+     *
+     * @throws std::runtime_error if `ring_seconds` is not positive.
+     */
+    PcmStreamConfig getPcmStreamConfig() const;
+
+    /**
+     * @brief Gets the optional `watch_folder` settings.
+     *
+     * `directories` defaults to none, `output_path` to DEFAULT_WATCH_OUTPUT_PATH and
+     * `batch_window_ms` to DEFAULT_WATCH_BATCH_WINDOW_MS.
+     *
+     * @throws std::runtime_error if `output_path` is one of the watched directories, whose
+     *         outputs would be picked up again.
+     */
+    WatchFolderConfig getWatchFolderConfig() const;
+
    private:
     /**
      * @brief Gets the number of threads specified in the configuration.
@@ -0,0 +1,224 @@
+#include "CostModel.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "Metrics.h"
+
+namespace MediaProcessor {
+
+double CostEstimate::getTotalSeconds() const {
+    return decodeSeconds + inferenceSeconds + encodeSeconds + muxSeconds + overheadSeconds;
+}
+
+double CostEstimate::getStageSeconds(JobStage stage) const {
+    switch (stage) {
+        case JobStage::Decode:
+            return decodeSeconds;
+        case JobStage::Inference:
+            return inferenceSeconds;
+        case JobStage::Encode:
+            return encodeSeconds;
+        case JobStage::Mux:
+            return muxSeconds;
+    }
+    return 0.0;
+}
+
+CostModel::CostModel(double smoothing) : m_smoothing(std::clamp(smoothing, 0.0, 1.0)) {}
+
+CostEstimate CostModel::predict(const JobFeatures& features) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const double duration = std::max(features.durationSeconds, 0.0);
+    const unsigned int numWorkers = std::max(features.numWorkers, 1u);
+
+    CostEstimate estimate;
+    estimate.decodeSeconds =
+        duration * std::max(features.channels, 1u) * m_coefficients.decodeRtfPerChannel;
+    estimate.inferenceSeconds = duration * m_coefficients.inferenceRtfPerCore / numWorkers;
+    estimate.encodeSeconds = duration * m_coefficients.encodeRtf;
+    estimate.muxSeconds = features.isVideo ? duration * m_coefficients.muxRtf : 0.0;
+    estimate.overheadSeconds = m_coefficients.fixedOverheadSeconds;
+    return estimate;
+}
+
+void CostModel::update(const JobReport& report) {
+    const double duration = report.features.durationSeconds;
+    if (duration <= 0.0 || report.wallSeconds <= 0.0) {
+        return;  // nothing to learn from
+    }
+
+    const StageTimes& times = report.stageTimes;
+    const unsigned int numWorkers = std::max(report.features.numWorkers, 1u);
+
+    // Whatever the stage model does not explain is overhead
+    double explainedSeconds = times.decodeSeconds + times.inferenceCoreSeconds / numWorkers +
+                              times.encodeSeconds + times.muxSeconds;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const double weight = m_numObservations == 0 ? 1.0 : m_smoothing;
+    auto blend = [weight](double& current, double sample) {
+        current += weight * (sample - current);
+    };
+    blend(m_coefficients.decodeRtfPerChannel,
+          times.decodeSeconds / (duration * std::max(report.features.channels, 1u)));
+    blend(m_coefficients.inferenceRtfPerCore, times.inferenceCoreSeconds / duration);
+    blend(m_coefficients.encodeRtf, times.encodeSeconds / duration);
+    if (report.features.isVideo) {
+        blend(m_coefficients.muxRtf, times.muxSeconds / duration);
+    }
+    blend(m_coefficients.fixedOverheadSeconds,
+          std::max(report.wallSeconds - explainedSeconds, 0.0));
+    m_numObservations++;
+}
+
+void CostModel::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_coefficients = CostCoefficients();
+    m_numObservations = 0;
+}
+
+CostCoefficients CostModel::getCoefficients() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_coefficients;
+}
+
+unsigned int CostModel::getNumObservations() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numObservations;
+}
+
+bool CostModel::load(const fs::path& modelPath) {
+    std::ifstream modelFile(modelPath);
+    if (!modelFile.is_open()) {
+        return false;
+    }
+
+    try {
+        nlohmann::json model = nlohmann::json::parse(modelFile);
+        CostCoefficients coefficients;
+        coefficients.decodeRtfPerChannel = model.at("decode_rtf_per_channel").get<double>();
+        coefficients.inferenceRtfPerCore = model.at("inference_rtf_per_core").get<double>();
+        coefficients.encodeRtf = model.at("encode_rtf").get<double>();
+        coefficients.muxRtf = model.at("mux_rtf").get<double>();
+        coefficients.fixedOverheadSeconds = model.at("fixed_overhead_seconds").get<double>();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_coefficients = coefficients;
+        m_numObservations = model.at("observations").get<unsigned int>();
+    } catch (const nlohmann::json::exception& e) {
+        std::cerr << "Warning: Ignoring unreadable cost model " << modelPath << ": " << e.what()
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CostModel::save(const fs::path& modelPath) const {
+    nlohmann::json model;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        model = {{"decode_rtf_per_channel", m_coefficients.decodeRtfPerChannel},
+                 {"inference_rtf_per_core", m_coefficients.inferenceRtfPerCore},
+                 {"encode_rtf", m_coefficients.encodeRtf},
+                 {"mux_rtf", m_coefficients.muxRtf},
+                 {"fixed_overhead_seconds", m_coefficients.fixedOverheadSeconds},
+                 {"observations", m_numObservations}};
+    }
+
+    // Write and rename so concurrent readers never see a partial model
+    fs::path partialPath = modelPath;
+    partialPath += ".partial";
+    {
+        std::ofstream modelFile(partialPath);
+        if (!(modelFile << model.dump(4))) {
+            std::cerr << "Error: Could not write cost model: " << modelPath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(partialPath, modelPath, ec);
+    return !ec;
+}
+
+EtaTracker::EtaTracker(const CostEstimate& estimate)
+    : m_totalSeconds(estimate.getTotalSeconds() - estimate.overheadSeconds),
+      m_start(Clock::now()),
+      m_completedSeconds(0.0) {}
+
+void EtaTracker::complete(double predictedSeconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_completedSeconds = std::min(m_completedSeconds + predictedSeconds, m_totalSeconds);
+}
+
+double EtaTracker::getFractionDone() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_totalSeconds > 0.0 ? m_completedSeconds / m_totalSeconds : 1.0;
+}
+
+double EtaTracker::getRemainingSeconds() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    double remainingPredicted = std::max(m_totalSeconds - m_completedSeconds, 0.0);
+    double elapsed = std::chrono::duration<double>(Clock::now() - m_start).count();
+
+    // Until enough work is done to judge the pace, trust the prediction
+    if (m_completedSeconds <= 0.0 || elapsed <= 0.0) {
+        return remainingPredicted;
+    }
+    return remainingPredicted * (elapsed / m_completedSeconds);
+}
+
+JobProgress::JobProgress(std::string jobName, const CostEstimate& estimate)
+    : m_jobName(std::move(jobName)), m_estimate(estimate), m_etaTracker(estimate) {}
+
+void JobProgress::completeStep(JobStage stage, double elapsedSeconds, double share,
+                               const std::string& stepName) {
+    Metrics::getInstance().observeStep(stage, elapsedSeconds);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        switch (stage) {
+            case JobStage::Decode:
+                m_stageTimes.decodeSeconds += elapsedSeconds;
+                break;
+            case JobStage::Inference:
+                m_stageTimes.inferenceCoreSeconds += elapsedSeconds;
+                break;
+            case JobStage::Encode:
+                m_stageTimes.encodeSeconds += elapsedSeconds;
+                break;
+            case JobStage::Mux:
+                m_stageTimes.muxSeconds += elapsedSeconds;
+                break;
+        }
+    }
+
+    if (share <= 0.0) {
+        return;
+    }
+    m_etaTracker.complete(m_estimate.getStageSeconds(stage) * share);
+
+    // One write per line so concurrent steps and jobs do not interleave
+    std::ostringstream line;
+    line << "PROGRESS: " << m_jobName << " " << std::fixed << std::setprecision(1)
+         << m_etaTracker.getFractionDone() * 100.0 << "% ETA "
+         << m_etaTracker.getRemainingSeconds() << "s (" << stepName << ")\n";
+    std::cout << line.str() << std::flush;
+}
+
+StageTimes JobProgress::getStageTimes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stageTimes;
+}
+
+double JobProgress::getRemainingSeconds() const {
+    return m_etaTracker.getRemainingSeconds();
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,179 @@
+#ifndef COSTMODEL_H
+#define COSTMODEL_H
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr double DEFAULT_COST_MODEL_SMOOTHING = 0.2;
+
+/**
+ * @brief Real-time factors (processing seconds per second of audio) of the pipeline stages.
+ */
+struct CostCoefficients {
+    double decodeRtfPerChannel = 0.01;  // extraction and splitting, per input channel
+    double inferenceRtfPerCore = 0.3;   // DeepFilterNet, in core-seconds
+    double encodeRtf = 0.02;            // crossfading and reassembly
+    double muxRtf = 0.05;               // merging the vocals back into a video
+    double fixedOverheadSeconds = 1.0;  // probing, model loading, scheduling
+};
+
+/**
+ * @brief What the cost model needs to know about a job before it runs.
+ */
+struct JobFeatures {
+    double durationSeconds = 0.0;
+    unsigned int channels = 1;
+    unsigned int numWorkers = 1;
+    bool isVideo = false;
+};
+
+enum class JobStage { Decode, Inference, Encode, Mux };
+
+/**
+ * @brief Predicted wall time of a job, split by stage.
+ */
+struct CostEstimate {
+    double decodeSeconds = 0.0;
+    double inferenceSeconds = 0.0;
+    double encodeSeconds = 0.0;
+    double muxSeconds = 0.0;
+    double overheadSeconds = 0.0;
+
+    double getTotalSeconds() const;
+    double getStageSeconds(JobStage stage) const;
+};
+
+/**
+ * @brief Measured time per stage, summed over all of the stage's steps.
+ *
+ * Overlapping steps count fully, so the inference time is in core-seconds.
+ */
+struct StageTimes {
+    double decodeSeconds = 0.0;
+    double inferenceCoreSeconds = 0.0;
+    double encodeSeconds = 0.0;
+    double muxSeconds = 0.0;
+};
+
+/**
+ * @brief Measurements of a completed job, fed back into the model.
+ */
+struct JobReport {
+    JobFeatures features;
+    StageTimes stageTimes;
+    double wallSeconds = 0.0;
+};
+
+/**
+ * @brief Predicts job wall time from probed media properties and corrects itself from the
+ *        reports of completed jobs.
+ *
+ * The coefficients are an exponentially weighted moving average of the observed real-time
+ * factors. An uncalibrated model (no reports yet) takes the first report at full weight, so a
+ * single benchmark run on a host is enough to calibrate it. Safe to share between jobs.
+ */
+class CostModel {
+   public:
+    explicit CostModel(double smoothing = DEFAULT_COST_MODEL_SMOOTHING);
+
+    CostEstimate predict(const JobFeatures& features) const;
+
+    /**
+     * @brief Folds a completed job's measurements into the coefficients.
+     */
+    void update(const JobReport& report);
+
+    /**
+     * @brief Drops all observations so the next report recalibrates the model.
+     */
+    void reset();
+
+    CostCoefficients getCoefficients() const;
+    unsigned int getNumObservations() const;
+
+    /**
+     * @brief Loads a model previously written by save().
+     *
+     * @return true if the file exists and could be read, false otherwise (defaults are kept).
+     */
+    bool load(const fs::path& modelPath);
+    bool save(const fs::path& modelPath) const;
+
+   private:
+    double m_smoothing;
+
+    mutable std::mutex m_mutex;
+    CostCoefficients m_coefficients;
+    unsigned int m_numObservations = 0;
+};
+
+/**
+ * @brief Turns a CostEstimate into a live ETA for one job.
+ *
+ * Completed work is reported in predicted seconds of the stage estimates (the fixed overhead is
+ * not tracked); the remaining prediction is scaled by how fast the job has actually been so
+ * far, so the ETA adapts to the current load.
+ */
+class EtaTracker {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit EtaTracker(const CostEstimate& estimate);
+
+    /**
+     * @brief Marks `predictedSeconds` worth of the estimate as done.
+     */
+    void complete(double predictedSeconds);
+
+    double getFractionDone() const;
+    double getRemainingSeconds() const;
+
+   private:
+    double m_totalSeconds;
+    Clock::time_point m_start;
+
+    mutable std::mutex m_mutex;
+    double m_completedSeconds;
+};
+
+/**
+ * @brief Collects the stage times of a running job and prints its progress and ETA.
+ *
+ * Every completed step reports its measured time and the share of its stage's estimate it
+ * covered. Steps may complete concurrently from any thread.
+ */
+class JobProgress {
+   public:
+    JobProgress(std::string jobName, const CostEstimate& estimate);
+
+    /**
+     * @brief Records a finished step and prints a `PROGRESS:` line.
+     *
+     * @param share Fraction of the stage's estimate the step accounts for; zero for steps whose
+     *        time is measured but not tracked separately in the ETA.
+     */
+    void completeStep(JobStage stage, double elapsedSeconds, double share,
+                      const std::string& stepName);
+
+    StageTimes getStageTimes() const;
+    double getRemainingSeconds() const;
+
+   private:
+    std::string m_jobName;
+    CostEstimate m_estimate;
+    EtaTracker m_etaTracker;
+
+    mutable std::mutex m_mutex;
+    StageTimes m_stageTimes;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // COSTMODEL_H
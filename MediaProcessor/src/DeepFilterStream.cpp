@@ -0,0 +1,141 @@
+#include "DeepFilterStream.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace MediaProcessor {
+
+namespace {
+
+/**
+ * @brief Finds the `config.ini` of a model directory or of the directory it was extracted to.
+ */
+fs::path findModelConfig(const fs::path& modelPath) {
+    fs::path modelDir = modelPath;
+    if (!fs::is_directory(modelPath)) {
+        modelDir = modelPath.parent_path() / modelPath.stem().stem();
+    }
+
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(modelDir, ec), end; !ec && it != end;
+         it.increment(ec)) {
+        if (it->path().filename() == "config.ini") {
+            return it->path();
+        }
+    }
+    return {};
+}
+
+/**
+ * @brief Reads the `section.key` entries of an INI file.
+ */
+std::map<std::string, std::string> readIni(const fs::path& iniPath) {
+    std::map<std::string, std::string> entries;
+    std::ifstream file(iniPath);
+    std::string line, section;
+    while (std::getline(file, line)) {
+        line.erase(0, line.find_first_not_of(" \t"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.starts_with('[') && line.ends_with(']')) {
+            section = line.substr(1, line.size() - 2);
+            continue;
+        }
+        size_t separator = line.find('=');
+        if (separator == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, separator);
+        std::string value = line.substr(separator + 1);
+        key.erase(key.find_last_not_of(" \t") + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        entries[section + "." + key] = value;
+    }
+    return entries;
+}
+
+}  // namespace
+
+size_t getModelDelay(const fs::path& modelPath, size_t hopLength) {
+    size_t fftSize = 2 * hopLength;
+    size_t lookahead = 0;
+
+    const fs::path configPath = findModelConfig(modelPath);
+    if (!configPath.empty()) {
+        auto entries = readIni(configPath);
+        auto readSize = [&entries](const std::string& name, size_t fallback) -> size_t {
+            auto it = entries.find(name);
+            try {
+                return it == entries.end() ? fallback : std::stoul(it->second);
+            } catch (const std::exception&) {
+                return fallback;
+            }
+        };
+        fftSize = std::max(readSize("df.fft_size", fftSize), hopLength);
+        // The encoder's convolutions and the deep filter each look ahead; the larger one counts
+        lookahead = std::max(readSize("deepfilternet.conv_lookahead", 0),
+                             readSize("df.df_lookahead", 0));
+    }
+    return fftSize - hopLength + lookahead * hopLength;
+}
+
+DeepFilterStream::DeepFilterStream(const fs::path& modelPath, float attenuationLimit)
+    : m_filterState(df_create(modelPath.c_str(), attenuationLimit, nullptr)),
+      m_ownsFilterState(true),
+      m_attenuationLimit(attenuationLimit) {
+    if (!m_filterState) {
+        throw std::runtime_error("Failed to load the DeepFilterNet model " + modelPath.string());
+    }
+
+    size_t frameLength = df_get_frame_length(m_filterState);
+    m_inputHop.assign(frameLength, 0.0f);
+    m_outputHop.assign(frameLength, 0.0f);
+    m_modelDelay = getModelDelay(modelPath, frameLength);
+}
+
+DeepFilterStream::DeepFilterStream(DFState* filterState, const fs::path& modelPath,
+                                   float attenuationLimit)
+    : m_filterState(filterState),
+      m_ownsFilterState(false),
+      m_attenuationLimit(attenuationLimit),
+      m_inputHop(df_get_frame_length(filterState), 0.0f),
+      m_outputHop(df_get_frame_length(filterState), 0.0f),
+      m_modelDelay(getModelDelay(modelPath, m_inputHop.size())) {}
+
+DeepFilterStream::~DeepFilterStream() {
+    if (m_ownsFilterState) {
+        df_free(m_filterState);
+    }
+}
+
+void DeepFilterStream::process(const float* input, float* output, size_t numSamples) {
+    process(input, output, numSamples, [](float, const float*) {});
+}
+
+void DeepFilterStream::setAttenuationLimit(float attenuationLimit) {
+    if (attenuationLimit != m_attenuationLimit) {
+        df_set_atten_lim(m_filterState, attenuationLimit);
+        m_attenuationLimit = attenuationLimit;
+    }
+}
+
+size_t DeepFilterStream::getHopLength() const {
+    return m_inputHop.size();
+}
+
+size_t DeepFilterStream::getLatency() const {
+    return m_inputHop.size() + m_modelDelay;
+}
+
+void DeepFilterStream::reset() {
+    std::fill(m_inputHop.begin(), m_inputHop.end(), 0.0f);
+    for (size_t i = 0; i < FILTER_STATE_FLUSH_FRAMES; ++i) {
+        df_process_frame(m_filterState, m_inputHop.data(), m_outputHop.data());
+    }
+    std::fill(m_outputHop.begin(), m_outputHop.end(), 0.0f);
+    m_hopFill = 0;
+}
+
+}  // namespace MediaProcessor
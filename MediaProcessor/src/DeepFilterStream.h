@@ -0,0 +1,155 @@
+#ifndef DEEPFILTERSTREAM_H
+#define DEEPFILTERSTREAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+
+#include "DeepFilterNetFFI.h"
+#include "WorkerContext.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr double DEEPFILTER_SAMPLE_RATE = 48000.0;  // the only rate the models are trained for
+
+/**
+ * @brief Gets the algorithmic delay of the DeepFilterNet model at `modelPath`, in samples.
+ *
+ * That is the overlap of its STFT window plus its lookahead in hops, the delay
+ * `deep-filter --compensate-delay` removes. libdf's C API does not expose them, so they are
+ * read from the model's `config.ini`: in `modelPath` if it is a directory, otherwise below the
+ * directory the `<name>.tar.gz` archive was extracted to, `<name>/`. Without one, the model is
+ * taken to use DeepFilterNet's default window of two hops and no lookahead.
+ *
+ * @param hopLength The model's hop, df_get_frame_length().
+ */
+size_t getModelDelay(const fs::path& modelPath, size_t hopLength);
+
+/**
+ * @brief Filters a mono 48 kHz stream arriving in blocks of any size with one DFState.
+ *
+ * DeepFilterNet consumes hops of df_get_frame_length() samples. Incoming samples are collected
+ * into a hop and handed back filtered one hop later, and the model delays them further by
+ * getModelDelay(), so the stream adds exactly getLatency() samples of delay. This is the one hop
+ * loop of the project: invokeDeepFilterFFI drives it over a chunk file with a worker's DFState,
+ * the LV2 plugin and PcmStreamServer over live audio. Nothing is allocated after construction,
+ * which makes it usable from an audio callback.
+ */
+class DeepFilterStream {
+   public:
+    /**
+     * @throws std::runtime_error if the model at `modelPath` cannot be loaded.
+     */
+    DeepFilterStream(const fs::path& modelPath, float attenuationLimit);
+
+    /**
+     * @brief Filters with a state the caller owns, e.g. a worker's long-lived one. It must
+     *        outlive the stream and currently use `attenuationLimit`.
+     *
+     * @param modelPath The model the state was created from, for its delay.
+     */
+    DeepFilterStream(DFState* filterState, const fs::path& modelPath, float attenuationLimit);
+    ~DeepFilterStream();
+
+    DeepFilterStream(const DeepFilterStream&) = delete;
+    DeepFilterStream& operator=(const DeepFilterStream&) = delete;
+
+    /**
+     * @brief Filters `numSamples` samples; `input` and `output` may be the same buffer.
+     */
+    void process(const float* input, float* output, size_t numSamples);
+
+    /**
+     * @brief As process(), calling `onHop(lsnr, filteredHop)` whenever the model filtered a
+     *        hop, with the hop's local SNR estimate and its getHopLength() filtered samples.
+     */
+    template <typename OnHop>
+    void process(const float* input, float* output, size_t numSamples, OnHop&& onHop);
+
+    /**
+     * @brief Pads the partial hop with silence and writes the getLatency() filtered samples
+     *        still owed to `output`, so every input sample has come out. Call reset() before
+     *        streaming on.
+     */
+    template <typename OnHop>
+    void flush(float* output, OnHop&& onHop);
+
+    /**
+     * @brief Changes the attenuation limit in dB; the model is only updated on a change.
+     */
+    void setAttenuationLimit(float attenuationLimit);
+
+    /**
+     * @brief Gets the number of samples the model filters at a time.
+     */
+    size_t getHopLength() const;
+
+    /**
+     * @brief Delay between a sample going in and its filtered version coming out, in samples:
+     *        one hop of buffering plus the model's algorithmic delay.
+     */
+    size_t getLatency() const;
+
+    /**
+     * @brief Drops buffered samples and flushes the model's delay lines with silence, so the
+     *        next block starts like a fresh stream.
+     */
+    void reset();
+
+   private:
+    /**
+     * @brief The hop loop; a null `input` stands for silence.
+     */
+    template <typename OnHop>
+    void processHops(const float* input, float* output, size_t numSamples, OnHop& onHop);
+
+    DFState* m_filterState;
+    bool m_ownsFilterState;
+    float m_attenuationLimit;
+    FrameBuffer m_inputHop;
+    FrameBuffer m_outputHop;
+    size_t m_hopFill = 0;
+    size_t m_modelDelay;
+};
+
+template <typename OnHop>
+void DeepFilterStream::process(const float* input, float* output, size_t numSamples,
+                               OnHop&& onHop) {
+    processHops(input, output, numSamples, onHop);
+}
+
+template <typename OnHop>
+void DeepFilterStream::flush(float* output, OnHop&& onHop) {
+    processHops(nullptr, output, getLatency(), onHop);
+}
+
+template <typename OnHop>
+void DeepFilterStream::processHops(const float* input, float* output, size_t numSamples,
+                                   OnHop& onHop) {
+    const size_t hopLength = m_inputHop.size();
+    size_t offset = 0;
+    while (offset < numSamples) {
+        // Take the input before handing out the previous hop, so in-place buffers work
+        size_t count = std::min(numSamples - offset, hopLength - m_hopFill);
+        if (input) {
+            std::copy_n(input + offset, count, m_inputHop.data() + m_hopFill);
+        } else {
+            std::fill_n(m_inputHop.data() + m_hopFill, count, 0.0f);
+        }
+        std::copy_n(m_outputHop.data() + m_hopFill, count, output + offset);
+        m_hopFill += count;
+        offset += count;
+
+        if (m_hopFill == hopLength) {
+            float lsnr = df_process_frame(m_filterState, m_inputHop.data(), m_outputHop.data());
+            onHop(lsnr, static_cast<const float*>(m_outputHop.data()));
+            m_hopFill = 0;
+        }
+    }
+}
+
+}  // namespace MediaProcessor
+
+#endif  // DEEPFILTERSTREAM_H
@@ -1,16 +1,20 @@
 #include "Engine.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 
 #include "AudioProcessor.h"
 #include "ConfigManager.h"
+#include "RenditionEncoder.h"
+#include "RuntimeServices.h"
 #include "Utils.h"
 #include "VideoProcessor.h"
 
 namespace MediaProcessor {
 
-Engine::Engine(const std::filesystem::path& mediaPath)
-    : m_mediaPath(std::filesystem::absolute(mediaPath)) {}
+Engine::Engine(const std::filesystem::path& mediaPath, const CancellationToken& cancellationToken)
+    : m_mediaPath(std::filesystem::absolute(mediaPath)), m_cancellationToken(cancellationToken) {}
 
 bool Engine::processMedia() {
     ConfigManager& configManager = ConfigManager::getInstance();
@@ -19,69 +23,249 @@ bool Engine::processMedia() {
         return false;
     }
 
+    // Estimate against the host's model unless the caller supplied one
+    CostModel hostCostModel;
+    const fs::path costModelPath = configManager.getCostModelPath();
+    CostModel* callerCostModel = m_costModel;
+    if (!callerCostModel) {
+        hostCostModel.load(costModelPath);
+        setCostModel(&hostCostModel);
+    }
+
+    std::unique_ptr<AsyncRuntime> runtime = createRuntime(configManager);
+    bool success = runtime && syncWait(processMediaAsync(*runtime));
+
+    if (!callerCostModel) {
+        if (hostCostModel.getNumObservations() > 0) {
+            hostCostModel.save(costModelPath);
+        }
+        setCostModel(nullptr);
+    }
+    return success;
+}
+
+void Engine::setCostModel(CostModel* costModel) {
+    m_costModel = costModel;
+}
+
+Task<bool> Engine::processMediaAsync(AsyncRuntime& runtime) {
     MediaType mediaType;
-    mediaType = TRY(getMediaType());
+    try {
+        mediaType = co_await getMediaType(runtime);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        throw;
+    }
+
+    // getMediaType() has probed successfully, so the features are known
+    m_progress.reset();
+    if (m_costModel) {
+        CostEstimate estimate = predictCost();
+        std::cout << "INFO: predicted processing time: " << estimate.getTotalSeconds() << "s."
+                  << std::endl;
+        m_progress = std::make_unique<JobProgress>(m_mediaPath.filename().string(), estimate);
+    }
 
+    auto start = std::chrono::steady_clock::now();
+    bool success = false;
     switch (mediaType) {
         case MediaType::Audio:
-            return processAudio();
+            success = co_await processAudio(runtime);
+            break;
         case MediaType::Video:
-            return processVideo();
+            success = co_await processVideo(runtime);
+            break;
         default:
             std::cerr << "Unsupported file type." << std::endl;
-            return false;
+            co_return false;
+    }
+
+    // Only complete runs with the regular model describe the host; others would skew the model
+    if (success && m_progress && m_qualityTier != QualityTier::Fast) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        m_costModel->update({getTierFeatures(), m_progress->getStageTimes(), elapsed.count()});
     }
+    co_return success;
 }
 
-bool Engine::processAudio() {
-    AudioProcessor audioProcessor(m_mediaPath, Utils::prepareAudioOutputPath(m_mediaPath));
-    if (!audioProcessor.isolateVocals()) {
+Task<bool> Engine::processAudio(AsyncRuntime& runtime) {
+    auto audioProcessor = createAudioProcessor(Utils::prepareAudioOutputPath(m_mediaPath));
+    if (!co_await audioProcessor->isolateVocalsAsync(runtime)) {
+        reportCancellation();
         std::cerr << "Failed to process audio." << std::endl;
-        return false;
+        co_return false;
+    }
+
+    if (!co_await encodeRenditions(runtime, Utils::prepareAudioOutputPath(m_mediaPath))) {
+        reportCancellation();
+        std::cerr << "Failed to encode renditions." << std::endl;
+        co_return false;
     }
-    std::cout << "Audio processed successfully: " << Utils::prepareAudioOutputPath(m_mediaPath)
-              << std::endl;
-    return true;
+    m_outputPath = Utils::prepareAudioOutputPath(m_mediaPath);
+    std::cout << "Audio processed successfully: " << m_outputPath << std::endl;
+    co_return true;
 }
 
-bool Engine::processVideo() {
+Task<bool> Engine::processVideo(AsyncRuntime& runtime) {
     auto [extractedVocalsPath, processedMediaPath] = Utils::prepareOutputPaths(m_mediaPath);
-    AudioProcessor audioProcessor(m_mediaPath, extractedVocalsPath);
-
-    if (!audioProcessor.isolateVocals()) {
+    auto audioProcessor = createAudioProcessor(extractedVocalsPath);
+    if (!co_await audioProcessor->isolateVocalsAsync(runtime)) {
+        reportCancellation();
         std::cerr << "Failed to extract vocals from video." << std::endl;
-        return false;
+        co_return false;
     }
 
-    VideoProcessor videoProcessor(m_mediaPath, extractedVocalsPath, processedMediaPath);
-    if (!videoProcessor.mergeMedia()) {
+    VideoProcessor videoProcessor(m_mediaPath, extractedVocalsPath, processedMediaPath,
+                                  m_cancellationToken);
+    videoProcessor.setProgress(m_progress.get());
+
+    // Both only read the isolated vocals, so the merge and the renditions run side by side
+    std::vector<Task<bool>> outputs;
+    outputs.push_back(videoProcessor.mergeMediaAsync(runtime));
+    outputs.push_back(encodeRenditions(runtime, extractedVocalsPath));
+    std::vector<bool> results = co_await whenAll(std::move(outputs));
+
+    if (!results[0]) {
+        reportCancellation();
         std::cerr << "Failed to merge audio and video." << std::endl;
-        return false;
+        co_return false;
+    }
+    if (!results[1]) {
+        reportCancellation();
+        std::cerr << "Failed to encode renditions." << std::endl;
+        co_return false;
     }
 
-    std::cout << "Video processed successfully: " << processedMediaPath << std::endl;
-    return true;
+    m_outputPath = processedMediaPath;
+    std::cout << "Video processed successfully: " << m_outputPath << std::endl;
+    co_return true;
 }
 
-MediaType Engine::getMediaType() const {
-    const std::string command =
-        "ffprobe -loglevel error -show_entries stream=codec_type "
-        "-of default=noprint_wrappers=1:nokey=1 \"" +
-        m_mediaPath.string() + "\"";
+Task<bool> Engine::encodeRenditions(AsyncRuntime& runtime, const fs::path& processedAudioPath) {
+    RenditionEncoder encoder(processedAudioPath, ConfigManager::getInstance().getRenditions(),
+                             m_cancellationToken);
+    encoder.setProgress(m_progress.get());
+    co_return co_await encoder.encodeAsync(runtime);
+}
 
-    std::optional<std::string> output = Utils::runCommand(command, true);
-    if (!output || output->empty()) {
+void Engine::setQualityTier(QualityTier tier) {
+    m_qualityTier = tier;
+}
+
+QualityTier Engine::getQualityTier() const {
+    return m_qualityTier;
+}
+
+void Engine::setTenant(const std::string& tenant) {
+    m_tenant = tenant;
+}
+
+const std::string& Engine::getTenant() const {
+    return m_tenant;
+}
+
+const std::filesystem::path& Engine::getOutputPath() const {
+    return m_outputPath;
+}
+
+CostEstimate Engine::predictCost() const {
+    CostEstimate estimate = m_costModel->predict(getTierFeatures());
+    if (m_qualityTier == QualityTier::Fast) {
+        LoadSheddingConfig loadShedding = ConfigManager::getInstance().getLoadShedding();
+        estimate.inferenceSeconds *= loadShedding.fastInferenceFactor;
+    }
+    return estimate;
+}
+
+JobFeatures Engine::getTierFeatures() const {
+    JobFeatures features = *m_features;
+    if (m_qualityTier == QualityTier::Preview) {
+        LoadSheddingConfig loadShedding = ConfigManager::getInstance().getLoadShedding();
+        features.durationSeconds = std::min(features.durationSeconds, loadShedding.previewSeconds);
+    }
+    return features;
+}
+
+std::unique_ptr<AudioProcessor> Engine::createAudioProcessor(
+    const std::filesystem::path& outputAudioPath) const {
+    auto audioProcessor =
+        std::make_unique<AudioProcessor>(m_mediaPath, outputAudioPath, m_cancellationToken);
+    audioProcessor->setProgress(m_progress.get());
+    audioProcessor->setTenant(m_tenant);
+
+    LoadSheddingConfig loadShedding = ConfigManager::getInstance().getLoadShedding();
+    if (m_qualityTier == QualityTier::Fast) {
+        audioProcessor->setFilterModelPath(loadShedding.fastModelPath);
+    } else if (m_qualityTier == QualityTier::Preview) {
+        audioProcessor->setPreviewDuration(loadShedding.previewSeconds);
+    }
+    return audioProcessor;
+}
+
+void Engine::reportCancellation() const {
+    if (m_cancellationToken.isCancelled()) {
+        std::cerr << "Processing cancelled: " << m_cancellationToken.getReason() << std::endl;
+    }
+}
+
+Task<MediaType> Engine::getMediaType(AsyncRuntime& runtime) {
+    std::optional<JobFeatures> features = co_await probe(runtime);
+    if (!features) {
         throw std::runtime_error("Failed to detect media type.");
     }
 
-    std::string_view result = *output;
-    if (result.find("video") != std::string_view::npos) {
-        return MediaType::Video;
-    } else if (result.find("audio") != std::string_view::npos) {
-        return MediaType::Audio;
+    if (features->isVideo) {
+        co_return MediaType::Video;
+    } else if (features->channels > 0) {
+        co_return MediaType::Audio;
     } else {
         throw std::runtime_error("Unsupported media type detected.");
     }
 }
 
+Task<std::optional<JobFeatures>> Engine::probe(AsyncRuntime& runtime) {
+    if (m_features) {
+        co_return m_features;
+    }
+
+    const std::string command =
+        "ffprobe -loglevel error -show_entries stream=codec_type,channels:format=duration "
+        "-of json \"" +
+        m_mediaPath.string() + "\"";
+
+    std::optional<std::string> output =
+        co_await runtime.runCommandCapture(command, m_cancellationToken);
+    if (!output || output->empty()) {
+        co_return std::nullopt;
+    }
+
+    JobFeatures features;
+    features.channels = 0;  // until an audio stream shows up
+    features.numWorkers =
+        std::min<unsigned int>(ConfigManager::getInstance().getResourceBudget().inferenceWorkers,
+                               runtime.getWorkers().maxSize());
+
+    try {
+        nlohmann::json probeResult = nlohmann::json::parse(*output);
+        for (const auto& stream : probeResult.value("streams", nlohmann::json::array())) {
+            const std::string codecType = stream.value("codec_type", "");
+            if (codecType == "video") {
+                features.isVideo = true;
+            } else if (codecType == "audio") {
+                features.channels = std::max(features.channels, stream.value("channels", 1u));
+            }
+        }
+        // FFprobe reports the duration as a string
+        features.durationSeconds =
+            std::stod(probeResult.at("format").at("duration").get<std::string>());
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Could not parse probe result of " << m_mediaPath << ": " << e.what()
+                  << std::endl;
+        co_return std::nullopt;
+    }
+
+    m_features = features;
+    co_return m_features;
+}
+
 }  // namespace MediaProcessor
@@ -2,6 +2,15 @@
 #define ENGINE_H
 
 #include <filesystem>
+#include <memory>
+#include <optional>
+
+#include "AsyncRuntime.h"
+#include "AsyncTask.h"
+#include "AudioProcessor.h"
+#include "CancellationToken.h"
+#include "ConfigManager.h"
+#include "CostModel.h"
 
 namespace MediaProcessor {
 
@@ -12,34 +21,110 @@ enum class MediaType { Audio, Video, Unsupported };
  */
 class Engine {
    public:
-    explicit Engine(const std::filesystem::path& mediaPath);
+    /**
+     * @param cancellationToken Cancelling it stops the running stage, kills its child
+     *        processes and makes processMedia() return false.
+     */
+    explicit Engine(const std::filesystem::path& mediaPath,
+                    const CancellationToken& cancellationToken = CancellationToken());
 
     /**
      * @brief Processes a media file (audio or video) to isolate vocals.
      *
      * Processes the media file located at m_mediaPath.
-     * Processing pipeline is selected dynamically by determining media type.
+     * Processing pipeline is selected dynamically by determining media type. The host's cost
+     * model is loaded from `cost_model_path` and saved back with this job's measurements.
      *
      * @return true if processing was successful, false otherwise.
      */
     bool processMedia();
 
+    /**
+     * @brief Coroutine form of processMedia() for running several jobs on one runtime.
+     *
+     * The configuration must already be loaded.
+     */
+    Task<bool> processMediaAsync(AsyncRuntime& runtime);
+
+    /**
+     * @brief Predicts the job with `costModel`, reports progress and ETA against the
+     *        prediction and feeds the measured stage times back into the model.
+     *
+     * The model must outlive processing and may be shared between engines; nullptr disables
+     * estimation.
+     */
+    void setCostModel(CostModel* costModel);
+
+    /**
+     * @brief Probes duration, audio channels and whether the file is a video.
+     *
+     * The result is cached, so a scheduler can probe ahead of processing for free.
+     *
+     * @return The job's features, or std::nullopt if the file could not be probed.
+     */
+    Task<std::optional<JobFeatures>> probe(AsyncRuntime& runtime);
+
+    /**
+     * @brief Processes the job at a lower quality tier, as configured in `load_shedding`.
+     *
+     * The fast tier filters with `fast_model_path`, a preview only processes the first
+     * `preview_seconds`.
+     */
+    void setQualityTier(QualityTier tier);
+    QualityTier getQualityTier() const;
+
+    /**
+     * @brief Predicts the job at its quality tier; the job must have been probed.
+     */
+    CostEstimate predictCost() const;
+
+    /**
+     * @brief Names the tenant the job belongs to; its chunks are filtered within the
+     *        tenant's weighted share of the workers.
+     */
+    void setTenant(const std::string& tenant);
+    const std::string& getTenant() const;
+
+    /**
+     * @brief Gets the processed file: the isolated audio of an audio job, the merged video of
+     *        a video job; empty until processing has succeeded.
+     */
+    const std::filesystem::path& getOutputPath() const;
+
    private:
     std::filesystem::path m_mediaPath;
+    CancellationToken m_cancellationToken;
+    CostModel* m_costModel = nullptr;
+    std::optional<JobFeatures> m_features;
+    std::unique_ptr<JobProgress> m_progress;
+    QualityTier m_qualityTier = QualityTier::Full;
+    std::string m_tenant = DEFAULT_TENANT;
+    std::filesystem::path m_outputPath;
+
+    /**
+     * @brief The probed features, shortened to the preview for preview jobs.
+     */
+    JobFeatures getTierFeatures() const;
+
+    /**
+     * @brief Creates an AudioProcessor set up for the job's quality tier.
+     */
+    std::unique_ptr<AudioProcessor> createAudioProcessor(
+        const std::filesystem::path& outputAudioPath) const;
 
     /**
      * @brief Processes an audio file.
      *
      * @return true if processing was successful, false otherwise.
      */
-    bool processAudio();
+    Task<bool> processAudio(AsyncRuntime& runtime);
 
     /**
      * @brief Processes a video file by extracting and isolating vocals and merges back to source.
      *
      * @return true if processing was successful, false otherwise.
      */
-    bool processVideo();
+    Task<bool> processVideo(AsyncRuntime& runtime);
 
     /**
      * @brief Detects the media type (audio or video) of the file located at m_mediaPath.
@@ -48,7 +133,20 @@ class Engine {
      *
      * @throws std::runtime_error if detection fails.
      */
-    MediaType getMediaType() const;
+    Task<MediaType> getMediaType(AsyncRuntime& runtime);
+
+    /**
+     * @brief Encodes the processed audio into the configured `renditions`, if any.
+     *
+     * @return true if every rendition was written, false otherwise.
+     */
+    Task<bool> encodeRenditions(AsyncRuntime& runtime,
+                                const std::filesystem::path& processedAudioPath);
+
+    /**
+     * @brief Logs the cancellation reason if a stage failed because the job was cancelled.
+     */
+    void reportCancellation() const;
 };
 
 }  // namespace MediaProcessor
@@ -0,0 +1,117 @@
+#include "FairScheduler.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "Metrics.h"
+
+namespace MediaProcessor {
+
+FairScheduler::Lease::Lease(FairScheduler* scheduler, std::string tenant)
+    : m_scheduler(scheduler),
+      m_tenant(std::move(tenant)),
+      m_cpuStartSeconds(getThreadCpuSeconds()) {}
+
+FairScheduler::Lease::Lease(Lease&& other) noexcept
+    : m_scheduler(std::exchange(other.m_scheduler, nullptr)),
+      m_tenant(std::move(other.m_tenant)),
+      m_cpuStartSeconds(other.m_cpuStartSeconds) {}
+
+FairScheduler::Lease::~Lease() {
+    if (m_scheduler) {
+        m_scheduler->release(m_tenant, getThreadCpuSeconds() - m_cpuStartSeconds);
+    }
+}
+
+FairScheduler::FairScheduler(ThreadPool& executor, size_t capacity)
+    : m_executor(executor), m_capacity(std::max<size_t>(capacity, 1)) {}
+
+void FairScheduler::setWeight(const std::string& tenant, double weight) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tenants[tenant].weight = weight;
+}
+
+void FairScheduler::setWeights(const std::map<std::string, double>& weights) {
+    for (const auto& [tenant, weight] : weights) {
+        setWeight(tenant, weight);
+    }
+}
+
+std::map<std::string, TenantUsage> FairScheduler::getUsage() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<std::string, TenantUsage> usage;
+    for (const auto& [name, tenant] : m_tenants) {
+        usage[name] = {tenant.weight, tenant.cpuSeconds, tenant.completedTasks,
+                       tenant.waiters.size()};
+    }
+    return usage;
+}
+
+void FairScheduler::AcquireAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    scheduler.enqueue(tenant, cost, handle);
+}
+
+FairScheduler::Lease FairScheduler::AcquireAwaiter::await_resume() {
+    return Lease(&scheduler, std::move(tenant));
+}
+
+void FairScheduler::enqueue(const std::string& tenantName, double cost,
+                            std::coroutine_handle<> handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Tenant& tenant = m_tenants[tenantName];
+    const double startTag = std::max(m_virtualTime, tenant.finishTag);
+    tenant.finishTag = startTag + cost / tenant.weight;
+
+    // With a free slot nobody is waiting, so the task is admitted right away
+    if (m_numRunning < m_capacity) {
+        admitLocked(startTag, handle);
+        return;
+    }
+    tenant.waiters.push_back({startTag, m_nextSequence++, handle});
+}
+
+void FairScheduler::release(const std::string& tenantName, double cpuSeconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Tenant& tenant = m_tenants[tenantName];
+    tenant.cpuSeconds += cpuSeconds;
+    ++tenant.completedTasks;
+    --m_numRunning;
+    Metrics::getInstance().inferenceTasksRunning.add(-1);
+
+    // Each tenant's queue is ordered by tag, so the next task is at the head of one of them
+    Tenant* next = nullptr;
+    for (auto& [name, candidate] : m_tenants) {
+        if (candidate.waiters.empty()) {
+            continue;
+        }
+        const Waiter& head = candidate.waiters.front();
+        if (!next || head.startTag < next->waiters.front().startTag ||
+            (head.startTag == next->waiters.front().startTag &&
+             head.sequence < next->waiters.front().sequence)) {
+            next = &candidate;
+        }
+    }
+
+    if (next) {
+        Waiter waiter = next->waiters.front();
+        next->waiters.pop_front();
+        admitLocked(waiter.startTag, waiter.handle);
+    }
+}
+
+void FairScheduler::admitLocked(double startTag, std::coroutine_handle<> handle) {
+    ++m_numRunning;
+    Metrics::getInstance().inferenceTasksRunning.add(1);
+    m_virtualTime = std::max(m_virtualTime, startTag);
+    m_executor.post([handle]() { handle.resume(); });
+}
+
+double FairScheduler::getThreadCpuSeconds() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,127 @@
+#ifndef FAIRSCHEDULER_H
+#define FAIRSCHEDULER_H
+
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "ThreadPool.h"
+
+namespace MediaProcessor {
+
+constexpr const char* DEFAULT_TENANT = "default";
+
+/**
+ * @brief A tenant's share and consumption of the inference workers.
+ */
+struct TenantUsage {
+    double weight = 1.0;
+    double cpuSeconds = 0.0;  // thread CPU time spent holding leases
+    size_t completedTasks = 0;
+    size_t queuedTasks = 0;
+};
+
+/**
+ * @brief Weighted fair queuing of inference tasks across tenants.
+ *
+ * At most `capacity` tasks hold a lease at once. Waiting tasks are admitted in order of their
+ * start tag (start-time fair queuing): a task's tag is the later of the current virtual time
+ * and the finish tag of its tenant's previous task, and it advances the tenant's finish tag by
+ * `cost / weight`. A tenant queueing a bulk upload thus only claims its weighted share, and a
+ * tenant arriving later is served at the next free slot instead of behind the whole backlog.
+ */
+class FairScheduler {
+   public:
+    /**
+     * @brief Held by a task while it runs; releasing it admits the next task.
+     *
+     * Records the thread CPU time between admission and release for the tenant, so it must be
+     * held across synchronous work only.
+     */
+    class Lease {
+       public:
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease();
+
+       private:
+        friend class FairScheduler;
+        Lease(FairScheduler* scheduler, std::string tenant);
+
+        FairScheduler* m_scheduler;
+        std::string m_tenant;
+        double m_cpuStartSeconds;
+    };
+
+    FairScheduler(ThreadPool& executor, size_t capacity);
+
+    FairScheduler(const FairScheduler&) = delete;
+    FairScheduler& operator=(const FairScheduler&) = delete;
+
+    /**
+     * @brief Sets a tenant's share; tenants default to a weight of 1.
+     */
+    void setWeight(const std::string& tenant, double weight);
+    void setWeights(const std::map<std::string, double>& weights);
+
+    /**
+     * @brief Awaitable that resumes the awaiting coroutine on an executor thread once the
+     *        tenant's task is admitted, yielding its Lease.
+     *
+     * @param cost Expected work of the task, in any unit used consistently by all tenants.
+     */
+    auto acquire(std::string tenant, double cost) {
+        return AcquireAwaiter{*this, std::move(tenant), cost};
+    }
+
+    std::map<std::string, TenantUsage> getUsage() const;
+
+   private:
+    struct Waiter {
+        double startTag;
+        uint64_t sequence;  // breaks ties in arrival order
+        std::coroutine_handle<> handle;
+    };
+
+    struct Tenant {
+        double weight = 1.0;
+        double finishTag = 0.0;
+        std::deque<Waiter> waiters;
+        double cpuSeconds = 0.0;
+        size_t completedTasks = 0;
+    };
+
+    struct AcquireAwaiter {
+        FairScheduler& scheduler;
+        std::string tenant;
+        double cost;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle);
+        Lease await_resume();
+    };
+
+    void enqueue(const std::string& tenant, double cost, std::coroutine_handle<> handle);
+    void release(const std::string& tenant, double cpuSeconds);
+    void admitLocked(double startTag, std::coroutine_handle<> handle);
+
+    static double getThreadCpuSeconds();
+
+    ThreadPool& m_executor;
+    size_t m_capacity;
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Tenant> m_tenants;
+    size_t m_numRunning = 0;
+    double m_virtualTime = 0.0;
+    uint64_t m_nextSequence = 0;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // FAIRSCHEDULER_H
@@ -0,0 +1,160 @@
+#include "FolderWatcher.h"
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace MediaProcessor {
+
+namespace {
+
+constexpr auto CANCELLATION_POLL_INTERVAL = std::chrono::milliseconds(200);
+constexpr size_t EVENT_BUFFER_SIZE = 16 * 1024;
+
+bool isHidden(const fs::path& path) {
+    return path.filename().string().starts_with('.');
+}
+
+}  // namespace
+
+FolderWatcher::FolderWatcher(std::vector<fs::path> directories,
+                             std::chrono::milliseconds batchWindow)
+    : m_directories(std::move(directories)), m_batchWindow(batchWindow) {}
+
+FolderWatcher::~FolderWatcher() {
+    if (m_inotifyFd != -1) {
+        close(m_inotifyFd);
+    }
+}
+
+bool FolderWatcher::start() {
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd == -1) {
+        std::cerr << "Error: Could not start inotify: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    for (const fs::path& directory : m_directories) {
+        int watch = inotify_add_watch(m_inotifyFd, directory.c_str(),
+                                      IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR);
+        if (watch == -1) {
+            std::cerr << "Error: Could not watch " << directory << ": " << std::strerror(errno)
+                      << std::endl;
+            return false;
+        }
+        m_watches[watch] = directory;
+    }
+
+    // Watches are in place first, so a file finished during the scan is not missed
+    scanDirectories();
+    return true;
+}
+
+std::vector<fs::path> FolderWatcher::waitForBatch(const CancellationToken& cancellationToken) {
+    // Every event read, and every scanned file still changing, restarts the window
+    auto lastEvent = std::chrono::steady_clock::now();
+    while (!cancellationToken.isCancelled()) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastEvent >= m_batchWindow) {
+            if (settleScannedFiles()) {
+                lastEvent = now;
+            } else if (!m_pending.empty()) {
+                std::vector<fs::path> batch(m_pending.begin(), m_pending.end());
+                m_pending.clear();
+                return batch;
+            }
+        }
+
+        auto timeout = CANCELLATION_POLL_INTERVAL;
+        if (!m_pending.empty() || !m_unsettled.empty()) {
+            timeout = std::min(timeout, std::chrono::ceil<std::chrono::milliseconds>(
+                                            lastEvent + m_batchWindow - now));
+        }
+        pollfd events{m_inotifyFd, POLLIN, 0};
+        if (poll(&events, 1, static_cast<int>(std::max<int64_t>(timeout.count(), 0))) > 0 &&
+            readEvents()) {
+            lastEvent = std::chrono::steady_clock::now();
+        }
+    }
+    return {};
+}
+
+void FolderWatcher::scanDirectories() {
+    for (const fs::path& directory : m_directories) {
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            if (entry.is_regular_file(ec) && !isHidden(entry.path()) &&
+                !m_pending.contains(entry.path())) {
+                FileSnapshot snapshot{entry.file_size(ec), entry.last_write_time(ec)};
+                m_unsettled[entry.path()] = snapshot;
+            }
+        }
+        if (ec) {
+            std::cerr << "Warning: Could not list " << directory << ": " << ec.message()
+                      << std::endl;
+        }
+    }
+}
+
+bool FolderWatcher::settleScannedFiles() {
+    bool changed = false;
+    for (auto it = m_unsettled.begin(); it != m_unsettled.end();) {
+        std::error_code ec;
+        FileSnapshot snapshot{fs::file_size(it->first, ec), fs::last_write_time(it->first, ec)};
+        if (ec) {
+            it = m_unsettled.erase(it);  // claimed or removed meanwhile
+        } else if (snapshot.size != it->second.size || snapshot.modified != it->second.modified) {
+            it->second = snapshot;
+            changed = true;
+            ++it;
+        } else {
+            m_pending.insert(it->first);
+            it = m_unsettled.erase(it);
+        }
+    }
+    return changed;
+}
+
+bool FolderWatcher::readEvents() {
+    alignas(inotify_event) char buffer[EVENT_BUFFER_SIZE];
+    bool queued = false;
+    while (true) {
+        ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            if (length < 0 && errno == EINTR) {
+                continue;
+            }
+            return queued;  // EAGAIN: the queue is drained
+        }
+
+        for (char* next = buffer; next < buffer + length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(next);
+            next += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                std::cerr << "Warning: inotify events were dropped, rescanning." << std::endl;
+                scanDirectories();
+                queued = true;
+            } else if (event->mask & IN_IGNORED) {
+                std::cerr << "Warning: " << m_watches[event->wd] << " is no longer watched."
+                          << std::endl;
+                m_watches.erase(event->wd);
+            } else if (event->len > 0 && !(event->mask & IN_ISDIR)) {
+                auto watch = m_watches.find(event->wd);
+                fs::path path = watch == m_watches.end() ? fs::path() : watch->second / event->name;
+                if (!path.empty() && !isHidden(path)) {
+                    m_unsettled.erase(path);
+                    m_pending.insert(std::move(path));
+                    queued = true;
+                }
+            }
+        }
+    }
+}
+
+}  // namespace MediaProcessor
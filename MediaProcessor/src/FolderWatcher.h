@@ -0,0 +1,87 @@
+#ifndef FOLDERWATCHER_H
+#define FOLDERWATCHER_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "CancellationToken.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+/**
+ * @brief Reports files that were completely written into a set of directories, in batches.
+ *
+ * A file is ready once the writer closes it (IN_CLOSE_WRITE) or it is moved in whole
+ * (IN_MOVED_TO), so half-written files are never reported. Events keep arriving while a batch
+ * forms; the batch is handed out once no event came for the batch window, with each path
+ * listed once however often it was rewritten. Hidden files, like partial uploads, are ignored,
+ * and subdirectories are not watched.
+ *
+ * Files already in the directories when watching starts, and all files after the kernel's
+ * event queue overflowed, may still be being written; they are taken as complete once their
+ * size and modification time held still for a batch window, or once an event reports them.
+ */
+class FolderWatcher {
+   public:
+    FolderWatcher(std::vector<fs::path> directories, std::chrono::milliseconds batchWindow);
+    ~FolderWatcher();
+
+    FolderWatcher(const FolderWatcher&) = delete;
+    FolderWatcher& operator=(const FolderWatcher&) = delete;
+
+    /**
+     * @brief Starts watching and notes the files already in the directories.
+     *
+     * @return true if every directory could be watched, false otherwise.
+     */
+    bool start();
+
+    /**
+     * @brief Blocks until a batch of ready files has settled.
+     *
+     * @return The files, sorted; empty if `cancellationToken` was cancelled first.
+     */
+    std::vector<fs::path> waitForBatch(const CancellationToken& cancellationToken);
+
+   private:
+    struct FileSnapshot {
+        uintmax_t size = 0;
+        fs::file_time_type modified;
+    };
+
+    /**
+     * @brief Notes every regular, non-hidden file in the watched directories as unsettled.
+     */
+    void scanDirectories();
+
+    /**
+     * @brief Queues the unsettled files that did not change since they were last looked at.
+     *
+     * @return true if any of them changed, so the window starts over.
+     */
+    bool settleScannedFiles();
+
+    /**
+     * @brief Reads the pending inotify events and queues the files they report.
+     *
+     * @return true if any file was queued.
+     */
+    bool readEvents();
+
+    std::vector<fs::path> m_directories;
+    std::chrono::milliseconds m_batchWindow;
+    int m_inotifyFd = -1;
+    std::map<int, fs::path> m_watches;  // watch descriptor to directory
+    std::set<fs::path> m_pending;
+    std::map<fs::path, FileSnapshot> m_unsettled;  // found by a scan, maybe still written
+};
+
+}  // namespace MediaProcessor
+
+#endif  // FOLDERWATCHER_H
@@ -0,0 +1,395 @@
+#include "HttpServer.h"
+
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+namespace MediaProcessor {
+
+namespace {
+
+constexpr int HTTP_LISTEN_BACKLOG = 64;
+constexpr int HTTP_SOCKET_TIMEOUT_SECONDS = 30;  // a client stalling longer is dropped
+constexpr size_t MAX_HEADER_SIZE = 16384;
+constexpr size_t BODY_BUFFER_SIZE = 65536;
+constexpr size_t SPLICE_CHUNK_SIZE = 1 << 20;
+constexpr size_t SENDFILE_CHUNK_SIZE = 1 << 30;
+
+/**
+ * @brief A byte range [first, last] of a file.
+ */
+struct ByteRange {
+    uint64_t first;
+    uint64_t last;
+    bool partial;  // answered with 206 rather than as the whole file
+};
+
+std::string getStatusText(int status) {
+    switch (status) {
+        case 200:
+            return "OK";
+        case 202:
+            return "Accepted";
+        case 206:
+            return "Partial Content";
+        case 400:
+            return "Bad Request";
+        case 404:
+            return "Not Found";
+        case 409:
+            return "Conflict";
+        case 411:
+            return "Length Required";
+        case 413:
+            return "Content Too Large";
+        case 416:
+            return "Range Not Satisfiable";
+        case 422:
+            return "Unprocessable Content";
+        case 500:
+            return "Internal Server Error";
+        case 503:
+            return "Service Unavailable";
+        default:
+            return "Unknown";
+    }
+}
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+        return "";
+    }
+    return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+}
+
+std::optional<uint64_t> parseNumber(std::string_view text) {
+    uint64_t value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (text.empty() || error != std::errc() || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::string buildHeader(int status, const std::string& contentType, uint64_t contentLength,
+                        const std::string& extraHeaders = "") {
+    return "HTTP/1.1 " + std::to_string(status) + " " + getStatusText(status) +
+           "\r\nContent-Type: " + contentType + "\r\nContent-Length: " +
+           std::to_string(contentLength) + "\r\n" + extraHeaders + "Connection: close\r\n\r\n";
+}
+
+/**
+ * @brief Parses a single `bytes=first-last`, `bytes=first-` or `bytes=-suffix` range.
+ *
+ * @return The range clamped to the file, std::nullopt if it cannot be satisfied. A range the
+ *         server ignores (other units, several ranges) is returned as the whole file.
+ */
+std::optional<ByteRange> parseRange(const std::string& header, uint64_t fileSize) {
+    const ByteRange wholeFile{0, fileSize - 1, false};
+    constexpr std::string_view unit = "bytes=";
+    if (!header.starts_with(unit) || header.find(',') != std::string::npos) {
+        return wholeFile;
+    }
+
+    std::string_view spec = std::string_view(header).substr(unit.size());
+    size_t dash = spec.find('-');
+    if (dash == std::string_view::npos) {
+        return wholeFile;
+    }
+    std::optional<uint64_t> first = parseNumber(trim(std::string(spec.substr(0, dash))));
+    std::optional<uint64_t> last = parseNumber(trim(std::string(spec.substr(dash + 1))));
+
+    if (!first) {
+        // A suffix range: the final `last` bytes
+        if (!last || *last == 0 || fileSize == 0) {
+            return std::nullopt;
+        }
+        return ByteRange{fileSize - std::min(*last, fileSize), fileSize - 1, true};
+    }
+    if (*first >= fileSize || (last && *last < *first)) {
+        return std::nullopt;
+    }
+    return ByteRange{*first, last ? std::min(*last, fileSize - 1) : fileSize - 1, true};
+}
+
+}  // namespace
+
+std::string HttpRequest::getHeader(const std::string& name) const {
+    auto it = headers.find(toLower(name));
+    return it == headers.end() ? "" : it->second;
+}
+
+std::optional<uint64_t> HttpRequest::getContentLength() const {
+    return parseNumber(getHeader("content-length"));
+}
+
+std::string getContentType(const fs::path& path) {
+    static const std::map<std::string, std::string> contentTypes = {
+        {".mp4", "video/mp4"},        {".m4v", "video/mp4"},       {".webm", "video/webm"},
+        {".mkv", "video/x-matroska"}, {".mov", "video/quicktime"}, {".avi", "video/x-msvideo"},
+        {".wav", "audio/wav"},        {".mp3", "audio/mpeg"},      {".m4a", "audio/mp4"},
+        {".aac", "audio/aac"},        {".opus", "audio/ogg"},      {".ogg", "audio/ogg"},
+        {".flac", "audio/flac"},      {".json", "application/json"},
+    };
+    auto it = contentTypes.find(toLower(path.extension().string()));
+    return it == contentTypes.end() ? "application/octet-stream" : it->second;
+}
+
+HttpConnection::HttpConnection(int fd, std::string bodyPrefix)
+    : m_fd(fd), m_bodyPrefix(std::move(bodyPrefix)) {}
+
+bool HttpConnection::sendAll(const char* data, size_t size) {
+    size_t written = 0;
+    while (written < size) {
+        ssize_t result = send(m_fd, data + written, size - written, MSG_NOSIGNAL);
+        if (result <= 0) {
+            return false;
+        }
+        written += result;
+    }
+    return true;
+}
+
+bool HttpConnection::sendResponse(int status, const std::string& contentType,
+                                  const std::string& body) {
+    std::string response = buildHeader(status, contentType, body.size()) + body;
+    return sendAll(response.data(), response.size());
+}
+
+bool HttpConnection::sendFile(const HttpRequest& request, const fs::path& path) {
+    int fileFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat fileStat{};
+    if (fileFd == -1 || fstat(fileFd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode)) {
+        if (fileFd != -1) {
+            close(fileFd);
+        }
+        return sendResponse(404, "text/plain", "Not found.\n");
+    }
+
+    const uint64_t fileSize = fileStat.st_size;
+    std::optional<ByteRange> range = ByteRange{0, fileSize - 1, false};
+    const std::string rangeHeader = request.getHeader("range");
+    if (!rangeHeader.empty()) {
+        range = parseRange(rangeHeader, fileSize);
+    }
+
+    std::string header;
+    uint64_t length = fileSize;
+    if (!range) {
+        close(fileFd);
+        header = buildHeader(416, "text/plain", 0,
+                             "Content-Range: bytes */" + std::to_string(fileSize) + "\r\n");
+        return sendAll(header.data(), header.size());
+    }
+    if (range->partial) {
+        length = range->last - range->first + 1;
+        header = buildHeader(206, getContentType(path), length,
+                             "Accept-Ranges: bytes\r\nContent-Range: bytes " +
+                                 std::to_string(range->first) + "-" +
+                                 std::to_string(range->last) + "/" + std::to_string(fileSize) +
+                                 "\r\n");
+    } else {
+        header = buildHeader(200, getContentType(path), length, "Accept-Ranges: bytes\r\n");
+    }
+
+    bool success = sendAll(header.data(), header.size());
+    if (request.method != "HEAD") {
+        off_t offset = range->first;
+        uint64_t remaining = length;
+        while (success && remaining > 0) {
+            ssize_t sent =
+                sendfile(m_fd, fileFd, &offset, std::min<uint64_t>(remaining, SENDFILE_CHUNK_SIZE));
+            if (sent == -1 && errno == EINTR) {
+                continue;
+            }
+            success = sent > 0;
+            remaining -= sent > 0 ? sent : 0;
+        }
+    }
+    close(fileFd);
+    return success;
+}
+
+int HttpConnection::receiveBody(const HttpRequest& request, const fs::path& path,
+                                uint64_t maxBytes) {
+    std::optional<uint64_t> contentLength = request.getContentLength();
+    if (!contentLength) {
+        return 411;
+    }
+    if (maxBytes > 0 && *contentLength > maxBytes) {
+        return 413;
+    }
+
+    int fileFd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fileFd == -1) {
+        std::cerr << "Error: Could not create " << path << ": " << std::strerror(errno)
+                  << std::endl;
+        return 500;
+    }
+
+    // curl asks first for bodies over 1 MB and would otherwise wait a second before sending
+    if (m_bodyPrefix.empty() && toLower(request.getHeader("expect")) == "100-continue") {
+        constexpr std::string_view continueResponse = "HTTP/1.1 100 Continue\r\n\r\n";
+        if (!sendAll(continueResponse.data(), continueResponse.size())) {
+            close(fileFd);
+            std::error_code ec;
+            fs::remove(path, ec);
+            return 400;
+        }
+    }
+
+    // Whatever arrived with the headers is written first, the rest comes off the socket
+    uint64_t prefixSize = std::min<uint64_t>(m_bodyPrefix.size(), *contentLength);
+    bool success = write(fileFd, m_bodyPrefix.data(), prefixSize) ==
+                   static_cast<ssize_t>(prefixSize);
+    uint64_t remaining = *contentLength - prefixSize;
+    if (success && remaining > 0 && !spliceBody(fileFd, remaining)) {
+        // The file position tells how much was spliced before falling back
+        off_t written = lseek(fileFd, 0, SEEK_CUR);
+        success = written >= 0 && copyBody(fileFd, *contentLength - written);
+    }
+    close(fileFd);
+
+    if (!success) {
+        std::error_code ec;
+        fs::remove(path, ec);
+        return 400;
+    }
+    return 0;
+}
+
+bool HttpConnection::spliceBody(int fileFd, uint64_t remaining) {
+    std::array<int, 2> pipeFds;
+    if (pipe2(pipeFds.data(), O_CLOEXEC) == -1) {
+        return false;
+    }
+
+    bool success = true;
+    while (success && remaining > 0) {
+        ssize_t received = splice(m_fd, nullptr, pipeFds[1], nullptr,
+                                  std::min<uint64_t>(remaining, SPLICE_CHUNK_SIZE), SPLICE_F_MOVE);
+        if (received <= 0) {
+            success = received == -1 && errno == EINTR;
+            continue;
+        }
+        ssize_t pending = received;
+        while (success && pending > 0) {
+            ssize_t written = splice(pipeFds[0], nullptr, fileFd, nullptr, pending, SPLICE_F_MOVE);
+            success = written > 0;
+            pending -= written > 0 ? written : 0;
+        }
+        remaining -= received;
+    }
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+    return success;
+}
+
+bool HttpConnection::copyBody(int fileFd, uint64_t remaining) {
+    std::vector<char> buffer(BODY_BUFFER_SIZE);
+    while (remaining > 0) {
+        ssize_t received =
+            recv(m_fd, buffer.data(), std::min<uint64_t>(remaining, buffer.size()), 0);
+        if (received == -1 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0 || write(fileFd, buffer.data(), received) != received) {
+            return false;
+        }
+        remaining -= received;
+    }
+    return true;
+}
+
+HttpServer::HttpServer(std::string endpoint, size_t numConnectionThreads)
+    : m_connectionThreads(std::max<size_t>(numConnectionThreads, 1)),
+      m_listener(std::move(endpoint), HTTP_LISTEN_BACKLOG) {}
+
+void HttpServer::addRoute(const std::string& method, const std::string& pathPrefix,
+                          Handler handler) {
+    m_routes.push_back({method, pathPrefix, std::move(handler)});
+}
+
+bool HttpServer::start() {
+    return m_listener.start([this](int clientFd) {
+        timeval timeout{HTTP_SOCKET_TIMEOUT_SECONDS, 0};
+        setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        m_connectionThreads.post([this, clientFd]() {
+            serve(clientFd);
+            close(clientFd);
+        });
+    });
+}
+
+uint16_t HttpServer::getPort() const {
+    return m_listener.getPort();
+}
+
+void HttpServer::serve(int clientFd) {
+    std::string data;
+    std::array<char, 4096> buffer;
+    size_t headerEnd;
+    while ((headerEnd = data.find("\r\n\r\n")) == std::string::npos) {
+        if (data.size() >= MAX_HEADER_SIZE) {
+            HttpConnection(clientFd, "").sendResponse(400, "text/plain", "Header too large.\n");
+            return;
+        }
+        ssize_t bytesRead = recv(clientFd, buffer.data(), buffer.size(), 0);
+        if (bytesRead <= 0) {
+            return;
+        }
+        data.append(buffer.data(), bytesRead);
+    }
+
+    HttpRequest request;
+    HttpConnection connection(clientFd, data.substr(headerEnd + 4));
+    size_t lineEnd = data.find("\r\n");
+    const std::string requestLine = data.substr(0, lineEnd);
+    size_t methodEnd = requestLine.find(' ');
+    size_t targetEnd = requestLine.find(' ', methodEnd + 1);
+    if (methodEnd == std::string::npos || targetEnd == std::string::npos) {
+        connection.sendResponse(400, "text/plain", "Malformed request line.\n");
+        return;
+    }
+    request.method = requestLine.substr(0, methodEnd);
+    request.path = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    request.path = request.path.substr(0, request.path.find('?'));
+
+    while (lineEnd < headerEnd) {
+        size_t nextLine = data.find("\r\n", lineEnd + 2);
+        const std::string line = data.substr(lineEnd + 2, nextLine - lineEnd - 2);
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            request.headers[toLower(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+        }
+        lineEnd = nextLine;
+    }
+
+    for (const auto& route : m_routes) {
+        if (route.method == request.method && request.path.starts_with(route.pathPrefix)) {
+            route.handler(request, connection);
+            return;
+        }
+    }
+    connection.sendResponse(404, "text/plain", "Not found.\n");
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,140 @@
+#ifndef HTTPSERVER_H
+#define HTTPSERVER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "SocketListener.h"
+#include "ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+/**
+ * @brief A parsed request line and headers; the body is left on the connection.
+ */
+struct HttpRequest {
+    std::string method;
+    std::string path;                            // target without the query string
+    std::map<std::string, std::string> headers;  // names lowercased
+
+    /**
+     * @return The header's value, or an empty string if it was not sent.
+     */
+    std::string getHeader(const std::string& name) const;
+    std::optional<uint64_t> getContentLength() const;
+};
+
+/**
+ * @brief A client connection, answered once and then closed.
+ */
+class HttpConnection {
+   public:
+    /**
+     * @param bodyPrefix Body bytes that arrived together with the headers.
+     */
+    HttpConnection(int fd, std::string bodyPrefix);
+
+    /**
+     * @brief Sends a complete response with an in-memory body.
+     */
+    bool sendResponse(int status, const std::string& contentType, const std::string& body);
+
+    /**
+     * @brief Sends `path` with sendfile(2), so the file never passes through user space.
+     *
+     * Honours a single `Range: bytes=` range with 206 Partial Content and answers an
+     * unsatisfiable one with 416; other range forms are ignored and the whole file is sent.
+     * HEAD requests get the headers only.
+     */
+    bool sendFile(const HttpRequest& request, const fs::path& path);
+
+    /**
+     * @brief Streams the request body into `path` without buffering it in memory.
+     *
+     * The body is spliced from the socket through a pipe into the file where the kernel
+     * supports it, and copied through a fixed buffer otherwise. A client that sent
+     * `Expect: 100-continue` is told to go ahead once the body is known to be accepted.
+     *
+     * @param maxBytes Largest body accepted; 0 for no limit.
+     * @return The HTTP status to answer with: 0 once the body is written, 411 without a
+     *         Content-Length, 413 if it exceeds `maxBytes`, 400 if the client went away and
+     *         500 if the file could not be written.
+     */
+    int receiveBody(const HttpRequest& request, const fs::path& path, uint64_t maxBytes);
+
+   private:
+    bool sendAll(const char* data, size_t size);
+    bool spliceBody(int fileFd, uint64_t remaining);
+    bool copyBody(int fileFd, uint64_t remaining);
+
+    int m_fd;
+    std::string m_bodyPrefix;
+};
+
+/**
+ * @brief A minimal HTTP/1.1 server dispatching requests to handlers by method and path prefix.
+ *
+ * One thread accepts connections and hands each to a pool of connection threads, so a slow
+ * upload or download only occupies its own thread. Every connection serves one request.
+ */
+class HttpServer {
+   public:
+    using Handler = std::function<void(const HttpRequest&, HttpConnection&)>;
+
+    /**
+     * @param endpoint `unix:<path>`, `<host>:<port>` or `<port>` (bound to 127.0.0.1); port 0
+     *        picks a free one.
+     */
+    HttpServer(std::string endpoint, size_t numConnectionThreads);
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    /**
+     * @brief Routes requests whose method is `method` and whose path starts with `pathPrefix`.
+     *
+     * The first matching route wins; requests nothing matches get a 404.
+     */
+    void addRoute(const std::string& method, const std::string& pathPrefix, Handler handler);
+
+    /**
+     * @brief Binds the endpoint and starts accepting connections.
+     *
+     * @return true if the endpoint could be bound, false otherwise.
+     */
+    bool start();
+
+    /**
+     * @brief Gets the bound port, e.g. the one picked for port 0; valid after start().
+     */
+    uint16_t getPort() const;
+
+   private:
+    struct Route {
+        std::string method;
+        std::string pathPrefix;
+        Handler handler;
+    };
+
+    void serve(int clientFd);
+
+    std::vector<Route> m_routes;
+    ThreadPool m_connectionThreads;
+    SocketListener m_listener;  // last, so it stops accepting before the threads go away
+};
+
+/**
+ * @brief Gets the Content-Type served for a file, by its extension.
+ */
+std::string getContentType(const fs::path& path);
+
+}  // namespace MediaProcessor
+
+#endif  // HTTPSERVER_H
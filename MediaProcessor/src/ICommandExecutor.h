@@ -0,0 +1,31 @@
+#ifndef ICOMMANDEXECUTOR_H
+#define ICOMMANDEXECUTOR_H
+
+#include <string>
+
+#include "AsyncTask.h"
+#include "CancellationToken.h"
+#include "ProcessReactor.h"
+
+namespace MediaProcessor {
+
+/**
+ * @brief Interface for running the commands produced by an ICommandBuilder.
+ */
+class ICommandExecutor {
+   public:
+    virtual ~ICommandExecutor() = default;
+
+    /**
+     * @brief Runs a command once awaited.
+     *
+     * @param mergeStderr Capture stderr together with stdout.
+     * @return The command's CommandOutcome.
+     */
+    virtual Task<CommandOutcome> execute(std::string command, bool mergeStderr,
+                                         CancellationToken token) = 0;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // ICOMMANDEXECUTOR_H
@@ -0,0 +1,438 @@
+#include "JobScheduler.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+#include "ConfigManager.h"
+#include "Metrics.h"
+#include "RuntimeServices.h"
+#include "Utils.h"
+
+namespace MediaProcessor {
+
+JobScheduler::JobScheduler(AsyncRuntime& runtime, CostModel& costModel,
+                           const CancellationToken& cancellationToken)
+    : m_runtime(runtime), m_costModel(costModel), m_cancellationToken(cancellationToken) {}
+
+JobScheduler::~JobScheduler() {
+    stop();
+}
+
+JobScheduler::Job JobScheduler::createJob(const fs::path& mediaPath, const std::string& tenant) {
+    auto engine = std::make_unique<Engine>(mediaPath, m_cancellationToken);
+    engine->setCostModel(&m_costModel);
+    engine->setTenant(tenant);
+    Job job;
+    job.mediaPath = mediaPath;
+    job.engine = std::move(engine);
+    return job;
+}
+
+void JobScheduler::addJob(const fs::path& mediaPath, const std::string& tenant) {
+    m_jobs.push_back(createJob(mediaPath, tenant));
+}
+
+Task<void> JobScheduler::estimateJob(Job& job) {
+    std::optional<JobFeatures> features = co_await job.engine->probe(m_runtime);
+    if (features) {
+        job.estimate = m_costModel.predict(*features);
+    }
+}
+
+Task<BatchStatus> JobScheduler::run() {
+    ConfigManager& configManager = ConfigManager::getInstance();
+    const double maxJobSeconds = configManager.getMaxJobSeconds().count();
+
+    // Probes only wait on FFprobe, so all of them run at once
+    std::vector<Task<void>> estimates;
+    for (auto& job : m_jobs) {
+        estimates.push_back(estimateJob(job));
+    }
+    co_await whenAll(std::move(estimates));
+
+    std::vector<Job*> queue;
+    for (auto& job : m_jobs) {
+        if (admit(job, maxJobSeconds)) {
+            queue.push_back(&job);
+        }
+    }
+
+    // Shortest predicted job first minimizes the mean completion time
+    std::stable_sort(queue.begin(), queue.end(), [](const Job* lhs, const Job* rhs) {
+        return lhs->estimate->getTotalSeconds() < rhs->estimate->getTotalSeconds();
+    });
+
+    const size_t numLanes = std::min<size_t>(configManager.getMaxConcurrentJobs(), queue.size());
+    queue = shedLoad(queue, std::vector<double>(numLanes, 0.0));
+    Metrics::getInstance().jobsQueued.add(queue.size());
+    for (const Job* job : queue) {
+        std::cout << "INFO: queued " << job->mediaPath << " (predicted "
+                  << job->estimate->getTotalSeconds() << "s, waiting "
+                  << job->queueWaitSeconds << "s)." << std::endl;
+    }
+
+    // Reports of jobs that will not run are complete already
+    for (const auto& job : m_jobs) {
+        if (job.status != JobStatus::Queued) {
+            writeJobReport(job);
+        }
+    }
+
+    std::vector<Task<bool>> lanes;
+    for (size_t i = 0; i < std::min(numLanes, queue.size()); ++i) {
+        lanes.push_back(runLane(queue));
+    }
+    co_await whenAll(std::move(lanes));
+
+    bool anyBusy = false;
+    bool anyFailed = false;
+    for (const auto& job : m_jobs) {
+        anyBusy = anyBusy || job.status == JobStatus::Busy;
+        anyFailed = anyFailed || (job.status != JobStatus::Completed &&
+                                  job.status != JobStatus::Busy);
+    }
+    co_return anyFailed ? BatchStatus::Failed
+                        : (anyBusy ? BatchStatus::Busy : BatchStatus::Succeeded);
+}
+
+bool JobScheduler::admit(Job& job, double maxJobSeconds) {
+    if (!job.estimate) {
+        std::cerr << "Error: Could not probe " << job.mediaPath << ", skipping it." << std::endl;
+        job.status = JobStatus::Failed;
+        job.decisions.push_back({"reject", "the input could not be probed"});
+        return false;
+    }
+    if (maxJobSeconds > 0 && job.estimate->getTotalSeconds() > maxJobSeconds) {
+        std::cerr << "Error: Rejecting " << job.mediaPath << ": predicted "
+                  << job.estimate->getTotalSeconds() << "s exceeds max_job_seconds ("
+                  << maxJobSeconds << "s)." << std::endl;
+        job.status = JobStatus::Rejected;
+        job.decisions.push_back(
+            {"reject", fmt::format("predicted {:.1f}s exceeds max_job_seconds ({}s)",
+                                   job.estimate->getTotalSeconds(), maxJobSeconds)});
+        return false;
+    }
+    return true;
+}
+
+std::vector<JobStatus> JobScheduler::getJobStatuses() const {
+    std::vector<JobStatus> statuses;
+    for (const auto& job : m_jobs) {
+        statuses.push_back(job.status);
+    }
+    return statuses;
+}
+
+std::vector<JobScheduler::Job*> JobScheduler::shedLoad(const std::vector<Job*>& queue,
+                                                       std::vector<double> laneFreeAt) {
+    const LoadSheddingConfig shedding = ConfigManager::getInstance().getLoadShedding();
+    const double maxQueueWait = shedding.maxQueueWait.count();
+    const bool sheddingEnabled = shedding.policy != SheddingPolicy::Off && maxQueueWait > 0;
+
+    // Replays the lanes on the predictions: each job starts when the first lane frees up
+    std::vector<Job*> admitted;
+    for (Job* job : queue) {
+        auto lane = std::min_element(laneFreeAt.begin(), laneFreeAt.end());
+        if (!job->decisions.empty()) {
+            *lane += job->estimate->getTotalSeconds();
+            admitted.push_back(job);
+            continue;
+        }
+        job->queueWaitSeconds = *lane;
+
+        if (sheddingEnabled && job->queueWaitSeconds > maxQueueWait) {
+            const std::string reason =
+                fmt::format("estimated queue wait {:.1f}s exceeds max_queue_wait_seconds ({}s)",
+                            job->queueWaitSeconds, maxQueueWait);
+
+            if (shedding.policy == SheddingPolicy::Reject) {
+                std::cerr << "BUSY: rejecting " << job->mediaPath << ": " << reason << "."
+                          << std::endl;
+                job->status = JobStatus::Busy;
+                job->decisions.push_back({"reject_busy", reason});
+                continue;
+            }
+
+            // Degrading does not shorten this job's own wait, only the wait of those after it
+            job->engine->setQualityTier(shedding.degradeTier);
+            job->estimate = job->engine->predictCost();
+            const std::string tier =
+                shedding.degradeTier == QualityTier::Fast ? "fast" : "preview";
+            std::cout << "INFO: degrading " << job->mediaPath << " to the " << tier
+                      << " tier: " << reason << "." << std::endl;
+            job->decisions.push_back({"degrade_to_" + tier, reason});
+        } else {
+            job->decisions.push_back(
+                {"admit", fmt::format("predicted {:.1f}s, estimated queue wait {:.1f}s",
+                                      job->estimate->getTotalSeconds(), job->queueWaitSeconds)});
+        }
+
+        *lane += job->estimate->getTotalSeconds();
+        admitted.push_back(job);
+    }
+    return admitted;
+}
+
+Task<bool> JobScheduler::runLane(std::vector<Job*>& queue) {
+    bool allSucceeded = true;
+    for (size_t i = m_nextJob++; i < queue.size(); i = m_nextJob++) {
+        allSucceeded = co_await runJob(*queue[i]) && allSucceeded;
+    }
+    co_return allSucceeded;
+}
+
+Task<bool> JobScheduler::runJob(Job& job) {
+    Metrics& metrics = Metrics::getInstance();
+    metrics.jobsQueued.add(-1);
+    if (m_cancellationToken.isCancelled()) {
+        metrics.jobsFailed.increment();
+        job.status = JobStatus::Failed;
+        job.decisions.push_back({"cancel", m_cancellationToken.getReason()});
+        co_await m_runtime.runBlockingIO([&job]() { writeJobReport(job); });
+        co_return false;
+    }
+
+    metrics.jobsInFlight.add(1);
+    auto start = std::chrono::steady_clock::now();
+    bool success = false;
+    try {
+        success = co_await job.engine->processMediaAsync(m_runtime);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << job.mediaPath << ": " << e.what() << std::endl;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    job.wallSeconds = elapsed.count();
+    metrics.jobsInFlight.add(-1);
+
+    if (success) {
+        metrics.jobsCompleted.increment();
+    } else {
+        std::cerr << "Error: Processing failed: " << job.mediaPath << std::endl;
+        metrics.jobsFailed.increment();
+    }
+    job.status = success ? JobStatus::Completed : JobStatus::Failed;
+    co_await m_runtime.runBlockingIO([&job]() { writeJobReport(job); });
+    co_return success;
+}
+
+void JobScheduler::start() {
+    const size_t numLanes = ConfigManager::getInstance().getMaxConcurrentJobs();
+    m_laneBusyUntil.assign(numLanes, {});
+    for (size_t lane = 0; lane < numLanes; ++lane) {
+        m_lanes.emplace_back(&JobScheduler::runLaneThread, this, lane);
+    }
+}
+
+std::vector<JobStatus> JobScheduler::submit(std::vector<JobSubmission> submissions) {
+    const double maxJobSeconds = ConfigManager::getInstance().getMaxJobSeconds().count();
+
+    std::vector<std::unique_ptr<Job>> jobs;
+    std::vector<Task<void>> estimates;
+    for (auto& submission : submissions) {
+        jobs.push_back(std::make_unique<Job>(
+            createJob(submission.request.mediaPath, submission.request.tenant)));
+        jobs.back()->onFinished = std::move(submission.onFinished);
+        estimates.push_back(estimateJob(*jobs.back()));
+    }
+    syncWait(whenAll(std::move(estimates)));
+
+    std::vector<JobStatus> statuses;
+    std::vector<std::unique_ptr<Job>> unqueued;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<Job*> submitted;
+        std::vector<std::unique_ptr<Job>> queue = std::move(m_waiting);
+        m_waiting.clear();
+        for (auto& job : jobs) {
+            submitted.push_back(job.get());
+            if (admit(*job, maxJobSeconds)) {
+                queue.push_back(std::move(job));
+            } else {
+                unqueued.push_back(std::move(job));
+            }
+        }
+
+        // Shortest predicted job first, with the running jobs holding their lanes
+        std::stable_sort(queue.begin(), queue.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs->estimate->getTotalSeconds() < rhs->estimate->getTotalSeconds();
+        });
+        const auto now = std::chrono::steady_clock::now();
+        std::vector<double> laneFreeAt;
+        for (const auto& busyUntil : m_laneBusyUntil) {
+            std::chrono::duration<double> remaining = busyUntil - now;
+            laneFreeAt.push_back(std::max(remaining.count(), 0.0));
+        }
+        std::vector<Job*> order;
+        for (const auto& job : queue) {
+            order.push_back(job.get());
+        }
+        shedLoad(order, std::move(laneFreeAt));
+
+        for (auto& job : queue) {
+            auto& destination = job->status == JobStatus::Queued ? m_waiting : unqueued;
+            destination.push_back(std::move(job));
+        }
+        for (const Job* job : submitted) {
+            statuses.push_back(job->status);
+            if (job->status == JobStatus::Queued) {
+                Metrics::getInstance().jobsQueued.add(1);
+                std::cout << "INFO: queued " << job->mediaPath << " (predicted "
+                          << job->estimate->getTotalSeconds() << "s, waiting "
+                          << job->queueWaitSeconds << "s)." << std::endl;
+            }
+        }
+    }
+    m_condition.notify_all();
+
+    for (const auto& job : unqueued) {
+        writeJobReport(*job);
+        if (job->onFinished) {
+            job->onFinished(job->status);
+        }
+    }
+    return statuses;
+}
+
+void JobScheduler::runLaneThread(size_t lane) {
+    while (true) {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_waiting.empty(); });
+            if (m_waiting.empty()) {
+                return;
+            }
+            job = std::move(m_waiting.front());
+            m_waiting.erase(m_waiting.begin());
+            m_laneBusyUntil[lane] =
+                std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(job->estimate->getTotalSeconds()));
+        }
+
+        syncWait(runJob(*job));
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_laneBusyUntil[lane] = {};
+        }
+        if (job->onFinished) {
+            job->onFinished(job->status);
+        }
+    }
+}
+
+void JobScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto& lane : m_lanes) {
+        lane.join();
+    }
+    m_lanes.clear();
+}
+
+void JobScheduler::writeJobReport(const Job& job) {
+    static const char* statusNames[] = {"queued", "completed", "failed", "rejected", "busy"};
+    static const char* tierNames[] = {"full", "fast", "preview"};
+
+    nlohmann::json decisions = nlohmann::json::array();
+    for (const auto& decision : job.decisions) {
+        decisions.push_back({{"action", decision.action}, {"reason", decision.reason}});
+    }
+
+    nlohmann::json report = {
+        {"input", job.mediaPath.string()},
+        {"tenant", job.engine->getTenant()},
+        {"status", statusNames[static_cast<int>(job.status)]},
+        {"quality_tier", tierNames[static_cast<int>(job.engine->getQualityTier())]},
+        {"predicted_seconds",
+         job.estimate ? nlohmann::json(job.estimate->getTotalSeconds()) : nlohmann::json()},
+        {"estimated_queue_wait_seconds", job.queueWaitSeconds},
+        {"wall_seconds", job.wallSeconds},
+        {"output", job.engine->getOutputPath().string()},
+        {"decisions", decisions}};
+
+    const fs::path reportPath = Utils::prepareJobReportPath(job.mediaPath);
+    std::ofstream reportFile(reportPath);
+    if (!(reportFile << report.dump(4))) {
+        std::cerr << "Warning: Could not write job report to " << reportPath << std::endl;
+    }
+}
+
+void JobScheduler::reportWorkerMetrics(const WorkerMetrics& metrics,
+                                       const fs::path& metricsPath) {
+    std::cout << "INFO: inference workers peaked at " << metrics.pool.peak << " ("
+              << metrics.pool.started << " started, " << metrics.pool.retired
+              << " retired when idle, " << metrics.freedFilterStates << " DFStates freed)."
+              << std::endl;
+
+    nlohmann::json tenants = nlohmann::json::object();
+    for (const auto& [tenant, usage] : metrics.tenants) {
+        std::cout << "INFO: tenant " << tenant << " (weight " << usage.weight << ") used "
+                  << usage.cpuSeconds << " CPU seconds in " << usage.completedTasks
+                  << " chunk(s)." << std::endl;
+        tenants[tenant] = {{"weight", usage.weight},
+                           {"cpu_seconds", usage.cpuSeconds},
+                           {"completed_tasks", usage.completedTasks}};
+    }
+    if (metricsPath.empty() || metrics.sizeHistory.empty()) {
+        return;
+    }
+
+    const auto start = metrics.sizeHistory.front().time;
+    nlohmann::json samples = nlohmann::json::array();
+    for (const auto& sample : metrics.sizeHistory) {
+        std::chrono::duration<double> offset = sample.time - start;
+        samples.push_back({{"seconds", offset.count()}, {"workers", sample.threads}});
+    }
+    nlohmann::json report = {{"peak_workers", metrics.pool.peak},
+                             {"started_workers", metrics.pool.started},
+                             {"retired_workers", metrics.pool.retired},
+                             {"freed_filter_states", metrics.freedFilterStates},
+                             {"pool_size", samples},
+                             {"tenants", tenants}};
+
+    std::ofstream metricsFile(metricsPath);
+    if (!(metricsFile << report.dump(4))) {
+        std::cerr << "Warning: Could not write pool metrics to " << metricsPath << std::endl;
+    }
+}
+
+BatchStatus JobScheduler::processFiles(const std::vector<JobRequest>& requests,
+                                       const CancellationToken& cancellationToken,
+                                       bool recalibrate) {
+    ConfigManager& configManager = ConfigManager::getInstance();
+    if (!configManager.loadConfig("config.json")) {
+        std::cerr << "Error: Could not load configuration." << std::endl;
+        return BatchStatus::Failed;
+    }
+
+    if (recalibrate) {
+        std::cout << "INFO: recalibrating the cost model from this run." << std::endl;
+    }
+    std::unique_ptr<RuntimeServices> services =
+        RuntimeServices::create(configManager, !recalibrate);
+    if (!services) {
+        return BatchStatus::Failed;
+    }
+    AsyncRuntime& runtime = services->getRuntime();
+
+    JobScheduler scheduler(runtime, services->getCostModel(), cancellationToken);
+    for (const auto& request : requests) {
+        scheduler.addJob(request.mediaPath, request.tenant);
+    }
+
+    BatchStatus status = syncWait(scheduler.run());
+    reportWorkerMetrics(runtime.getWorkerMetrics(), configManager.getPoolMetricsPath());
+    services->saveCostModel();
+    return status;
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,219 @@
+#ifndef JOBSCHEDULER_H
+#define JOBSCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncRuntime.h"
+#include "AsyncTask.h"
+#include "CancellationToken.h"
+#include "CostModel.h"
+#include "Engine.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+enum class BatchStatus { Succeeded, Failed, Busy };
+enum class JobStatus { Queued, Completed, Failed, Rejected, Busy };
+
+/**
+ * @brief A file to process and the tenant it is processed for.
+ */
+struct JobRequest {
+    fs::path mediaPath;
+    std::string tenant = DEFAULT_TENANT;
+};
+
+/**
+ * @brief Called once with a submitted job's final status.
+ */
+using JobCallback = std::function<void(JobStatus)>;
+
+/**
+ * @brief A job for the lanes of a running JobScheduler and what to do once it is done.
+ */
+struct JobSubmission {
+    JobRequest request;
+    JobCallback onFinished;  // from submit() for jobs that will not run, from their lane otherwise
+};
+
+/**
+ * @brief An admission or load shedding decision taken for a job, kept for its report.
+ */
+struct JobDecision {
+    std::string action;  // e.g. "admit", "reject_busy" or "degrade_to_preview"
+    std::string reason;
+};
+
+/**
+ * @brief Runs a batch of media jobs on one shared runtime, ordered by their predicted cost.
+ *
+ * All jobs are probed up front and estimated with the cost model. Jobs predicted to exceed
+ * `max_job_seconds` are rejected before doing any work; the rest run shortest-predicted-first
+ * on up to `max_concurrent_jobs` lanes, so short jobs are not stuck behind long ones.
+ *
+ * Jobs whose estimated queue wait exceeds `load_shedding.max_queue_wait_seconds` are rejected
+ * as busy or downgraded to a cheaper quality tier, depending on the policy. Every job gets a
+ * report next to its input listing the decisions taken for it.
+ *
+ * Chunk filtering of concurrently running jobs is shared between their tenants by the
+ * configured `tenant_weights`, and each tenant's CPU time is reported with the pool metrics.
+ *
+ * Queue, stage latency, inference and child process metrics are kept in Metrics; with a
+ * `metrics_endpoint` configured, processFiles() serves them to Prometheus while it runs.
+ *
+ * Long-running services start() the lanes once and submit() jobs as they arrive instead: the
+ * same admission, ordering and load shedding apply to every submission, counting the jobs
+ * already running and queued.
+ */
+class JobScheduler {
+   public:
+    /**
+     * @param costModel Shared by all jobs and updated from each completed one.
+     */
+    JobScheduler(AsyncRuntime& runtime, CostModel& costModel,
+                 const CancellationToken& cancellationToken = CancellationToken());
+    ~JobScheduler();
+
+    JobScheduler(const JobScheduler&) = delete;
+    JobScheduler& operator=(const JobScheduler&) = delete;
+
+    void addJob(const fs::path& mediaPath, const std::string& tenant = DEFAULT_TENANT);
+
+    /**
+     * @brief Probes, admits and processes all added jobs.
+     *
+     * The configuration must already be loaded.
+     *
+     * @return Succeeded if every job was admitted and processed successfully, Busy if the only
+     *         failures are jobs shed as busy, Failed otherwise.
+     */
+    Task<BatchStatus> run();
+
+    /**
+     * @brief Gets the status of each added job, in the order the jobs were added.
+     */
+    std::vector<JobStatus> getJobStatuses() const;
+
+    /**
+     * @brief Starts `max_concurrent_jobs` lanes, each running one submitted job at a time.
+     *
+     * The configuration must already be loaded.
+     */
+    void start();
+
+    /**
+     * @brief Probes and admits jobs, and queues the admitted ones for the lanes.
+     *
+     * Queued jobs run shortest-predicted-first. A new job's queue wait counts the rest of the
+     * running jobs' predicted time and the queued jobs ahead of it, which keep their decisions.
+     * Blocks only while probing; requires start().
+     *
+     * @return Each job's status once admitted: Queued, or why it will not run.
+     */
+    std::vector<JobStatus> submit(std::vector<JobSubmission> submissions);
+
+    /**
+     * @brief Lets the lanes run every queued job, then stops them.
+     */
+    void stop();
+
+    /**
+     * @brief Processes `requests` with the host's cost model and saves it afterwards.
+     *
+     * @param recalibrate Discards the stored model first, so these runs calibrate it anew.
+     */
+    static BatchStatus processFiles(const std::vector<JobRequest>& requests,
+                                    const CancellationToken& cancellationToken, bool recalibrate);
+
+   private:
+    struct Job {
+        fs::path mediaPath;
+        std::unique_ptr<Engine> engine;
+        std::optional<CostEstimate> estimate;
+        double queueWaitSeconds = 0.0;
+        JobStatus status = JobStatus::Queued;
+        std::vector<JobDecision> decisions;
+        double wallSeconds = 0.0;
+        JobCallback onFinished;
+    };
+
+    Job createJob(const fs::path& mediaPath, const std::string& tenant);
+
+    /**
+     * @brief Probes a job and predicts its cost; the estimate stays empty if probing failed.
+     */
+    Task<void> estimateJob(Job& job);
+
+    /**
+     * @brief Rejects a job that could not be probed or is predicted to exceed `maxJobSeconds`.
+     *
+     * @return true if the job may be queued.
+     */
+    static bool admit(Job& job, double maxJobSeconds);
+
+    /**
+     * @brief Processes queued jobs one after another until the queue is drained.
+     */
+    Task<bool> runLane(std::vector<Job*>& queue);
+
+    /**
+     * @brief Processes a queued job, or fails it if the batch was cancelled, and writes its
+     *        report.
+     *
+     * @return true if the job completed.
+     */
+    Task<bool> runJob(Job& job);
+
+    /**
+     * @brief Runs the submitted jobs on lane `lane` until stop().
+     */
+    void runLaneThread(size_t lane);
+
+    /**
+     * @brief Estimates each queued job's wait on the lanes and applies the load shedding
+     *        policy to jobs that would wait too long.
+     *
+     * Jobs that were decided on before keep their place and only delay the jobs after them.
+     *
+     * @param laneFreeAt Seconds until each lane is free.
+     * @return The jobs still to run, in order.
+     */
+    std::vector<Job*> shedLoad(const std::vector<Job*>& queue, std::vector<double> laneFreeAt);
+
+    static void writeJobReport(const Job& job);
+
+    /**
+     * @brief Logs how the worker pool was sized and each tenant's CPU time and, if
+     *        `metricsPath` is set, writes both there together with the pool size over time.
+     */
+    static void reportWorkerMetrics(const WorkerMetrics& metrics, const fs::path& metricsPath);
+
+    AsyncRuntime& m_runtime;
+    CostModel& m_costModel;
+    CancellationToken m_cancellationToken;
+    std::vector<Job> m_jobs;
+    std::atomic<size_t> m_nextJob{0};
+
+    // Submitted jobs
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<std::unique_ptr<Job>> m_waiting;  // in the order the lanes take them
+    std::vector<std::chrono::steady_clock::time_point> m_laneBusyUntil;  // predicted, per lane
+    std::vector<std::thread> m_lanes;
+    bool m_stopping = false;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // JOBSCHEDULER_H
@@ -0,0 +1,256 @@
+#include "MediaFrontend.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <thread>
+
+#include "PcmPipeline.h"
+#include "PcmStreamServer.h"
+#include "RuntimeServices.h"
+#include "Utils.h"
+
+namespace MediaProcessor {
+
+namespace {
+
+constexpr auto SHUTDOWN_POLL_INTERVAL = std::chrono::milliseconds(200);
+constexpr const char* PARTIAL_UPLOAD_SUFFIX = ".partial";
+
+std::string buildError(const std::string& message) {
+    return nlohmann::json{{"status", "error"}, {"message", message}}.dump();
+}
+
+}  // namespace
+
+MediaFrontend::MediaFrontend(AsyncRuntime& runtime, CostModel& costModel, HttpServerConfig config,
+                             const CancellationToken& cancellationToken)
+    : m_config(std::move(config)), m_scheduler(runtime, costModel, cancellationToken) {
+    m_scheduler.start();
+}
+
+void MediaFrontend::registerRoutes(HttpServer& server) {
+    auto upload = [this](const HttpRequest& request, HttpConnection& connection) {
+        handleUpload(request, connection);
+    };
+    auto job = [this](const HttpRequest& request, HttpConnection& connection) {
+        handleJob(request, connection);
+    };
+    auto media = [this](const HttpRequest& request, HttpConnection& connection) {
+        handleMedia(request, connection);
+    };
+    server.addRoute("PUT", UPLOAD_ROUTE, upload);
+    server.addRoute("POST", UPLOAD_ROUTE, upload);
+    server.addRoute("GET", JOB_ROUTE, job);
+    server.addRoute("GET", MEDIA_ROUTE, media);
+    server.addRoute("HEAD", MEDIA_ROUTE, media);
+}
+
+std::optional<fs::path> MediaFrontend::resolveUploadPath(const std::string& requestPath,
+                                                         const std::string& route) const {
+    const std::string name = requestPath.substr(route.size());
+    if (name.empty() || Utils::sanitizeFilename(name) != name) {
+        return std::nullopt;
+    }
+    return m_config.uploadsPath / name;
+}
+
+bool MediaFrontend::isNameTaken(const fs::path& mediaPath) {
+    const auto [vocalsPath, videoOutputPath] = Utils::prepareOutputPaths(mediaPath);
+    for (const fs::path& path : {mediaPath, Utils::prepareJobReportPath(mediaPath),
+                                 Utils::prepareAudioOutputPath(mediaPath), vocalsPath,
+                                 videoOutputPath}) {
+        if (fs::exists(path)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MediaFrontend::handleUpload(const HttpRequest& request, HttpConnection& connection) {
+    std::optional<fs::path> mediaPath = resolveUploadPath(request.path, UPLOAD_ROUTE);
+    if (!mediaPath) {
+        connection.sendResponse(400, "application/json", buildError("Invalid file name."));
+        return;
+    }
+    const std::string name = mediaPath->filename().string();
+    if (isNameTaken(*mediaPath)) {
+        connection.sendResponse(409, "application/json",
+                                buildError("An upload named " + name + " exists already."));
+        return;
+    }
+
+    // Each upload streams into a hidden file of its own, so concurrent ones never share it
+    std::string partialName = (m_config.uploadsPath / ("." + name + ".XXXXXX")).string();
+    partialName += PARTIAL_UPLOAD_SUFFIX;
+    int partialFd = mkstemps(partialName.data(), std::strlen(PARTIAL_UPLOAD_SUFFIX));
+    if (partialFd == -1) {
+        connection.sendResponse(500, "application/json", buildError(std::strerror(errno)));
+        return;
+    }
+    fchmod(partialFd, 0644);
+    close(partialFd);
+    const fs::path partialPath = partialName;
+
+    int status = connection.receiveBody(request, partialPath, m_config.maxUploadBytes);
+    std::error_code ec;
+    if (status != 0) {
+        fs::remove(partialPath, ec);
+        connection.sendResponse(status, "application/json", buildError("Upload failed."));
+        return;
+    }
+
+    // Only a complete upload takes the final name, and never over another one's
+    if (!Utils::renameNoReplace(partialPath, *mediaPath, ec)) {
+        const bool taken = ec == std::errc::file_exists;
+        fs::remove(partialPath, ec);
+        connection.sendResponse(taken ? 409 : 500, "application/json",
+                                buildError(taken ? "An upload named " + name + " exists already."
+                                                 : ec.message()));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_unfinishedUploads.insert(name);
+    }
+    JobSubmission submission{{*mediaPath}, [this, name](JobStatus) {
+                                 std::lock_guard<std::mutex> lock(m_mutex);
+                                 m_unfinishedUploads.erase(name);
+                             }};
+    const std::string tenant = request.getHeader(TENANT_HEADER);
+    if (!tenant.empty()) {
+        submission.request.tenant = tenant;
+    }
+    const JobStatus jobStatus = m_scheduler.submit({std::move(submission)}).front();
+
+    if (jobStatus == JobStatus::Queued) {
+        nlohmann::json response = {
+            {"status", "queued"},
+            {"status_url", JOB_ROUTE + name},
+            {"report_url", MEDIA_ROUTE + Utils::prepareJobReportPath(name).string()}};
+        connection.sendResponse(202, "application/json", response.dump());
+        return;
+    }
+
+    // A job that never ran leaves nothing behind, so the upload can be retried as it is
+    fs::remove(*mediaPath, ec);
+    fs::remove(Utils::prepareJobReportPath(*mediaPath), ec);
+    if (jobStatus == JobStatus::Busy) {
+        connection.sendResponse(503, "application/json",
+                                buildError("Too many uploads are queued, retry later."));
+    } else if (jobStatus == JobStatus::Rejected) {
+        connection.sendResponse(422, "application/json",
+                                buildError("The upload is predicted to exceed max_job_seconds."));
+    } else {
+        connection.sendResponse(422, "application/json",
+                                buildError("The upload is not a supported media file."));
+    }
+}
+
+void MediaFrontend::handleJob(const HttpRequest& request, HttpConnection& connection) {
+    std::optional<fs::path> mediaPath = resolveUploadPath(request.path, JOB_ROUTE);
+    if (!mediaPath) {
+        connection.sendResponse(404, "application/json", buildError("Unknown upload."));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_unfinishedUploads.contains(mediaPath->filename().string())) {
+            connection.sendResponse(200, "application/json",
+                                    nlohmann::json{{"status", "queued"}}.dump());
+            return;
+        }
+    }
+
+    // A finished job's report is complete: it is written before the job counts as done
+    nlohmann::json report;
+    try {
+        std::ifstream(Utils::prepareJobReportPath(*mediaPath)) >> report;
+    } catch (const std::exception&) {
+        connection.sendResponse(404, "application/json", buildError("Unknown upload."));
+        return;
+    }
+    nlohmann::json response = {{"status", report.value("status", "failed")}};
+    const fs::path outputPath = report.value("output", "");
+    if (!outputPath.empty()) {
+        response["media_url"] = MEDIA_ROUTE + outputPath.filename().string();
+        const bool isVideo = getContentType(outputPath).starts_with("video/");
+        response["file_type"] = isVideo ? "video" : "audio";
+    }
+    connection.sendResponse(200, "application/json", response.dump());
+}
+
+void MediaFrontend::handleMedia(const HttpRequest& request, HttpConnection& connection) {
+    std::optional<fs::path> mediaPath = resolveUploadPath(request.path, MEDIA_ROUTE);
+    if (!mediaPath || mediaPath->string().ends_with(PARTIAL_UPLOAD_SUFFIX)) {
+        connection.sendResponse(404, "text/plain", "Not found.\n");
+        return;
+    }
+    connection.sendFile(request, *mediaPath);
+}
+
+bool MediaFrontend::serve(const CancellationToken& cancellationToken) {
+    ConfigManager& configManager = ConfigManager::getInstance();
+    if (!configManager.loadConfig("config.json")) {
+        std::cerr << "Error: Could not load configuration." << std::endl;
+        return false;
+    }
+
+    HttpServerConfig serverConfig = configManager.getHttpServerConfig();
+    serverConfig.uploadsPath = fs::absolute(serverConfig.uploadsPath);
+    if (!Utils::ensureDirectoryExists(serverConfig.uploadsPath) &&
+        !fs::is_directory(serverConfig.uploadsPath)) {
+        std::cerr << "Error: Could not create " << serverConfig.uploadsPath << std::endl;
+        return false;
+    }
+
+    std::unique_ptr<PcmStreamServer> pcmStreamServer;
+    const PcmStreamConfig streamConfig = configManager.getPcmStreamConfig();
+    if (!streamConfig.socketPath.empty()) {
+        pcmStreamServer = std::make_unique<PcmStreamServer>(
+            streamConfig.socketPath, configManager.getDeepFilterTarballPath(),
+            streamConfig.maxSessions,
+            static_cast<size_t>(streamConfig.ringSeconds * PIPELINE_SAMPLE_RATE));
+        if (!pcmStreamServer->start()) {
+            return false;
+        }
+        std::cout << "INFO: streaming PCM sessions on " << streamConfig.socketPath << "."
+                  << std::endl;
+    }
+
+    std::unique_ptr<RuntimeServices> services = RuntimeServices::create(configManager);
+    if (!services) {
+        return false;
+    }
+
+    {
+        // Destroyed before the runtime, so no job is left processing on it
+        MediaFrontend frontend(services->getRuntime(), services->getCostModel(), serverConfig,
+                               cancellationToken);
+        HttpServer server(serverConfig.listen, serverConfig.connectionThreads);
+        frontend.registerRoutes(server);
+        if (!server.start()) {
+            return false;
+        }
+        std::cout << "INFO: serving uploads from " << serverConfig.uploadsPath << " on "
+                  << serverConfig.listen << "." << std::endl;
+
+        while (!cancellationToken.isCancelled()) {
+            std::this_thread::sleep_for(SHUTDOWN_POLL_INTERVAL);
+        }
+        std::cout << "INFO: shutting down: " << cancellationToken.getReason() << std::endl;
+    }
+
+    services->saveCostModel();
+    return true;
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,94 @@
+#ifndef MEDIAFRONTEND_H
+#define MEDIAFRONTEND_H
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+
+#include "AsyncRuntime.h"
+#include "CancellationToken.h"
+#include "ConfigManager.h"
+#include "CostModel.h"
+#include "HttpServer.h"
+#include "JobScheduler.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr const char* UPLOAD_ROUTE = "/upload/";
+constexpr const char* MEDIA_ROUTE = "/media/";
+constexpr const char* JOB_ROUTE = "/jobs/";
+constexpr const char* TENANT_HEADER = "x-tenant";
+
+/**
+ * @brief HTTP front end that takes uploads, processes them and serves the results.
+ *
+ * `PUT` or `POST /upload/<name>` streams the request body into a partial file of its own in
+ * `uploads_path`, which takes the name once complete, and submits it to a JobScheduler as the
+ * tenant named by an optional `X-Tenant` header. Uploads share its `max_concurrent_jobs` lanes,
+ * admission and load shedding, and only wait on the connection for their probe. The answer is
+ * 202 with `{"status": "queued", "status_url", "report_url"}`, 503 if the job was shed as
+ * busy, 422 if it cannot run and 409 if the name or one of its outputs is taken already.
+ *
+ * `GET /jobs/<name>` answers `{"status", "media_url", "file_type"}` like the web frontend's `/`
+ * endpoint, with only the status while the job is queued or running. `GET` or `HEAD
+ * /media/<name>` serves a file from `uploads_path` with sendfile(2), range requests and a
+ * content type matching its extension.
+ */
+class MediaFrontend {
+   public:
+    /**
+     * @param costModel Shared by all uploads and updated from each processed one.
+     * @param cancellationToken Cancels the processing of every upload.
+     *
+     * The configuration must already be loaded.
+     */
+    MediaFrontend(AsyncRuntime& runtime, CostModel& costModel, HttpServerConfig config,
+                  const CancellationToken& cancellationToken = CancellationToken());
+
+    /**
+     * @brief Adds the upload and media routes to `server`.
+     */
+    void registerRoutes(HttpServer& server);
+
+    /**
+     * @brief Serves the configured `http_server` until `cancellationToken` is cancelled.
+     *
+     * Loads the configuration and the host's cost model, and saves the model on shutdown. A
+     * configured `pcm_stream` socket is served alongside, see PcmStreamServer.
+     *
+     * @return true if the server ran and shut down cleanly, false if it could not start.
+     */
+    static bool serve(const CancellationToken& cancellationToken);
+
+   private:
+    void handleUpload(const HttpRequest& request, HttpConnection& connection);
+    void handleJob(const HttpRequest& request, HttpConnection& connection);
+    void handleMedia(const HttpRequest& request, HttpConnection& connection);
+
+    /**
+     * @brief Checks whether an upload to `mediaPath` would replace a file, its own or one its
+     *        job writes.
+     */
+    static bool isNameTaken(const fs::path& mediaPath);
+
+    /**
+     * @brief Maps the file name after `route` to a path in the uploads directory.
+     *
+     * @return The path, or std::nullopt if the name is empty or not a safe file name.
+     */
+    std::optional<fs::path> resolveUploadPath(const std::string& requestPath,
+                                              const std::string& route) const;
+
+    HttpServerConfig m_config;
+    std::mutex m_mutex;
+    std::set<std::string> m_unfinishedUploads;  // names of uploads whose job is not done
+    JobScheduler m_scheduler;  // last, so its lanes stop before what they use goes away
+};
+
+}  // namespace MediaProcessor
+
+#endif  // MEDIAFRONTEND_H
@@ -0,0 +1,138 @@
+#include "Metrics.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace MediaProcessor {
+
+namespace {
+
+constexpr const char* STAGE_NAMES[NUM_JOB_STAGES] = {"decode", "inference", "encode", "mux"};
+
+void writeHeader(std::ostringstream& out, const std::string& name, const char* type,
+                 const char* help) {
+    out << "# HELP " << name << ' ' << help << '\n' << "# TYPE " << name << ' ' << type << '\n';
+}
+
+void writeCounter(std::ostringstream& out, const std::string& name, const Counter& counter,
+                  const char* help) {
+    writeHeader(out, name, "counter", help);
+    out << name << ' ' << counter.get() << '\n';
+}
+
+void writeGauge(std::ostringstream& out, const std::string& name, int64_t value,
+                const char* help) {
+    writeHeader(out, name, "gauge", help);
+    out << name << ' ' << value << '\n';
+}
+
+/**
+ * @brief Reads the resident set size from /proc; zero where it is unavailable.
+ */
+int64_t getResidentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    int64_t totalPages = 0;
+    int64_t residentPages = 0;
+    if (!(statm >> totalPages >> residentPages)) {
+        return 0;
+    }
+    return residentPages * sysconf(_SC_PAGESIZE);
+}
+
+}  // namespace
+
+void Histogram::observe(double seconds) {
+    auto bound =
+        std::lower_bound(LATENCY_BUCKET_BOUNDS.begin(), LATENCY_BUCKET_BOUNDS.end(), seconds);
+    m_buckets[bound - LATENCY_BUCKET_BOUNDS.begin()].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(seconds, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::getBucketCount(size_t bucket) const {
+    return m_buckets[bucket].load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::getCount() const {
+    uint64_t count = 0;
+    for (const auto& bucket : m_buckets) {
+        count += bucket.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+double Histogram::getSum() const {
+    return m_sum.load(std::memory_order_relaxed);
+}
+
+Metrics& Metrics::getInstance() {
+    static Metrics instance;
+    return instance;
+}
+
+void Metrics::observeStep(JobStage stage, double seconds) {
+    stepSeconds[static_cast<size_t>(stage)].observe(seconds);
+}
+
+std::string Metrics::render() const {
+    std::ostringstream out;
+    writeGauge(out, "mediaprocessor_jobs_queued", jobsQueued.get(), "Jobs admitted, not started.");
+    writeGauge(out, "mediaprocessor_jobs_in_flight", jobsInFlight.get(), "Jobs being processed.");
+    writeCounter(out, "mediaprocessor_jobs_completed_total", jobsCompleted, "Completed jobs.");
+    writeCounter(out, "mediaprocessor_jobs_failed_total", jobsFailed,
+                 "Jobs that failed or were cancelled.");
+
+    const std::string histogram = "mediaprocessor_step_seconds";
+    writeHeader(out, histogram, "histogram", "Duration of pipeline steps by stage.");
+    for (size_t stage = 0; stage < NUM_JOB_STAGES; ++stage) {
+        const Histogram& steps = stepSeconds[stage];
+        const std::string label = std::string("stage=\"") + STAGE_NAMES[stage] + "\"";
+
+        // Read the buckets once, so the count always matches the +Inf bucket
+        uint64_t cumulative = 0;
+        for (size_t bucket = 0; bucket <= LATENCY_BUCKET_BOUNDS.size(); ++bucket) {
+            cumulative += steps.getBucketCount(bucket);
+            out << histogram << "_bucket{" << label << ",le=\"";
+            if (bucket < LATENCY_BUCKET_BOUNDS.size()) {
+                out << LATENCY_BUCKET_BOUNDS[bucket];
+            } else {
+                out << "+Inf";
+            }
+            out << "\"} " << cumulative << '\n';
+        }
+        out << histogram << "_sum{" << label << "} " << steps.getSum() << '\n';
+        out << histogram << "_count{" << label << "} " << cumulative << '\n';
+    }
+
+    writeCounter(out, "mediaprocessor_frames_filtered_total", framesFiltered,
+                 "DeepFilterNet frames processed; rate() gives frames per second.");
+    writeGauge(out, "mediaprocessor_inference_workers", inferenceWorkers.get(),
+               "Running inference worker threads.");
+    writeGauge(out, "mediaprocessor_filter_states", filterStates.get(),
+               "DFStates held by inference workers.");
+    writeGauge(out, "mediaprocessor_inference_tasks_running", inferenceTasksRunning.get(),
+               "Chunks being filtered.");
+
+    writeCounter(out, "mediaprocessor_chunk_cache_hits_total", chunkCacheHits,
+                 "Processed chunks reused from an interrupted run.");
+    writeCounter(out, "mediaprocessor_chunk_cache_misses_total", chunkCacheMisses,
+                 "Chunks that had to be filtered.");
+    writeCounter(out, "mediaprocessor_cassette_hits_total", cassetteHits,
+                 "Commands replayed from a command cassette.");
+    writeCounter(out, "mediaprocessor_cassette_misses_total", cassetteMisses,
+                 "Commands missing from a command cassette.");
+
+    writeGauge(out, "mediaprocessor_child_processes", childProcesses.get(),
+               "Running child processes.");
+    writeGauge(out, "mediaprocessor_pcm_stream_sessions", pcmStreamSessions.get(),
+               "Open PCM stream sessions.");
+    writeCounter(out, "mediaprocessor_pcm_stream_rejected_total", pcmStreamRejected,
+                 "PCM stream sessions refused because all were taken.");
+    writeGauge(out, "process_resident_memory_bytes", getResidentBytes(),
+               "Resident memory size in bytes.");
+    return out.str();
+}
+
+}  // namespace MediaProcessor
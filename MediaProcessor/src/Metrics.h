@@ -0,0 +1,112 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "CostModel.h"
+
+namespace MediaProcessor {
+
+constexpr size_t NUM_JOB_STAGES = 4;
+
+/**
+ * @brief Upper bounds of the step latency buckets, in seconds.
+ */
+constexpr std::array<double, 12> LATENCY_BUCKET_BOUNDS = {0.01, 0.05, 0.1, 0.25, 0.5, 1.0,
+                                                          2.5,  5.0,  10.0, 30.0, 60.0, 300.0};
+
+/**
+ * @brief Monotonically increasing count.
+ */
+class Counter {
+   public:
+    void increment(uint64_t amount = 1) {
+        m_value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    uint64_t get() const {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic<uint64_t> m_value{0};
+};
+
+/**
+ * @brief Level that goes up and down, e.g. the number of running child processes.
+ */
+class Gauge {
+   public:
+    void add(int64_t amount) {
+        m_value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    int64_t get() const {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic<int64_t> m_value{0};
+};
+
+/**
+ * @brief Distribution of durations over LATENCY_BUCKET_BOUNDS.
+ *
+ * Buckets hold per-bucket counts and are only made cumulative when rendered, so recording is
+ * a single increment.
+ */
+class Histogram {
+   public:
+    void observe(double seconds);
+
+    uint64_t getBucketCount(size_t bucket) const;  // the last bucket is +Inf
+    uint64_t getCount() const;
+    double getSum() const;
+
+   private:
+    std::array<std::atomic<uint64_t>, LATENCY_BUCKET_BOUNDS.size() + 1> m_buckets{};
+    std::atomic<double> m_sum{0.0};
+};
+
+/**
+ * @brief Process-wide operational metrics.
+ *
+ * Every update is a relaxed atomic operation, so the processing paths never take a lock to
+ * record one; a scrape reads each value independently.
+ */
+struct Metrics {
+    Gauge jobsQueued;
+    Gauge jobsInFlight;
+    Counter jobsCompleted;
+    Counter jobsFailed;
+    std::array<Histogram, NUM_JOB_STAGES> stepSeconds;  // indexed by JobStage
+
+    Counter framesFiltered;  // DeepFilterNet hops
+    Gauge inferenceWorkers;
+    Gauge filterStates;           // DFStates held by workers
+    Gauge inferenceTasksRunning;  // chunks admitted by the fair scheduler
+
+    Counter chunkCacheHits;  // chunks reused from an interrupted run
+    Counter chunkCacheMisses;
+    Counter cassetteHits;  // commands served from a command cassette
+    Counter cassetteMisses;
+
+    Gauge childProcesses;
+
+    Gauge pcmStreamSessions;    // each holds its own DFState and thread
+    Counter pcmStreamRejected;  // sessions refused because all were taken
+
+    static Metrics& getInstance();
+
+    void observeStep(JobStage stage, double seconds);
+
+    /**
+     * @brief Renders all metrics in the Prometheus text exposition format.
+     */
+    std::string render() const;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // METRICS_H
@@ -0,0 +1,72 @@
+#include "MetricsServer.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+
+#include "Metrics.h"
+
+namespace MediaProcessor {
+
+namespace {
+
+constexpr int METRICS_LISTEN_BACKLOG = 16;
+constexpr int METRICS_REQUEST_TIMEOUT_MS = 1000;
+constexpr size_t MAX_REQUEST_SIZE = 8192;
+
+void writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (result <= 0) {
+            return;
+        }
+        written += result;
+    }
+}
+
+std::string buildResponse(const std::string& status, const std::string& body) {
+    return "HTTP/1.1 " + status +
+           "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: " +
+           std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+
+}  // namespace
+
+MetricsServer::MetricsServer(std::string endpoint)
+    : m_listener(std::move(endpoint), METRICS_LISTEN_BACKLOG) {}
+
+bool MetricsServer::start() {
+    // Scrapes are answered one at a time on the accepting thread
+    return m_listener.start([](int clientFd) {
+        serve(clientFd);
+        close(clientFd);
+    });
+}
+
+void MetricsServer::serve(int clientFd) {
+    // Scrapers send the whole request at once; one that stalls is dropped
+    std::string request;
+    std::array<char, 1024> buffer;
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE) {
+        pollfd client{clientFd, POLLIN, 0};
+        if (poll(&client, 1, METRICS_REQUEST_TIMEOUT_MS) <= 0) {
+            return;
+        }
+        ssize_t bytesRead = recv(clientFd, buffer.data(), buffer.size(), 0);
+        if (bytesRead <= 0) {
+            return;
+        }
+        request.append(buffer.data(), bytesRead);
+    }
+
+    if (request.starts_with("GET /metrics ") || request.starts_with("GET /metrics?")) {
+        writeAll(clientFd, buildResponse("200 OK", Metrics::getInstance().render()));
+    } else {
+        writeAll(clientFd, buildResponse("404 Not Found", "Only /metrics is served.\n"));
+    }
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,42 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <string>
+
+#include "SocketListener.h"
+
+namespace MediaProcessor {
+
+/**
+ * @brief Serves Metrics::render() over HTTP to Prometheus scrapers.
+ *
+ * Listens on a local TCP port or a Unix socket from a single background thread and answers
+ * `GET /metrics`; every other path gets a 404. Scrapes only read the metrics, so they never
+ * hold up processing.
+ */
+class MetricsServer {
+   public:
+    /**
+     * @param endpoint `unix:<path>`, `<host>:<port>` or `<port>` (bound to 127.0.0.1).
+     */
+    explicit MetricsServer(std::string endpoint);
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * @brief Binds the endpoint and starts serving.
+     *
+     * @return true if the endpoint could be bound, false otherwise.
+     */
+    bool start();
+
+   private:
+    static void serve(int clientFd);
+
+    SocketListener m_listener;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // METRICSSERVER_H
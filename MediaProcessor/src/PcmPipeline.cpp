@@ -0,0 +1,110 @@
+#include "PcmPipeline.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace MediaProcessor {
+
+namespace {
+
+constexpr float INT16_SCALE = 32768.0f;
+
+template <typename Sample>
+inline Sample toSample(float value) {
+    if constexpr (std::is_floating_point_v<Sample>) {
+        return static_cast<Sample>(value);
+    } else {
+        // Branch-free so the loops calling this still vectorise
+        value = std::clamp(value, -INT16_SCALE, INT16_SCALE - 1.0f);
+        return static_cast<Sample>(static_cast<int32_t>(value + (value < 0.0f ? -0.5f : 0.5f)));
+    }
+}
+
+template <int Channels>
+inline int resolveChannels(int channels) {
+    if constexpr (Channels == DYNAMIC_CHANNELS) {
+        return channels;
+    } else {
+        return Channels;
+    }
+}
+
+}  // namespace
+
+template <typename Sample, int Channels>
+void PcmPipeline<Sample, Channels>::crossfade(const Sample* tail, const Sample* head,
+                                              Sample* output, size_t firstFrame,
+                                              size_t lastFrame, size_t numFrames, int channels) {
+    const int numChannels = resolveChannels<Channels>(channels);
+    const float step = 1.0f / numFrames;
+    const float lastPosition = float(numFrames - 1);
+    for (size_t frame = firstFrame; frame < lastFrame; ++frame) {
+        // Overlaps are seconds long, and int32 converts to float in SIMD where size_t does not
+        const float position = float(static_cast<int32_t>(frame));
+        const float fadeOut = (lastPosition - position) * step;
+        const float fadeIn = position * step;
+        for (int c = 0; c < numChannels; ++c) {
+            const size_t i = frame * numChannels + c;
+            output[i] = toSample<Sample>(float(tail[i]) * fadeOut + float(head[i]) * fadeIn);
+        }
+    }
+}
+
+template <typename Sample, int Channels>
+void PcmPipeline<Sample, Channels>::applyGain(Sample* samples, size_t numFrames, int channels,
+                                              float gain) {
+    const size_t numSamples = numFrames * resolveChannels<Channels>(channels);
+    for (size_t i = 0; i < numSamples; ++i) {
+        samples[i] = toSample<Sample>(float(samples[i]) * gain);
+    }
+}
+
+template <typename Sample, int Channels>
+void PcmPipeline<Sample, Channels>::toFloat(const Sample* input, float* output, size_t numFrames,
+                                            int channels) {
+    const size_t numSamples = numFrames * resolveChannels<Channels>(channels);
+    constexpr float scale = std::is_floating_point_v<Sample> ? 1.0f : 1.0f / INT16_SCALE;
+    for (size_t i = 0; i < numSamples; ++i) {
+        output[i] = float(input[i]) * scale;
+    }
+}
+
+template <typename Sample, int Channels>
+void PcmPipeline<Sample, Channels>::fromFloat(const float* input, Sample* output,
+                                              size_t numFrames, int channels) {
+    const size_t numSamples = numFrames * resolveChannels<Channels>(channels);
+    constexpr float scale = std::is_floating_point_v<Sample> ? 1.0f : INT16_SCALE;
+    for (size_t i = 0; i < numSamples; ++i) {
+        output[i] = toSample<Sample>(input[i] * scale);
+    }
+}
+
+template <typename Sample>
+PcmKernels<Sample> getPcmKernels(int channels) {
+    auto bind = []<int Channels>() {
+        using Pipeline = PcmPipeline<Sample, Channels>;
+        return PcmKernels<Sample>{&Pipeline::crossfade, &Pipeline::applyGain, &Pipeline::toFloat,
+                                  &Pipeline::fromFloat};
+    };
+
+    switch (channels) {
+        case 1:
+            return bind.template operator()<1>();
+        case 2:
+            return bind.template operator()<2>();
+        default:
+            return bind.template operator()<DYNAMIC_CHANNELS>();
+    }
+}
+
+template struct PcmPipeline<int16_t, 1>;
+template struct PcmPipeline<int16_t, 2>;
+template struct PcmPipeline<int16_t, DYNAMIC_CHANNELS>;
+template struct PcmPipeline<float, 1>;
+template struct PcmPipeline<float, 2>;
+template struct PcmPipeline<float, DYNAMIC_CHANNELS>;
+
+template PcmKernels<int16_t> getPcmKernels<int16_t>(int channels);
+template PcmKernels<float> getPcmKernels<float>(int channels);
+
+}  // namespace MediaProcessor
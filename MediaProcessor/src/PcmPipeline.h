@@ -0,0 +1,73 @@
+#ifndef PCMPIPELINE_H
+#define PCMPIPELINE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MediaProcessor {
+
+constexpr int PIPELINE_SAMPLE_RATE = 48000;  // DeepFilterNet's rate, which every stage runs at
+constexpr int PIPELINE_CHANNELS = 1;
+constexpr int DYNAMIC_CHANNELS = 0;  // layout only known at runtime; see PcmPipeline
+
+/**
+ * @brief Sample loops of the processing stages, specialised on sample type and channel layout.
+ *
+ * With `Channels` fixed, the per-frame channel loop has a constant trip count: the compiler
+ * unrolls it and vectorises across frames instead of branching on the layout for every sample.
+ * `DYNAMIC_CHANNELS` is the runtime-generic version, which takes the count from `channels`;
+ * every other instantiation ignores that argument. Buffers are interleaved, int16 samples map
+ * to floats in [-1, 1) by 1/32768 like libsndfile, and integer results round half away from
+ * zero and saturate.
+ *
+ * Only the instantiations declared below exist; getPcmKernels() picks one for a layout once
+ * per buffer.
+ */
+template <typename Sample, int Channels>
+struct PcmPipeline {
+    /**
+     * @brief Triangular crossfade from `tail` into `head` over `numFrames` frames, matching
+     *        FFmpeg's `acrossfade=c1=tri:c2=tri`, writing frames [firstFrame, lastFrame).
+     */
+    static void crossfade(const Sample* tail, const Sample* head, Sample* output,
+                          size_t firstFrame, size_t lastFrame, size_t numFrames, int channels);
+
+    /**
+     * @brief Scales `numFrames` frames in place by the linear factor `gain`.
+     */
+    static void applyGain(Sample* samples, size_t numFrames, int channels, float gain);
+
+    static void toFloat(const Sample* input, float* output, size_t numFrames, int channels);
+    static void fromFloat(const float* input, Sample* output, size_t numFrames, int channels);
+};
+
+extern template struct PcmPipeline<int16_t, 1>;
+extern template struct PcmPipeline<int16_t, 2>;
+extern template struct PcmPipeline<int16_t, DYNAMIC_CHANNELS>;
+extern template struct PcmPipeline<float, 1>;
+extern template struct PcmPipeline<float, 2>;
+extern template struct PcmPipeline<float, DYNAMIC_CHANNELS>;
+
+/**
+ * @brief The PcmPipeline entry points for one sample type, bound to a channel layout.
+ */
+template <typename Sample>
+struct PcmKernels {
+    decltype(&PcmPipeline<Sample, DYNAMIC_CHANNELS>::crossfade) crossfade;
+    decltype(&PcmPipeline<Sample, DYNAMIC_CHANNELS>::applyGain) applyGain;
+    decltype(&PcmPipeline<Sample, DYNAMIC_CHANNELS>::toFloat) toFloat;
+    decltype(&PcmPipeline<Sample, DYNAMIC_CHANNELS>::fromFloat) fromFloat;
+};
+
+/**
+ * @brief Returns the specialised kernels for mono and stereo, the generic ones otherwise.
+ */
+template <typename Sample>
+PcmKernels<Sample> getPcmKernels(int channels);
+
+extern template PcmKernels<int16_t> getPcmKernels<int16_t>(int channels);
+extern template PcmKernels<float> getPcmKernels<float>(int channels);
+
+}  // namespace MediaProcessor
+
+#endif  // PCMPIPELINE_H
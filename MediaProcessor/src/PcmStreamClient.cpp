@@ -0,0 +1,148 @@
+#include "PcmStreamClient.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "PcmPipeline.h"
+#include "PcmStreamServer.h"
+
+namespace MediaProcessor {
+
+PcmStreamClient::~PcmStreamClient() {
+    // Unmap the rings before hanging up, which ends the session on the server
+    m_input.reset();
+    m_output.reset();
+    if (m_socketFd != -1) {
+        close(m_socketFd);
+    }
+}
+
+bool PcmStreamClient::open(const fs::path& socketPath, float attenuationLimit, int timeoutMs) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (m_socketFd != -1 || socketPath.native().size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    m_socketFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (m_socketFd == -1 ||
+        connect(m_socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        std::cerr << "Error: Could not connect to " << socketPath << ": " << std::strerror(errno)
+                  << std::endl;
+        return false;
+    }
+
+    timeval timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    setsockopt(m_socketFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(m_socketFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    std::ostringstream request;
+    request << PCM_STREAM_OPEN << " " << PIPELINE_SAMPLE_RATE << " " << PIPELINE_CHANNELS << " "
+            << attenuationLimit;
+    std::string reply;
+    std::vector<std::unique_ptr<SharedPcmRing>> rings;
+    // A server with all sessions taken answers without waiting for the request, so its reply
+    // is read even if sending failed
+    sendRingMessage(m_socketFd, request.str(), {});
+    if (!receiveRingMessage(m_socketFd, reply, rings)) {
+        std::cerr << "Error: The PCM stream server at " << socketPath
+                  << " hung up or did not answer." << std::endl;
+        return false;
+    }
+
+    std::istringstream fields(reply);
+    std::string status;
+    size_t capacityFrames = 0;
+    if (!(fields >> status >> capacityFrames >> m_latency) || status != PCM_STREAM_OK ||
+        rings.size() != 2) {
+        std::cerr << "Error: The PCM stream server refused the session: " << reply << std::endl;
+        return false;
+    }
+    m_input = std::move(rings[0]);
+    m_output = std::move(rings[1]);
+    return true;
+}
+
+bool PcmStreamClient::filter(const float* input, float* output, size_t numFrames,
+                             int timeoutMs) {
+    if (!m_input || !m_output) {
+        return false;
+    }
+
+    size_t framesSent = 0, framesReceived = 0;
+    bool serverHungUp = false;
+    if (numFrames == 0) {
+        m_input->close();
+    }
+    while (framesReceived < numFrames) {
+        size_t progress = 0;
+        if (framesSent < numFrames) {
+            std::span<float> region = m_input->acquireWrite(numFrames - framesSent);
+            std::copy_n(input + framesSent, region.size(), region.data());
+            m_input->commitWrite(region.size());
+            framesSent += region.size();
+            progress += region.size();
+            if (framesSent == numFrames) {
+                m_input->close();
+            }
+        }
+
+        const bool outputClosed = m_output->isClosed();
+        std::span<const float> region = m_output->acquireRead(numFrames - framesReceived);
+        std::copy(region.begin(), region.end(), output + framesReceived);
+        m_output->commitRead(region.size());
+        framesReceived += region.size();
+        progress += region.size();
+        if (region.empty() && outputClosed) {
+            std::cerr << "Error: The PCM stream ended after " << framesReceived << " of "
+                      << numFrames << " frames." << std::endl;
+            return false;
+        }
+
+        if (progress > 0) {
+            continue;
+        }
+        std::array<pollfd, 3> fds = {pollfd{m_output->getDataEventFd(), POLLIN, 0},
+                                     pollfd{m_input->getSpaceEventFd(), POLLIN, 0},
+                                     pollfd{m_socketFd, POLLIN, 0}};
+        int ready = poll(fds.data(), fds.size(), timeoutMs);
+        // The server hangs up right after closing the output, so drain once more before failing
+        const bool hungUp = fds[2].revents & (POLLIN | POLLHUP | POLLERR);
+        if (ready == 0 || (ready < 0 && errno != EINTR) || (hungUp && serverHungUp)) {
+            std::cerr << "Error: The PCM stream server stopped responding." << std::endl;
+            return false;
+        }
+        serverHungUp = serverHungUp || hungUp;
+        if (fds[0].revents & POLLIN) {
+            SharedPcmRing::clearEvent(fds[0].fd);
+        }
+        if (fds[1].revents & POLLIN) {
+            SharedPcmRing::clearEvent(fds[1].fd);
+        }
+    }
+    return true;
+}
+
+SharedPcmRing& PcmStreamClient::getInput() {
+    return *m_input;
+}
+
+SharedPcmRing& PcmStreamClient::getOutput() {
+    return *m_output;
+}
+
+size_t PcmStreamClient::getLatency() const {
+    return m_latency;
+}
+
+}  // namespace MediaProcessor
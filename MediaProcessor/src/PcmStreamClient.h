@@ -0,0 +1,67 @@
+#ifndef PCMSTREAMCLIENT_H
+#define PCMSTREAMCLIENT_H
+
+#include <filesystem>
+#include <memory>
+
+#include "SharedPcmRing.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr int PCM_STREAM_DEFAULT_OPEN_TIMEOUT_MS = 30000;  // loading the model takes seconds
+
+/**
+ * @brief Client side of a PcmStreamServer session, for C++ services on the same host.
+ *
+ * Zero-copy callers decode straight into getInput().acquireWrite() and consume
+ * getOutput().acquireRead() in place; filter() is the simple path for a buffer already in
+ * memory.
+ */
+class PcmStreamClient {
+   public:
+    PcmStreamClient() = default;
+    ~PcmStreamClient();
+
+    PcmStreamClient(const PcmStreamClient&) = delete;
+    PcmStreamClient& operator=(const PcmStreamClient&) = delete;
+
+    /**
+     * @brief Connects to the server at `socketPath` and opens a mono 48 kHz session.
+     *
+     * @param timeoutMs Longest wait for the server's answer.
+     * @return true once the session's rings are mapped, false if the server refused it (e.g.
+     *         `ERROR busy` with all sessions taken) or did not answer in time.
+     */
+    bool open(const fs::path& socketPath, float attenuationLimit,
+              int timeoutMs = PCM_STREAM_DEFAULT_OPEN_TIMEOUT_MS);
+
+    /**
+     * @brief Streams `numFrames` frames through the session and closes its input.
+     *
+     * Writes and reads alternate, so buffers longer than the rings do not deadlock.
+     *
+     * @param timeoutMs Longest wait for the server to make progress; -1 waits forever.
+     * @return true once all `numFrames` filtered frames are in `output`.
+     */
+    bool filter(const float* input, float* output, size_t numFrames, int timeoutMs = -1);
+
+    SharedPcmRing& getInput();   // frames for the server; close() it after the last one
+    SharedPcmRing& getOutput();  // filtered frames, aligned with the input
+
+    /**
+     * @brief Frames the server holds back: a hop of buffering plus the model's own delay.
+     */
+    size_t getLatency() const;
+
+   private:
+    int m_socketFd = -1;
+    std::unique_ptr<SharedPcmRing> m_input;
+    std::unique_ptr<SharedPcmRing> m_output;
+    size_t m_latency = 0;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // PCMSTREAMCLIENT_H
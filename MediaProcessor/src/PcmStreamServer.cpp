@@ -0,0 +1,288 @@
+#include "PcmStreamServer.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "Metrics.h"
+#include "PcmPipeline.h"
+#include "Utils.h"
+
+namespace MediaProcessor {
+
+namespace {
+
+constexpr int PCM_STREAM_LISTEN_BACKLOG = 16;
+constexpr int PCM_STREAM_OPEN_TIMEOUT_SECONDS = 30;  // a client must send OPEN within this
+
+/**
+ * @brief Sends `ERROR <reason>`; the caller closes the connection afterwards.
+ */
+void sendError(int clientFd, const std::string& reason) {
+    sendRingMessage(clientFd, std::string(PCM_STREAM_ERROR) + " " + reason, {});
+}
+
+}  // namespace
+
+PcmStreamServer::PcmStreamServer(fs::path socketPath, fs::path modelPath, size_t maxSessions,
+                                 size_t ringFrames)
+    : m_socketPath(std::move(socketPath)),
+      m_modelPath(std::move(modelPath)),
+      m_maxSessions(std::max<size_t>(maxSessions, 1)),
+      m_ringFrames(std::max<size_t>(ringFrames, 1)),
+      m_sessionThreads(std::make_unique<ThreadPool>(m_maxSessions)) {}
+
+PcmStreamServer::~PcmStreamServer() {
+    if (m_acceptThread.joinable()) {
+        m_stop.store(true);
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        m_acceptThread.join();
+    }
+    // Sessions watch the wake eventfd, so they must be gone before it is closed
+    m_sessionThreads.reset();
+
+    if (m_listenFd != -1) {
+        close(m_listenFd);
+        unlink(m_socketPath.c_str());
+    }
+    if (m_wakeFd != -1) {
+        close(m_wakeFd);
+    }
+}
+
+bool PcmStreamServer::start() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (m_socketPath.native().size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: PCM stream socket path is too long: " << m_socketPath << std::endl;
+        return false;
+    }
+    std::strcpy(address.sun_path, m_socketPath.c_str());
+
+    // A socket left behind by a previous run would make bind() fail
+    std::error_code ec;
+    if (fs::is_socket(m_socketPath, ec)) {
+        fs::remove(m_socketPath, ec);
+    }
+
+    m_listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (m_listenFd == -1 ||
+        bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+        listen(m_listenFd, PCM_STREAM_LISTEN_BACKLOG) == -1) {
+        std::cerr << "Error: Could not listen on " << m_socketPath << ": " << std::strerror(errno)
+                  << std::endl;
+        if (m_listenFd != -1) {
+            close(m_listenFd);
+            m_listenFd = -1;
+        }
+        return false;
+    }
+
+    m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeFd == -1) {
+        return false;
+    }
+    m_acceptThread = std::thread([this]() { acceptLoop(); });
+    return true;
+}
+
+void PcmStreamServer::acceptLoop() {
+    // Refused connections stay open until their client hangs up: closing a socket with the
+    // client's request still unread would reset the connection and lose the refusal
+    std::deque<int> refusedFds;
+    std::vector<pollfd> fds;
+    while (!m_stop.load()) {
+        fds = {pollfd{m_listenFd, POLLIN, 0}, pollfd{m_wakeFd, POLLIN, 0}};
+        for (int refusedFd : refusedFds) {
+            fds.push_back(pollfd{refusedFd, POLLIN, 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) <= 0) {
+            continue;
+        }
+
+        for (size_t i = 2; i < fds.size(); ++i) {
+            char buffer[MAX_RING_MESSAGE_SIZE];
+            if (fds[i].revents && recv(fds[i].fd, buffer, sizeof(buffer), MSG_DONTWAIT) <= 0) {
+                close(fds[i].fd);
+                std::erase(refusedFds, fds[i].fd);
+            }
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        int clientFd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (clientFd == -1) {
+            continue;
+        }
+        timeval timeout{PCM_STREAM_OPEN_TIMEOUT_SECONDS, 0};
+        setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        // Only this thread adds sessions, so the count cannot pass the limit meanwhile
+        Metrics& metrics = Metrics::getInstance();
+        if (m_activeSessions.load() >= m_maxSessions) {
+            metrics.pcmStreamRejected.increment();
+            sendError(clientFd, PCM_STREAM_BUSY);
+            shutdown(clientFd, SHUT_WR);
+            if (refusedFds.size() == static_cast<size_t>(PCM_STREAM_LISTEN_BACKLOG)) {
+                close(refusedFds.front());
+                refusedFds.pop_front();
+            }
+            refusedFds.push_back(clientFd);
+            continue;
+        }
+        m_activeSessions++;
+        metrics.pcmStreamSessions.add(1);
+        m_sessionThreads->post([this, clientFd]() {
+            if (!m_stop.load()) {
+                serveSession(clientFd);
+            }
+            close(clientFd);
+            Metrics::getInstance().pcmStreamSessions.add(-1);
+            m_activeSessions--;
+        });
+    }
+
+    for (int refusedFd : refusedFds) {
+        close(refusedFd);
+    }
+}
+
+void PcmStreamServer::serveSession(int clientFd) {
+    std::string request;
+    std::vector<std::unique_ptr<SharedPcmRing>> unexpectedRings;
+    if (!receiveRingMessage(clientFd, request, unexpectedRings)) {
+        return;
+    }
+
+    std::istringstream fields(request);
+    std::string command;
+    uint32_t sampleRate = 0, channels = 0;
+    float attenuationLimit = 0.0f;
+    if (!(fields >> command >> sampleRate >> channels >> attenuationLimit) ||
+        command != PCM_STREAM_OPEN) {
+        sendError(clientFd, "expected OPEN <sample_rate> <channels> <attenuation_limit>");
+        return;
+    }
+    if (sampleRate != PIPELINE_SAMPLE_RATE || channels != PIPELINE_CHANNELS) {
+        sendError(clientFd, "only " + std::to_string(PIPELINE_CHANNELS) + " channel at " +
+                                std::to_string(PIPELINE_SAMPLE_RATE) + " Hz is supported");
+        return;
+    }
+    if (!Utils::isWithinRange(attenuationLimit, 0.0f, 100.0f)) {
+        sendError(clientFd, "attenuation limit must be within [0, 100]");
+        return;
+    }
+
+    std::unique_ptr<DeepFilterStream> stream;
+    try {
+        stream = std::make_unique<DeepFilterStream>(m_modelPath, attenuationLimit);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        sendError(clientFd, "the model could not be loaded");
+        return;
+    }
+    auto input = SharedPcmRing::create(m_ringFrames, channels, sampleRate);
+    auto output = SharedPcmRing::create(m_ringFrames, channels, sampleRate);
+    if (!input || !output) {
+        sendError(clientFd, "shared memory could not be allocated");
+        return;
+    }
+
+    std::ostringstream reply;
+    reply << PCM_STREAM_OK << " " << m_ringFrames << " " << stream->getLatency();
+    if (!sendRingMessage(clientFd, reply.str(), {input.get(), output.get()})) {
+        return;
+    }
+    runSession(clientFd, *input, *output, *stream);
+}
+
+bool PcmStreamServer::runSession(int clientFd, SharedPcmRing& input, SharedPcmRing& output,
+                                 DeepFilterStream& stream) {
+    // Frames the model still owes: its delay is dropped up front and flushed with silence at the
+    // end, so the client gets exactly one output frame per input frame
+    const size_t latency = stream.getLatency();
+    FrameBuffer silence(latency, 0.0f);
+    FrameBuffer discarded(latency);
+    size_t framesToDiscard = latency;
+    size_t framesToFlush = latency;
+    Counter& framesFiltered = Metrics::getInstance().framesFiltered;
+    auto onHop = [&framesFiltered](float, const float*) { framesFiltered.increment(); };
+
+    auto filterInto = [&](const float* samples, size_t numFrames) -> size_t {
+        if (framesToDiscard > 0) {
+            size_t count = std::min(numFrames, framesToDiscard);
+            stream.process(samples, discarded.data(), count, onHop);
+            framesToDiscard -= count;
+            return count;
+        }
+        std::span<float> region = output.acquireWrite(numFrames);
+        stream.process(samples, region.data(), region.size(), onHop);
+        output.commitWrite(region.size());
+        return region.size();
+    };
+
+    while (true) {
+        // Checked before reading, so an empty ring after it means the input really ended
+        const bool inputClosed = input.isClosed();
+        std::span<const float> region = input.acquireRead();
+        size_t progress = 0;
+        if (!region.empty()) {
+            progress = filterInto(region.data(), region.size());
+            input.commitRead(progress);
+        } else if (inputClosed && framesToFlush > 0) {
+            progress = filterInto(silence.data(), framesToFlush);
+            framesToFlush -= progress;
+        } else if (inputClosed) {
+            output.close();
+            return true;
+        }
+
+        if (progress == 0 && !waitForSession(clientFd, input, output)) {
+            return false;
+        }
+    }
+}
+
+bool PcmStreamServer::waitForSession(int clientFd, const SharedPcmRing& input,
+                                     const SharedPcmRing& output) {
+    std::array<pollfd, 4> fds = {pollfd{clientFd, POLLIN, 0},
+                                 pollfd{input.getDataEventFd(), POLLIN, 0},
+                                 pollfd{output.getSpaceEventFd(), POLLIN, 0},
+                                 pollfd{m_wakeFd, POLLIN, 0}};
+    while (poll(fds.data(), fds.size(), -1) < 0) {
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+
+    // Nothing but a hang-up is expected on the socket once the session runs
+    if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+        char byte;
+        if (recv(clientFd, &byte, sizeof(byte), MSG_DONTWAIT) <= 0) {
+            return false;
+        }
+    }
+    if (fds[1].revents & POLLIN) {
+        SharedPcmRing::clearEvent(fds[1].fd);
+    }
+    if (fds[2].revents & POLLIN) {
+        SharedPcmRing::clearEvent(fds[2].fd);
+    }
+    return !m_stop.load();
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,94 @@
+#ifndef PCMSTREAMSERVER_H
+#define PCMSTREAMSERVER_H
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "DeepFilterStream.h"
+#include "SharedPcmRing.h"
+#include "ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr const char* PCM_STREAM_OPEN = "OPEN";
+constexpr const char* PCM_STREAM_OK = "OK";
+constexpr const char* PCM_STREAM_ERROR = "ERROR";
+constexpr const char* PCM_STREAM_BUSY = "busy";
+
+/**
+ * @brief Isolates vocals in PCM that co-located processes hand over in shared memory.
+ *
+ * Control messages travel as packets over a SOCK_SEQPACKET Unix socket:
+ *  - the client sends `OPEN <sample_rate> <channels> <attenuation_limit>`;
+ *  - the server answers `OK <capacity_frames> <latency_frames>` with six descriptors attached
+ *    (memfd, data eventfd and space eventfd of the input ring, then of the output ring), or
+ *    `ERROR <reason>` and closes the connection; `ERROR busy` when all sessions are taken.
+ *
+ * The client then writes float frames into the input ring and reads the filtered ones from the
+ * output ring, both laid out as in SharedPcmRingHeader. Output is aligned with the input: the
+ * model's delay is trimmed from the start and flushed after the client closes the input ring,
+ * after which the server closes the output ring. Closing the socket abandons the session.
+ *
+ * Each session holds a connection thread and a DFState of its own, outside the runtime's
+ * inference workers and fair scheduler; Metrics counts the open and the refused sessions and
+ * the frames filtered. Connections beyond `maxSessions` are refused right away rather than
+ * queued, so a client can fall back to the file pipeline.
+ */
+class PcmStreamServer {
+   public:
+    /**
+     * @param ringFrames Capacity of each session's input and output ring.
+     */
+    PcmStreamServer(fs::path socketPath, fs::path modelPath, size_t maxSessions,
+                    size_t ringFrames);
+    ~PcmStreamServer();
+
+    PcmStreamServer(const PcmStreamServer&) = delete;
+    PcmStreamServer& operator=(const PcmStreamServer&) = delete;
+
+    /**
+     * @brief Binds the socket, replacing a stale one at the path, and starts accepting.
+     *
+     * @return true if the socket could be bound, false otherwise.
+     */
+    bool start();
+
+   private:
+    void acceptLoop();
+    void serveSession(int clientFd);
+
+    /**
+     * @brief Filters the input ring into the output ring until the input is drained.
+     *
+     * @return false if the client hung up or the server stopped first.
+     */
+    bool runSession(int clientFd, SharedPcmRing& input, SharedPcmRing& output,
+                    DeepFilterStream& stream);
+
+    /**
+     * @brief Blocks until the session's rings or socket change.
+     *
+     * @return false if the client hung up or the server is stopping.
+     */
+    bool waitForSession(int clientFd, const SharedPcmRing& input, const SharedPcmRing& output);
+
+    fs::path m_socketPath;
+    fs::path m_modelPath;
+    size_t m_maxSessions;
+    size_t m_ringFrames;
+    std::atomic<size_t> m_activeSessions{0};
+    std::unique_ptr<ThreadPool> m_sessionThreads;
+    int m_listenFd = -1;
+    int m_wakeFd = -1;
+    std::atomic<bool> m_stop{false};
+    std::thread m_acceptThread;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // PCMSTREAMSERVER_H
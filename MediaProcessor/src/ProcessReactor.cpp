@@ -0,0 +1,209 @@
+#include "ProcessReactor.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "Metrics.h"
+#include "Utils.h"
+
+namespace MediaProcessor {
+
+namespace {
+
+constexpr int REACTOR_POLL_INTERVAL_MS = 20;
+constexpr uint64_t WAKE_EVENT_ID = 0;  // never a valid pid
+constexpr size_t MAX_EPOLL_EVENTS = 32;
+
+}  // namespace
+
+ProcessReactor::CommandAwaiter::CommandAwaiter(ProcessReactor& reactor, std::string command,
+                                               bool mergeStderr, CancellationToken token)
+    : m_reactor(reactor),
+      m_command(std::move(command)),
+      m_mergeStderr(mergeStderr),
+      m_token(std::move(token)) {}
+
+bool ProcessReactor::CommandAwaiter::await_suspend(std::coroutine_handle<> continuation) {
+    if (m_token.isCancelled()) {
+        m_outcome.cancelled = true;
+        return false;
+    }
+
+    std::optional<Utils::ChildProcess> child = Utils::spawnShellCommand(m_command, m_mergeStderr);
+    if (!child) {
+        return false;  // resume immediately with launched == false
+    }
+    m_outcome.launched = true;
+    Metrics::getInstance().childProcesses.add(1);
+    fcntl(child->outputFd, F_SETFL, fcntl(child->outputFd, F_GETFL) | O_NONBLOCK);
+
+    // Nothing may touch *this after handing over: the reactor can resume us at any point
+    m_reactor.watch({child->pid, child->outputFd, true, m_token, std::nullopt, &m_outcome,
+                     continuation});
+    return true;
+}
+
+ProcessReactor::ProcessReactor(ThreadPool& executor)
+    : m_executor(executor),
+      m_epollFd(epoll_create1(EPOLL_CLOEXEC)),
+      m_wakeFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+    if (m_epollFd == -1 || m_wakeFd == -1) {
+        throw std::runtime_error("Failed to set up the process reactor.");
+    }
+
+    epoll_event wakeEvent{};
+    wakeEvent.events = EPOLLIN;
+    wakeEvent.data.u64 = WAKE_EVENT_ID;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &wakeEvent);
+
+    m_thread = std::thread([this]() { loop(); });
+}
+
+ProcessReactor::~ProcessReactor() {
+    m_stop.store(true);
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(m_wakeFd, &one, sizeof(one));
+    m_thread.join();
+
+    close(m_wakeFd);
+    close(m_epollFd);
+}
+
+ProcessReactor::CommandAwaiter ProcessReactor::run(std::string command, bool mergeStderr,
+                                                   CancellationToken token) {
+    return CommandAwaiter(*this, std::move(command), mergeStderr, std::move(token));
+}
+
+void ProcessReactor::watch(WatchedProcess process) {
+    {
+        std::lock_guard<std::mutex> lock(m_incomingMutex);
+        m_incoming.push_back(std::move(process));
+    }
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(m_wakeFd, &one, sizeof(one));
+}
+
+void ProcessReactor::loop() {
+    std::unordered_map<pid_t, WatchedProcess> active;
+    std::array<epoll_event, MAX_EPOLL_EVENTS> events;
+
+    while (true) {
+        int timeout = active.empty() ? -1 : REACTOR_POLL_INTERVAL_MS;
+        int numEvents = epoll_wait(m_epollFd, events.data(), events.size(), timeout);
+
+        for (int i = 0; i < numEvents; ++i) {
+            if (events[i].data.u64 == WAKE_EVENT_ID) {
+                uint64_t counter;
+                [[maybe_unused]] ssize_t bytesRead = read(m_wakeFd, &counter, sizeof(counter));
+                continue;
+            }
+
+            auto it = active.find(static_cast<pid_t>(events[i].data.u64));
+            if (it != active.end()) {
+                readOutput(it->second);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_incomingMutex);
+            for (auto& process : m_incoming) {
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.u64 = static_cast<uint64_t>(process.pid);
+                epoll_ctl(m_epollFd, EPOLL_CTL_ADD, process.outputFd, &event);
+                active.emplace(process.pid, std::move(process));
+            }
+            m_incoming.clear();
+        }
+
+        bool stopping = m_stop.load();
+        for (auto it = active.begin(); it != active.end();) {
+            if (reapIfFinished(it->second, stopping)) {
+                Metrics::getInstance().childProcesses.add(-1);
+                resume(it->second.continuation);
+                it = active.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (stopping && active.empty()) {
+            return;
+        }
+    }
+}
+
+void ProcessReactor::readOutput(WatchedProcess& process) {
+    std::array<char, 4096> buffer;
+    while (process.outputOpen) {
+        ssize_t bytesRead = read(process.outputFd, buffer.data(), buffer.size());
+        if (bytesRead > 0) {
+            process.outcome->output.append(buffer.data(), bytesRead);
+        } else if (bytesRead == -1 && (errno == EAGAIN || errno == EINTR)) {
+            return;
+        } else {
+            closeOutput(process);  // EOF or a broken pipe
+        }
+    }
+}
+
+void ProcessReactor::closeOutput(WatchedProcess& process) {
+    if (!process.outputOpen) {
+        return;
+    }
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, process.outputFd, nullptr);
+    close(process.outputFd);
+    process.outputOpen = false;
+}
+
+bool ProcessReactor::reapIfFinished(WatchedProcess& process, bool stopping) {
+    auto now = CancellationToken::Clock::now();
+
+    if (!process.killDeadline && (stopping || process.token.isCancelled())) {
+        kill(-process.pid, SIGTERM);
+        process.killDeadline = now + Utils::CHILD_TERMINATION_GRACE_PERIOD;
+        process.outcome->cancelled = true;
+    } else if (process.killDeadline && now >= *process.killDeadline) {
+        kill(-process.pid, SIGKILL);
+    }
+
+    // Drain all output before reaping unless we are tearing the child down anyway
+    if (process.outputOpen && !process.killDeadline) {
+        return false;
+    }
+
+    int status = 0;
+    pid_t waited = waitpid(process.pid, &status, WNOHANG);
+    if (waited == 0 || (waited == -1 && errno == EINTR)) {
+        return false;
+    }
+
+    closeOutput(process);
+    if (waited == -1) {
+        process.outcome->returnCode = -1;
+    } else if (WIFEXITED(status)) {
+        process.outcome->returnCode = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        process.outcome->returnCode = 128 + WTERMSIG(status);
+    }
+    return true;
+}
+
+void ProcessReactor::resume(std::coroutine_handle<> continuation) {
+    try {
+        m_executor.post([continuation]() { continuation.resume(); });
+    } catch (const std::runtime_error&) {
+        continuation.resume();  // executor already stopped
+    }
+}
+
+}  // namespace MediaProcessor
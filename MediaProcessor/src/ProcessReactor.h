@@ -0,0 +1,110 @@
+#ifndef PROCESSREACTOR_H
+#define PROCESSREACTOR_H
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "ThreadPool.h"
+
+namespace MediaProcessor {
+
+/**
+ * @brief Result of a command awaited through the ProcessReactor.
+ */
+struct CommandOutcome {
+    bool launched = false;
+    bool cancelled = false;
+    int returnCode = -1;
+    std::string output;
+};
+
+/**
+ * @brief Waits on child processes from a single background thread.
+ *
+ * Coroutines awaiting a command are suspended while the child runs, so waiting on FFmpeg does
+ * not occupy a worker. The reactor collects output with epoll, reaps the child, and resumes
+ * the awaiting coroutine on the executor. Cancelled children are terminated without blocking
+ * the reactor: SIGTERM first, SIGKILL once the grace period has passed.
+ */
+class ProcessReactor {
+   public:
+    /**
+     * @brief Awaitable returned by run(); resolves to the command's CommandOutcome.
+     */
+    class CommandAwaiter {
+       public:
+        CommandAwaiter(ProcessReactor& reactor, std::string command, bool mergeStderr,
+                       CancellationToken token);
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+        bool await_suspend(std::coroutine_handle<> continuation);
+        CommandOutcome await_resume() {
+            return std::move(m_outcome);
+        }
+
+       private:
+        ProcessReactor& m_reactor;
+        std::string m_command;
+        bool m_mergeStderr;
+        CancellationToken m_token;
+        CommandOutcome m_outcome;
+    };
+
+    /**
+     * @param executor Pool on which awaiting coroutines are resumed.
+     */
+    explicit ProcessReactor(ThreadPool& executor);
+    ~ProcessReactor();
+
+    ProcessReactor(const ProcessReactor&) = delete;
+    ProcessReactor& operator=(const ProcessReactor&) = delete;
+
+    /**
+     * @brief Starts `command` through `/bin/sh` once awaited.
+     *
+     * @param mergeStderr Capture stderr together with stdout.
+     */
+    CommandAwaiter run(std::string command, bool mergeStderr, CancellationToken token);
+
+   private:
+    struct WatchedProcess {
+        pid_t pid;
+        int outputFd;
+        bool outputOpen;
+        CancellationToken token;
+        std::optional<CancellationToken::Clock::time_point> killDeadline;
+        CommandOutcome* outcome;
+        std::coroutine_handle<> continuation;
+    };
+
+    void watch(WatchedProcess process);
+    void loop();
+    void readOutput(WatchedProcess& process);
+    void closeOutput(WatchedProcess& process);
+    bool reapIfFinished(WatchedProcess& process, bool stopping);
+    void resume(std::coroutine_handle<> continuation);
+
+    ThreadPool& m_executor;
+    int m_epollFd;
+    int m_wakeFd;
+
+    std::mutex m_incomingMutex;
+    std::vector<WatchedProcess> m_incoming;
+    std::atomic<bool> m_stop{false};
+
+    std::thread m_thread;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // PROCESSREACTOR_H
@@ -0,0 +1,98 @@
+#include "RenditionEncoder.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "CommandBuilder.h"
+#include "CommandExecutor.h"
+#include "Utils.h"
+
+namespace MediaProcessor {
+
+RenditionEncoder::RenditionEncoder(const fs::path& processedAudioPath,
+                                   std::vector<Rendition> renditions,
+                                   const CancellationToken& cancellationToken)
+    : m_processedAudioPath(fs::absolute(processedAudioPath)),
+      m_renditions(std::move(renditions)),
+      m_ffmpegPath(ConfigManager::getInstance().getFFmpegPath()),
+      m_codecThreads(ConfigManager::getInstance().getResourceBudget().codecThreads),
+      m_cancellationToken(cancellationToken) {}
+
+bool RenditionEncoder::encode() {
+    AsyncRuntime runtime(1);
+    if (!installCommandCassette(runtime, ConfigManager::getInstance().getCommandCassette())) {
+        return false;
+    }
+    return syncWait(encodeAsync(runtime));
+}
+
+Task<bool> RenditionEncoder::encodeAsync(AsyncRuntime& runtime) {
+    if (m_renditions.empty()) {
+        co_return true;
+    }
+
+    std::cout << "Encoding " << m_renditions.size() << " rendition(s)..." << std::endl;
+
+    CancellationToken stageToken = m_cancellationToken.withTimeout(
+        ConfigManager::getInstance().getStageTimeout("encode_renditions"));
+    auto start = std::chrono::steady_clock::now();
+    if (!co_await runtime.runCommand(buildCommand(), stageToken)) {
+        std::cerr << "Error: Failed to encode renditions using FFmpeg." << std::endl;
+        co_return false;
+    }
+
+    // Not part of the cost model's prediction, so it is measured but not tracked in the ETA
+    if (m_progress) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        m_progress->completeStep(JobStage::Encode, elapsed.count(), 0.0, "renditions");
+    }
+
+    for (const auto& outputPath : getOutputPaths()) {
+        std::cout << "Rendition written: " << outputPath << std::endl;
+    }
+    co_return true;
+}
+
+std::string RenditionEncoder::buildCommand() const {
+    CommandBuilder cmd;
+    cmd.addArgument(m_ffmpegPath.string());
+    cmd.addFlag("-y");
+    Utils::addFFmpegThreads(cmd, m_codecThreads);
+    cmd.addFlag("-i", m_processedAudioPath.string());
+
+    // Output options apply to the output file that follows them
+    std::vector<fs::path> outputPaths = getOutputPaths();
+    for (size_t i = 0; i < m_renditions.size(); ++i) {
+        const Rendition& rendition = m_renditions[i];
+        cmd.addFlag("-map", "0:a:0");
+        cmd.addFlag("-c:a", rendition.codec);
+        if (!rendition.bitrate.empty()) {
+            cmd.addFlag("-b:a", rendition.bitrate);
+        }
+        if (rendition.sampleRate > 0) {
+            cmd.addFlag("-ar", std::to_string(rendition.sampleRate));
+        }
+        if (rendition.channels > 0) {
+            cmd.addFlag("-ac", std::to_string(rendition.channels));
+        }
+        Utils::addFFmpegThreads(cmd, m_codecThreads);
+        cmd.addArgument(outputPaths[i].string());
+    }
+
+    return cmd.build();
+}
+
+void RenditionEncoder::setProgress(JobProgress* progress) {
+    m_progress = progress;
+}
+
+std::vector<fs::path> RenditionEncoder::getOutputPaths() const {
+    std::vector<fs::path> outputPaths;
+    for (const auto& rendition : m_renditions) {
+        outputPaths.push_back(Utils::prepareRenditionPath(m_processedAudioPath, rendition.name,
+                                                          rendition.extension));
+    }
+    return outputPaths;
+}
+
+}  // namespace MediaProcessor
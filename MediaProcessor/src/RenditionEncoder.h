@@ -0,0 +1,69 @@
+#ifndef RENDITIONENCODER_H
+#define RENDITIONENCODER_H
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "AsyncRuntime.h"
+#include "AsyncTask.h"
+#include "CancellationToken.h"
+#include "ConfigManager.h"
+#include "CostModel.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+/**
+ * @brief Encodes the processed audio into all configured renditions in a single pass.
+ *
+ * One FFmpeg process decodes the processed audio once and fans it out to an encoder per
+ * rendition, resampling and downmixing per output where the rendition asks for it. Every
+ * rendition is written to its own file next to the processed audio.
+ */
+class RenditionEncoder {
+   public:
+    /**
+     * @param cancellationToken Cancelling it terminates a running encode.
+     */
+    RenditionEncoder(const fs::path& processedAudioPath, std::vector<Rendition> renditions,
+                     const CancellationToken& cancellationToken = CancellationToken());
+
+    /**
+     * @brief Encodes all renditions.
+     *
+     * @return true if every rendition was written (or none is configured), false otherwise.
+     */
+    bool encode();
+
+    /**
+     * @brief Coroutine form of encode(); the FFmpeg wait is parked on the runtime's reactor.
+     */
+    Task<bool> encodeAsync(AsyncRuntime& runtime);
+
+    /**
+     * @brief Builds the single FFmpeg command producing every rendition.
+     */
+    std::string buildCommand() const;
+
+    std::vector<fs::path> getOutputPaths() const;
+
+    /**
+     * @brief Reports the encode time to `progress` as part of the job's encode stage; nullptr
+     *        disables it.
+     */
+    void setProgress(JobProgress* progress);
+
+   private:
+    fs::path m_processedAudioPath;
+    std::vector<Rendition> m_renditions;
+    fs::path m_ffmpegPath;
+    unsigned int m_codecThreads;
+    CancellationToken m_cancellationToken;
+    JobProgress* m_progress = nullptr;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // RENDITIONENCODER_H
@@ -0,0 +1,66 @@
+#include "RuntimeServices.h"
+
+#include <iostream>
+
+#include "CommandExecutor.h"
+
+namespace MediaProcessor {
+
+std::unique_ptr<AsyncRuntime> createRuntime(ConfigManager& configManager) {
+    ResourceBudget budget = configManager.getResourceBudget();
+    auto runtime = std::make_unique<AsyncRuntime>(
+        ElasticLimits{budget.minInferenceWorkers, budget.inferenceWorkers,
+                      budget.workerIdleTimeout},
+        budget.ioThreads,
+        WorkerScheduling{{budget.workerSpinTime, budget.workerYieldTime},
+                         budget.inferencePriority});
+    if (!installCommandCassette(*runtime, configManager.getCommandCassette())) {
+        return nullptr;
+    }
+    runtime->getFairScheduler().setWeights(configManager.getTenantWeights());
+    return runtime;
+}
+
+std::unique_ptr<RuntimeServices> RuntimeServices::create(ConfigManager& configManager,
+                                                         bool loadCostModel) {
+    std::unique_ptr<RuntimeServices> services(new RuntimeServices());
+
+    services->m_costModelPath = configManager.getCostModelPath();
+    if (loadCostModel && !services->m_costModel.load(services->m_costModelPath)) {
+        std::cout << "INFO: no cost model at " << services->m_costModelPath
+                  << ", using uncalibrated defaults." << std::endl;
+    }
+
+    const std::string metricsEndpoint = configManager.getMetricsEndpoint();
+    if (!metricsEndpoint.empty()) {
+        services->m_metricsServer = std::make_unique<MetricsServer>(metricsEndpoint);
+        if (!services->m_metricsServer->start()) {
+            return nullptr;
+        }
+        std::cout << "INFO: serving metrics on " << metricsEndpoint << "." << std::endl;
+    }
+
+    services->m_runtime = createRuntime(configManager);
+    if (!services->m_runtime) {
+        return nullptr;
+    }
+    return services;
+}
+
+AsyncRuntime& RuntimeServices::getRuntime() {
+    return *m_runtime;
+}
+
+CostModel& RuntimeServices::getCostModel() {
+    return m_costModel;
+}
+
+bool RuntimeServices::saveCostModel() const {
+    if (m_costModel.getNumObservations() == 0 || m_costModel.save(m_costModelPath)) {
+        return true;
+    }
+    std::cerr << "Warning: Could not save the cost model to " << m_costModelPath << std::endl;
+    return false;
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,70 @@
+#ifndef RUNTIMESERVICES_H
+#define RUNTIMESERVICES_H
+
+#include <filesystem>
+#include <memory>
+
+#include "AsyncRuntime.h"
+#include "ConfigManager.h"
+#include "CostModel.h"
+#include "MetricsServer.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+/**
+ * @brief Builds the AsyncRuntime the configuration asks for.
+ *
+ * Sizes the worker and IO pools and the idle and priority scheduling from `ResourceBudget`,
+ * then installs the command cassette and the tenant weights. Every mode builds its runtime
+ * here, so a new budget or scheduling option is wired once.
+ *
+ * @return The runtime, or nullptr if the command cassette could not be installed.
+ */
+std::unique_ptr<AsyncRuntime> createRuntime(ConfigManager& configManager);
+
+/**
+ * @brief What the long-running modes share: the host's cost model, the metrics endpoint and a
+ *        runtime from createRuntime().
+ */
+class RuntimeServices {
+   public:
+    /**
+     * @brief Loads the cost model, starts serving metrics if configured and builds the runtime.
+     *
+     * The configuration must already be loaded.
+     *
+     * @param loadCostModel false to start from an uncalibrated model, e.g. to recalibrate it.
+     * @return The services, or nullptr if the metrics endpoint could not be bound or the
+     *         runtime not built.
+     */
+    static std::unique_ptr<RuntimeServices> create(ConfigManager& configManager,
+                                                   bool loadCostModel = true);
+
+    RuntimeServices(const RuntimeServices&) = delete;
+    RuntimeServices& operator=(const RuntimeServices&) = delete;
+
+    AsyncRuntime& getRuntime();
+    CostModel& getCostModel();
+
+    /**
+     * @brief Saves the cost model to `cost_model_path` if it learned anything.
+     *
+     * @return false if it could not be written, after a warning.
+     */
+    bool saveCostModel() const;
+
+   private:
+    RuntimeServices() = default;
+
+    CostModel m_costModel;
+    fs::path m_costModelPath;
+    // Declared before the runtime, so the last scrape still sees the workers winding down
+    std::unique_ptr<MetricsServer> m_metricsServer;
+    std::unique_ptr<AsyncRuntime> m_runtime;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // RUNTIMESERVICES_H
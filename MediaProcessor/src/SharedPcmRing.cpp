@@ -0,0 +1,343 @@
+#include "SharedPcmRing.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace MediaProcessor {
+
+namespace {
+
+constexpr size_t SAMPLES_OFFSET = 4096;  // the header gets a page, keeping samples page-aligned
+constexpr size_t FDS_PER_RING = 3;
+constexpr size_t MAX_MESSAGE_FDS = MAX_RINGS_PER_MESSAGE * FDS_PER_RING;
+
+static_assert(sizeof(SharedPcmRingHeader) <= SAMPLES_OFFSET);
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free &&
+                  std::atomic_ref<uint32_t>::is_always_lock_free,
+              "The ring's counters are shared between processes and must not need a lock");
+
+/**
+ * @brief Computes the bytes mapped for a ring; false if they overflow, e.g. for a forged header.
+ */
+bool getMappingSize(uint64_t capacityFrames, uint32_t channels, size_t& mappingSize) {
+    if (channels == 0 || capacityFrames > (SIZE_MAX - SAMPLES_OFFSET) / channels / sizeof(float)) {
+        return false;
+    }
+    mappingSize = SAMPLES_OFFSET + capacityFrames * channels * sizeof(float);
+    return true;
+}
+
+void closeAll(std::initializer_list<int> fds) {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+void signalEvent(int eventFd) {
+    uint64_t one = 1;
+    while (write(eventFd, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<SharedPcmRing> SharedPcmRing::create(size_t capacityFrames, uint32_t channels,
+                                                     uint32_t sampleRate) {
+    size_t mappingSize = 0;
+    if (capacityFrames == 0 || !getMappingSize(capacityFrames, channels, mappingSize)) {
+        std::cerr << "Error: A PCM ring needs at least one frame of one channel, and fewer "
+                     "than fit into memory."
+                  << std::endl;
+        return nullptr;
+    }
+
+    int memoryFd = memfd_create("mediaprocessor-pcm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    int dataEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    int spaceEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (memoryFd < 0 || dataEventFd < 0 || spaceEventFd < 0 ||
+        ftruncate(memoryFd, static_cast<off_t>(mappingSize)) != 0 ||
+        fcntl(memoryFd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        std::cerr << "Error: Could not create a shared PCM ring: " << std::strerror(errno)
+                  << std::endl;
+        closeAll({memoryFd, dataEventFd, spaceEventFd});
+        return nullptr;
+    }
+
+    void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, memoryFd, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: Could not map a shared PCM ring: " << std::strerror(errno)
+                  << std::endl;
+        closeAll({memoryFd, dataEventFd, spaceEventFd});
+        return nullptr;
+    }
+
+    // A new memfd reads as zeros, so the counters and the closed flag start cleared
+    auto* header = static_cast<SharedPcmRingHeader*>(mapping);
+    header->magic = SHARED_PCM_RING_MAGIC;
+    header->version = SHARED_PCM_RING_VERSION;
+    header->sampleRate = sampleRate;
+    header->channels = channels;
+    header->capacityFrames = capacityFrames;
+    return std::unique_ptr<SharedPcmRing>(new SharedPcmRing(
+        mapping, mappingSize, capacityFrames, channels, memoryFd, dataEventFd, spaceEventFd));
+}
+
+std::unique_ptr<SharedPcmRing> SharedPcmRing::attach(int memoryFd, int dataEventFd,
+                                                     int spaceEventFd) {
+    struct stat memoryStat{};
+    if (fstat(memoryFd, &memoryStat) != 0 || size_t(memoryStat.st_size) < SAMPLES_OFFSET) {
+        std::cerr << "Error: The shared PCM ring is too small to hold a header." << std::endl;
+        closeAll({memoryFd, dataEventFd, spaceEventFd});
+        return nullptr;
+    }
+
+    // The peer may still grow the memory unless it is sealed, so only trust sealed rings
+    int seals = fcntl(memoryFd, F_GET_SEALS);
+    const size_t mappingSize = memoryStat.st_size;
+    void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, memoryFd, 0);
+    if (seals < 0 || (seals & (F_SEAL_SHRINK | F_SEAL_GROW)) != (F_SEAL_SHRINK | F_SEAL_GROW) ||
+        mapping == MAP_FAILED) {
+        std::cerr << "Error: Could not map the shared PCM ring; it must be a sealed memfd."
+                  << std::endl;
+        if (mapping != MAP_FAILED) {
+            munmap(mapping, mappingSize);
+        }
+        closeAll({memoryFd, dataEventFd, spaceEventFd});
+        return nullptr;
+    }
+
+    // Read once: the peer can rewrite the header at any time
+    auto* header = static_cast<SharedPcmRingHeader*>(mapping);
+    const uint64_t capacityFrames = std::atomic_ref(header->capacityFrames).load();
+    const uint32_t channels = std::atomic_ref(header->channels).load();
+    size_t requiredSize = 0;
+    if (header->magic != SHARED_PCM_RING_MAGIC || header->version != SHARED_PCM_RING_VERSION ||
+        capacityFrames == 0 || !getMappingSize(capacityFrames, channels, requiredSize) ||
+        mappingSize < requiredSize) {
+        std::cerr << "Error: The shared memory does not hold a version "
+                  << SHARED_PCM_RING_VERSION << " PCM ring." << std::endl;
+        munmap(mapping, mappingSize);
+        closeAll({memoryFd, dataEventFd, spaceEventFd});
+        return nullptr;
+    }
+    return std::unique_ptr<SharedPcmRing>(new SharedPcmRing(
+        mapping, mappingSize, capacityFrames, channels, memoryFd, dataEventFd, spaceEventFd));
+}
+
+SharedPcmRing::SharedPcmRing(void* mapping, size_t mappingSize, size_t capacityFrames,
+                             uint32_t channels, int memoryFd, int dataEventFd, int spaceEventFd)
+    : m_mapping(mapping),
+      m_mappingSize(mappingSize),
+      m_header(static_cast<SharedPcmRingHeader*>(mapping)),
+      m_samples(reinterpret_cast<float*>(static_cast<char*>(mapping) + SAMPLES_OFFSET)),
+      m_capacityFrames(capacityFrames),
+      m_channels(channels),
+      m_memoryFd(memoryFd),
+      m_dataEventFd(dataEventFd),
+      m_spaceEventFd(spaceEventFd) {}
+
+SharedPcmRing::~SharedPcmRing() {
+    munmap(m_mapping, m_mappingSize);
+    closeAll({m_memoryFd, m_dataEventFd, m_spaceEventFd});
+}
+
+std::span<float> SharedPcmRing::acquireWrite(size_t maxFrames) {
+    const uint64_t capacity = m_capacityFrames;
+    // Only this side moves writtenFrames, so it needs no ordering
+    const uint64_t written =
+        std::atomic_ref(m_header->writtenFrames).load(std::memory_order_relaxed);
+    const uint64_t read = std::atomic_ref(m_header->readFrames).load(std::memory_order_acquire);
+    const uint64_t position = written % capacity;
+    const size_t numFrames = std::min({capacity - std::min(written - read, capacity),
+                                       capacity - position, static_cast<uint64_t>(maxFrames)});
+    return {m_samples + position * m_channels, numFrames * m_channels};
+}
+
+void SharedPcmRing::commitWrite(size_t numFrames) {
+    std::atomic_ref(m_header->writtenFrames).fetch_add(numFrames, std::memory_order_release);
+    signalEvent(m_dataEventFd);
+}
+
+void SharedPcmRing::close() {
+    std::atomic_ref(m_header->closed).store(1, std::memory_order_release);
+    signalEvent(m_dataEventFd);
+}
+
+std::span<const float> SharedPcmRing::acquireRead(size_t maxFrames) {
+    const uint64_t capacity = m_capacityFrames;
+    const uint64_t read = std::atomic_ref(m_header->readFrames).load(std::memory_order_relaxed);
+    const uint64_t written =
+        std::atomic_ref(m_header->writtenFrames).load(std::memory_order_acquire);
+    const uint64_t position = read % capacity;
+    // A misbehaving peer cannot make this side read past the buffer
+    const size_t numFrames = std::min({std::min(written - read, capacity), capacity - position,
+                                       static_cast<uint64_t>(maxFrames)});
+    return {m_samples + position * m_channels, numFrames * m_channels};
+}
+
+void SharedPcmRing::commitRead(size_t numFrames) {
+    std::atomic_ref(m_header->readFrames).fetch_add(numFrames, std::memory_order_release);
+    signalEvent(m_spaceEventFd);
+}
+
+bool SharedPcmRing::isClosed() const {
+    return std::atomic_ref(m_header->closed).load(std::memory_order_acquire) != 0;
+}
+
+bool SharedPcmRing::waitReadable(int timeoutMs) {
+    return waitFor(m_dataEventFd, timeoutMs, &SharedPcmRing::hasReadableFrames);
+}
+
+bool SharedPcmRing::waitWritable(int timeoutMs) {
+    return waitFor(m_spaceEventFd, timeoutMs, &SharedPcmRing::hasWritableFrames);
+}
+
+void SharedPcmRing::clearEvent(int eventFd) {
+    uint64_t count;
+    while (read(eventFd, &count, sizeof(count)) < 0 && errno == EINTR) {
+    }
+}
+
+bool SharedPcmRing::waitFor(int eventFd, int timeoutMs, bool (SharedPcmRing::*isReady)() const) {
+    // The event stays signalled until cleared, so a commit between the check and poll() is
+    // never missed
+    while (!(this->*isReady)()) {
+        pollfd event{eventFd, POLLIN, 0};
+        int ready = poll(&event, 1, timeoutMs);
+        if (ready == 0) {
+            return false;
+        }
+        if (ready > 0) {
+            clearEvent(eventFd);
+        }
+    }
+    return true;
+}
+
+bool SharedPcmRing::hasReadableFrames() const {
+    return isClosed() || std::atomic_ref(m_header->writtenFrames).load(std::memory_order_acquire) !=
+                             std::atomic_ref(m_header->readFrames).load(std::memory_order_relaxed);
+}
+
+bool SharedPcmRing::hasWritableFrames() const {
+    return std::atomic_ref(m_header->writtenFrames).load(std::memory_order_relaxed) -
+               std::atomic_ref(m_header->readFrames).load(std::memory_order_acquire) <
+           m_capacityFrames;
+}
+
+size_t SharedPcmRing::getCapacityFrames() const {
+    return m_capacityFrames;
+}
+
+uint32_t SharedPcmRing::getChannels() const {
+    return m_channels;
+}
+
+uint32_t SharedPcmRing::getSampleRate() const {
+    return m_header->sampleRate;
+}
+
+int SharedPcmRing::getMemoryFd() const {
+    return m_memoryFd;
+}
+
+int SharedPcmRing::getDataEventFd() const {
+    return m_dataEventFd;
+}
+
+int SharedPcmRing::getSpaceEventFd() const {
+    return m_spaceEventFd;
+}
+
+bool sendRingMessage(int socketFd, const std::string& message,
+                     const std::vector<const SharedPcmRing*>& rings) {
+    if (rings.size() > MAX_RINGS_PER_MESSAGE || message.size() > MAX_RING_MESSAGE_SIZE) {
+        return false;
+    }
+    std::vector<int> fds;
+    for (const SharedPcmRing* ring : rings) {
+        fds.insert(fds.end(),
+                   {ring->getMemoryFd(), ring->getDataEventFd(), ring->getSpaceEventFd()});
+    }
+
+    iovec payload{const_cast<char*>(message.data()), message.size()};
+    msghdr header{};
+    header.msg_iov = &payload;
+    header.msg_iovlen = 1;
+    alignas(cmsghdr) char control[CMSG_SPACE(MAX_MESSAGE_FDS * sizeof(int))] = {};
+    if (!fds.empty()) {
+        header.msg_control = control;
+        header.msg_controllen = CMSG_SPACE(fds.size() * sizeof(int));
+        cmsghdr* rights = CMSG_FIRSTHDR(&header);
+        rights->cmsg_level = SOL_SOCKET;
+        rights->cmsg_type = SCM_RIGHTS;
+        rights->cmsg_len = CMSG_LEN(fds.size() * sizeof(int));
+        std::memcpy(CMSG_DATA(rights), fds.data(), fds.size() * sizeof(int));
+    }
+
+    ssize_t sent;
+    while ((sent = sendmsg(socketFd, &header, MSG_NOSIGNAL)) < 0 && errno == EINTR) {
+    }
+    return sent == static_cast<ssize_t>(message.size());
+}
+
+bool receiveRingMessage(int socketFd, std::string& message,
+                        std::vector<std::unique_ptr<SharedPcmRing>>& rings) {
+    char buffer[MAX_RING_MESSAGE_SIZE];
+    iovec payload{buffer, sizeof(buffer)};
+    msghdr header{};
+    header.msg_iov = &payload;
+    header.msg_iovlen = 1;
+    alignas(cmsghdr) char control[CMSG_SPACE(MAX_MESSAGE_FDS * sizeof(int))];
+    header.msg_control = control;
+    header.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    while ((received = recvmsg(socketFd, &header, MSG_CMSG_CLOEXEC)) < 0 && errno == EINTR) {
+    }
+    if (received <= 0) {
+        return false;
+    }
+    message.assign(buffer, received);
+
+    std::vector<int> fds;
+    for (cmsghdr* rights = CMSG_FIRSTHDR(&header); rights;
+         rights = CMSG_NXTHDR(&header, rights)) {
+        if (rights->cmsg_level == SOL_SOCKET && rights->cmsg_type == SCM_RIGHTS) {
+            size_t count = (rights->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const size_t first = fds.size();
+            fds.resize(first + count);
+            std::memcpy(fds.data() + first, CMSG_DATA(rights), count * sizeof(int));
+        }
+    }
+    if ((header.msg_flags & (MSG_CTRUNC | MSG_TRUNC)) || fds.size() % FDS_PER_RING != 0) {
+        for (int fd : fds) {
+            ::close(fd);
+        }
+        return false;
+    }
+
+    bool valid = true;
+    for (size_t i = 0; i < fds.size(); i += FDS_PER_RING) {
+        // attach() takes the descriptors even when it fails, so every ring is attempted
+        auto ring = SharedPcmRing::attach(fds[i], fds[i + 1], fds[i + 2]);
+        valid = valid && ring;
+        rings.push_back(std::move(ring));
+    }
+    return valid;
+}
+
+}  // namespace MediaProcessor
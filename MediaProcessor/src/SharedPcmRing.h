@@ -0,0 +1,165 @@
+#ifndef SHAREDPCMRING_H
+#define SHAREDPCMRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace MediaProcessor {
+
+constexpr uint32_t SHARED_PCM_RING_MAGIC = 0x4d50524e;  // "MPRN"
+constexpr uint32_t SHARED_PCM_RING_VERSION = 1;
+constexpr size_t MAX_RING_MESSAGE_SIZE = 256;
+constexpr size_t MAX_RINGS_PER_MESSAGE = 2;
+
+/**
+ * @brief Layout of the first page of a ring's shared memory; the samples follow it.
+ *
+ * The counters only grow: frame `n` lives at `(n % capacityFrames) * channels` floats into the
+ * sample area. Other languages map the same layout, so it must not change without a version.
+ */
+struct SharedPcmRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sampleRate;
+    uint32_t channels;
+    uint64_t capacityFrames;
+    alignas(64) uint64_t writtenFrames;  // published by the producer
+    alignas(64) uint64_t readFrames;     // published by the consumer
+    alignas(64) uint32_t closed;         // set once the producer has written its last frame
+};
+
+/**
+ * @brief A single-producer, single-consumer ring of interleaved float frames in a memfd.
+ *
+ * The producer writes straight into the shared pages through acquireWrite() and the consumer
+ * reads them in place through acquireRead(), so PCM crosses the process boundary without being
+ * copied or touching a file. Each side may live in another process: the memfd and two eventfds,
+ * one signalled when frames arrive or the ring closes and one when space frees up, are all a
+ * peer needs, e.g. sent over a Unix socket. The memory is sealed against resizing, so a peer
+ * cannot truncate it under the other's mapping.
+ */
+class SharedPcmRing {
+   public:
+    /**
+     * @brief Creates a ring in new shared memory.
+     *
+     * @return The ring, or nullptr if the memory or the eventfds could not be created.
+     */
+    static std::unique_ptr<SharedPcmRing> create(size_t capacityFrames, uint32_t channels,
+                                                 uint32_t sampleRate);
+
+    /**
+     * @brief Maps a ring another process created, taking ownership of the descriptors.
+     *
+     * @return The ring, or nullptr if the memory does not hold a valid ring; the descriptors
+     *         are closed either way then.
+     */
+    static std::unique_ptr<SharedPcmRing> attach(int memoryFd, int dataEventFd,
+                                                 int spaceEventFd);
+
+    ~SharedPcmRing();
+
+    SharedPcmRing(const SharedPcmRing&) = delete;
+    SharedPcmRing& operator=(const SharedPcmRing&) = delete;
+
+    /**
+     * @brief Gets the free frames up to the end of the buffer, at most `maxFrames` of them.
+     *
+     * Empty when the ring is full; fewer frames than are free when they wrap around.
+     */
+    std::span<float> acquireWrite(size_t maxFrames = SIZE_MAX);
+
+    /**
+     * @brief Publishes `numFrames` frames written into the last acquireWrite() region.
+     */
+    void commitWrite(size_t numFrames);
+
+    /**
+     * @brief Marks the stream as complete; the consumer drains what is left and stops.
+     */
+    void close();
+
+    /**
+     * @brief Gets the unread frames up to the end of the buffer, at most `maxFrames` of them.
+     */
+    std::span<const float> acquireRead(size_t maxFrames = SIZE_MAX);
+
+    /**
+     * @brief Releases `numFrames` frames of the last acquireRead() region to the producer.
+     */
+    void commitRead(size_t numFrames);
+
+    /**
+     * @brief Whether the producer closed the ring; check before acquireRead() to know an
+     *        empty region means the stream ended.
+     */
+    bool isClosed() const;
+
+    /**
+     * @brief Blocks until frames can be read or the ring is closed.
+     *
+     * @return false if `timeoutMs` (-1 waits forever) passed first.
+     */
+    bool waitReadable(int timeoutMs);
+
+    /**
+     * @brief Blocks until frames can be written.
+     *
+     * @return false if `timeoutMs` (-1 waits forever) passed first.
+     */
+    bool waitWritable(int timeoutMs);
+
+    /**
+     * @brief Resets an eventfd of this ring after poll() reported it readable.
+     */
+    static void clearEvent(int eventFd);
+
+    size_t getCapacityFrames() const;
+    uint32_t getChannels() const;
+    uint32_t getSampleRate() const;
+
+    int getMemoryFd() const;
+    int getDataEventFd() const;   // readable when frames arrived or the ring closed
+    int getSpaceEventFd() const;  // readable when the consumer freed space
+
+   private:
+    SharedPcmRing(void* mapping, size_t mappingSize, size_t capacityFrames, uint32_t channels,
+                  int memoryFd, int dataEventFd, int spaceEventFd);
+
+    bool waitFor(int eventFd, int timeoutMs, bool (SharedPcmRing::*isReady)() const);
+    bool hasReadableFrames() const;
+    bool hasWritableFrames() const;
+
+    void* m_mapping;
+    size_t m_mappingSize;
+    SharedPcmRingHeader* m_header;
+    float* m_samples;
+    size_t m_capacityFrames;  // copied once validated, so the peer cannot change them
+    uint32_t m_channels;
+    int m_memoryFd;
+    int m_dataEventFd;
+    int m_spaceEventFd;
+};
+
+/**
+ * @brief Sends `message` as one packet over a Unix socket with the memfd, data eventfd and space
+ *        eventfd of each of `rings` attached, in that order.
+ */
+bool sendRingMessage(int socketFd, const std::string& message,
+                     const std::vector<const SharedPcmRing*>& rings);
+
+/**
+ * @brief Receives one packet from a Unix socket and attaches the rings sent with it.
+ *
+ * @return false if the peer hung up or sent descriptors that do not form valid rings.
+ */
+bool receiveRingMessage(int socketFd, std::string& message,
+                        std::vector<std::unique_ptr<SharedPcmRing>>& rings);
+
+}  // namespace MediaProcessor
+
+#endif  // SHAREDPCMRING_H
@@ -0,0 +1,148 @@
+#include "SocketListener.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace MediaProcessor {
+
+SocketListener::SocketListener(std::string endpoint, int backlog)
+    : m_endpoint(std::move(endpoint)), m_backlog(backlog) {}
+
+SocketListener::~SocketListener() {
+    if (m_thread.joinable()) {
+        m_stop.store(true);
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        m_thread.join();
+    }
+
+    if (m_listenFd != -1) {
+        close(m_listenFd);
+    }
+    if (m_wakeFd != -1) {
+        close(m_wakeFd);
+    }
+    if (!m_socketPath.empty()) {
+        std::error_code ec;
+        fs::remove(m_socketPath, ec);
+    }
+}
+
+bool SocketListener::start(AcceptHandler handler) {
+    if (m_endpoint.starts_with(LISTENER_UNIX_PREFIX)) {
+        m_listenFd = bindUnix(m_endpoint.substr(std::strlen(LISTENER_UNIX_PREFIX)));
+    } else {
+        size_t separator = m_endpoint.rfind(':');
+        m_listenFd = separator == std::string::npos
+                         ? bindTcp(LISTENER_DEFAULT_HOST, m_endpoint)
+                         : bindTcp(m_endpoint.substr(0, separator),
+                                   m_endpoint.substr(separator + 1));
+    }
+    if (m_listenFd == -1) {
+        std::cerr << "Error: Could not listen on " << m_endpoint << ": " << std::strerror(errno)
+                  << std::endl;
+        return false;
+    }
+
+    m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeFd == -1) {
+        return false;
+    }
+    m_thread = std::thread([this, handler = std::move(handler)]() { acceptLoop(handler); });
+    return true;
+}
+
+uint16_t SocketListener::getPort() const {
+    sockaddr_storage address{};
+    socklen_t length = sizeof(address);
+    if (getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&address), &length) == -1) {
+        return 0;
+    }
+    if (address.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<sockaddr_in6*>(&address)->sin6_port);
+    }
+    if (address.ss_family == AF_INET) {
+        return ntohs(reinterpret_cast<sockaddr_in*>(&address)->sin_port);
+    }
+    return 0;
+}
+
+int SocketListener::bindTcp(const std::string& host, const std::string& port) const {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int fd = -1;
+    for (addrinfo* address = addresses; address && fd == -1; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, 0);
+        if (fd == -1) {
+            continue;
+        }
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(fd, address->ai_addr, address->ai_addrlen) == -1 ||
+            listen(fd, m_backlog) == -1) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    return fd;
+}
+
+int SocketListener::bindUnix(const fs::path& socketPath) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.string().size() >= sizeof(address.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    // A socket left behind by a crashed run would make bind() fail
+    std::error_code ec;
+    fs::remove(socketPath, ec);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        return -1;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+        listen(fd, m_backlog) == -1) {
+        close(fd);
+        return -1;
+    }
+    m_socketPath = socketPath;
+    return fd;
+}
+
+void SocketListener::acceptLoop(const AcceptHandler& handler) {
+    std::array<pollfd, 2> fds = {pollfd{m_listenFd, POLLIN, 0}, pollfd{m_wakeFd, POLLIN, 0}};
+    while (!m_stop.load()) {
+        if (poll(fds.data(), fds.size(), -1) <= 0 || !(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        int clientFd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (clientFd != -1) {
+            handler(clientFd);
+        }
+    }
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,72 @@
+#ifndef SOCKETLISTENER_H
+#define SOCKETLISTENER_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr const char* LISTENER_UNIX_PREFIX = "unix:";
+constexpr const char* LISTENER_DEFAULT_HOST = "127.0.0.1";
+
+/**
+ * @brief Accepts stream connections on a TCP or Unix socket endpoint from a background thread.
+ *
+ * Shared by the servers, which only decide what to do with each accepted connection.
+ */
+class SocketListener {
+   public:
+    /**
+     * @brief Called on the accepting thread with each connection, which it then owns.
+     */
+    using AcceptHandler = std::function<void(int clientFd)>;
+
+    /**
+     * @param endpoint `unix:<path>`, `<host>:<port>` or `<port>` (bound to 127.0.0.1); port 0
+     *        picks a free one.
+     */
+    SocketListener(std::string endpoint, int backlog);
+
+    /**
+     * @brief Stops accepting, and removes the Unix socket file if one was bound.
+     */
+    ~SocketListener();
+
+    SocketListener(const SocketListener&) = delete;
+    SocketListener& operator=(const SocketListener&) = delete;
+
+    /**
+     * @brief Binds the endpoint and starts handing accepted connections to `handler`.
+     *
+     * @return true if the endpoint could be bound, false otherwise.
+     */
+    bool start(AcceptHandler handler);
+
+    /**
+     * @brief Gets the bound TCP port, e.g. the one picked for port 0; valid after start().
+     */
+    uint16_t getPort() const;
+
+   private:
+    int bindTcp(const std::string& host, const std::string& port) const;
+    int bindUnix(const fs::path& socketPath);
+    void acceptLoop(const AcceptHandler& handler);
+
+    std::string m_endpoint;
+    int m_backlog;
+    fs::path m_socketPath;  // removed again on shutdown
+    int m_listenFd = -1;
+    int m_wakeFd = -1;
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // SOCKETLISTENER_H
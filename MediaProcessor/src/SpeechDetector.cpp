@@ -0,0 +1,155 @@
+#include "SpeechDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+namespace MediaProcessor {
+
+namespace {
+
+// Width of the SNR range over which a frame goes from unlikely to likely speech
+constexpr double LSNR_SLOPE_DB = 3.0;
+
+double frameLevelDb(const float* samples, size_t numSamples) {
+    double sumOfSquares = 0.0;
+    for (size_t i = 0; i < numSamples; ++i) {
+        sumOfSquares += static_cast<double>(samples[i]) * samples[i];
+    }
+    double meanSquare = numSamples > 0 ? sumOfSquares / numSamples : 0.0;
+    return 10.0 * std::log10(std::max(meanSquare, 1e-12));
+}
+
+}  // namespace
+
+SpeechDetector::SpeechDetector(unsigned int sampleRate, const SpeechSegmentConfig& config)
+    : m_sampleRate(sampleRate), m_config(config) {}
+
+void SpeechDetector::addFrame(float lsnr, const float* samples, size_t numSamples) {
+    const double probability =
+        1.0 / (1.0 + std::exp(-(lsnr - m_config.lsnrThresholdDb) / LSNR_SLOPE_DB));
+    const bool isSpeech =
+        probability >= 0.5 && frameLevelDb(samples, numSamples) >= m_config.energyFloorDb;
+
+    const size_t frameStart = m_position;
+    m_position += numSamples;
+
+    if (m_inSegment &&
+        static_cast<double>(frameStart - m_lastSpeechEnd) / m_sampleRate > m_config.minGapSeconds) {
+        closeSegment();
+    }
+
+    if (!isSpeech) {
+        // A bridged pause only counts towards its segment once speech resumes
+        if (m_inSegment) {
+            m_pauseProbabilitySum += probability;
+            ++m_numPauseFrames;
+        }
+        return;
+    }
+
+    if (!m_inSegment) {
+        m_inSegment = true;
+        m_segmentStart = frameStart;
+        m_probabilitySum = 0.0;
+        m_numSegmentFrames = 0;
+    }
+    m_probabilitySum += m_pauseProbabilitySum + probability;
+    m_numSegmentFrames += m_numPauseFrames + 1;
+    m_pauseProbabilitySum = 0.0;
+    m_numPauseFrames = 0;
+    m_lastSpeechEnd = m_position;
+}
+
+std::vector<SpeechSegment> SpeechDetector::finish() {
+    if (m_inSegment) {
+        closeSegment();
+    }
+    return std::move(m_segments);
+}
+
+void SpeechDetector::closeSegment() {
+    m_inSegment = false;
+    m_pauseProbabilitySum = 0.0;
+    m_numPauseFrames = 0;
+
+    const double start = static_cast<double>(m_segmentStart) / m_sampleRate;
+    const double end = static_cast<double>(m_lastSpeechEnd) / m_sampleRate;
+    if (end - start >= m_config.minSpeechSeconds) {
+        m_segments.push_back({start, end, m_probabilitySum / m_numSegmentFrames});
+    }
+}
+
+std::vector<SpeechSegment> SpeechDetector::mergeChunks(
+    const std::vector<std::vector<SpeechSegment>>& chunkSegments,
+    const std::vector<double>& chunkStartTimes, double minGapSeconds) {
+    std::vector<SpeechSegment> segments;
+    for (size_t i = 0; i < chunkSegments.size(); ++i) {
+        for (const auto& segment : chunkSegments[i]) {
+            segments.push_back({segment.start + chunkStartTimes[i],
+                                segment.end + chunkStartTimes[i], segment.confidence});
+        }
+    }
+    std::sort(segments.begin(), segments.end(),
+              [](const SpeechSegment& lhs, const SpeechSegment& rhs) {
+                  return lhs.start < rhs.start;
+              });
+
+    std::vector<SpeechSegment> merged;
+    for (const auto& segment : segments) {
+        if (merged.empty() || segment.start - merged.back().end > minGapSeconds) {
+            merged.push_back(segment);
+            continue;
+        }
+
+        SpeechSegment& last = merged.back();
+        const double lastDuration = last.end - last.start;
+        const double duration = segment.end - segment.start;
+        if (lastDuration + duration > 0.0) {
+            last.confidence = (last.confidence * lastDuration + segment.confidence * duration) /
+                              (lastDuration + duration);
+        }
+        last.end = std::max(last.end, segment.end);
+    }
+    return merged;
+}
+
+bool SpeechDetector::save(const fs::path& path, const std::vector<SpeechSegment>& segments) {
+    nlohmann::json sidecar = {{"segments", nlohmann::json::array()}};
+    for (const auto& segment : segments) {
+        sidecar["segments"].push_back(
+            {{"start", segment.start}, {"end", segment.end}, {"confidence", segment.confidence}});
+    }
+
+    std::ofstream sidecarFile(path);
+    if (!(sidecarFile << sidecar.dump(4))) {
+        std::cerr << "Error: Could not write speech segments: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::vector<SpeechSegment>> SpeechDetector::load(const fs::path& path) {
+    std::ifstream sidecarFile(path);
+    if (!sidecarFile.is_open()) {
+        return std::nullopt;
+    }
+
+    std::vector<SpeechSegment> segments;
+    try {
+        nlohmann::json sidecar = nlohmann::json::parse(sidecarFile);
+        for (const auto& entry : sidecar.at("segments")) {
+            segments.push_back({entry.at("start").get<double>(), entry.at("end").get<double>(),
+                                entry.at("confidence").get<double>()});
+        }
+    } catch (const nlohmann::json::exception& e) {
+        std::cerr << "Error: Unreadable speech segments " << path << ": " << e.what()
+                  << std::endl;
+        return std::nullopt;
+    }
+    return segments;
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,85 @@
+#ifndef SPEECHDETECTOR_H
+#define SPEECHDETECTOR_H
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "ConfigManager.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr const char* SPEECH_SEGMENTS_EXTENSION = ".speech.json";
+
+/**
+ * @brief A stretch of audio that likely contains speech, in seconds from the start.
+ */
+struct SpeechSegment {
+    double start;
+    double end;
+    double confidence;  // mean per-frame speech probability, in [0, 1]
+};
+
+/**
+ * @brief Finds speech segments from the per-frame statistics of the DeepFilterNet loop.
+ *
+ * Fed once per filtered frame with the local SNR DeepFilterNet estimated for it and the
+ * filtered samples, so detection costs no extra pass over the audio. A frame counts as
+ * speech if its SNR estimate is above the threshold and the filtered frame is not silent;
+ * short pauses are bridged and short bursts dropped.
+ */
+class SpeechDetector {
+   public:
+    SpeechDetector(unsigned int sampleRate, const SpeechSegmentConfig& config);
+
+    /**
+     * @param lsnr Local SNR in dB, as returned by df_process_frame().
+     * @param samples The filtered frame.
+     */
+    void addFrame(float lsnr, const float* samples, size_t numSamples);
+
+    /**
+     * @brief Closes the open segment, if any, and returns all segments found.
+     */
+    std::vector<SpeechSegment> finish();
+
+    /**
+     * @brief Shifts each chunk's segments by its start time and joins them into one timeline.
+     *
+     * Segments that overlap (chunks share their seams) or are separated by less than
+     * `minGapSeconds` are merged, weighting their confidences by duration.
+     */
+    static std::vector<SpeechSegment> mergeChunks(
+        const std::vector<std::vector<SpeechSegment>>& chunkSegments,
+        const std::vector<double>& chunkStartTimes, double minGapSeconds);
+
+    static bool save(const fs::path& path, const std::vector<SpeechSegment>& segments);
+    static std::optional<std::vector<SpeechSegment>> load(const fs::path& path);
+
+   private:
+    void closeSegment();
+
+    unsigned int m_sampleRate;
+    SpeechSegmentConfig m_config;
+
+    size_t m_position = 0;  // in samples
+    std::vector<SpeechSegment> m_segments;
+
+    // Open segment, if m_inSegment
+    bool m_inSegment = false;
+    size_t m_segmentStart = 0;
+    size_t m_lastSpeechEnd = 0;
+    double m_probabilitySum = 0.0;
+    size_t m_numSegmentFrames = 0;
+
+    // Frames since the last speech frame of the open segment
+    double m_pauseProbabilitySum = 0.0;
+    size_t m_numPauseFrames = 0;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // SPEECHDETECTOR_H
@@ -0,0 +1,181 @@
+#include "TaskGraph.h"
+
+#include <iostream>
+#include <stdexcept>
+
+namespace MediaProcessor {
+
+namespace {
+
+Task<bool> runSynchronously(TaskGraph::NodeWork work) {
+    co_return work();
+}
+
+}  // namespace
+
+TaskGraph::TaskGraph(ThreadPool& executor) : m_executor(executor) {}
+
+TaskGraph::NodeId TaskGraph::addNode(std::string name, NodeWork work) {
+    return addNode(std::move(name),
+                   AsyncNodeWork([work = std::move(work)]() { return runSynchronously(work); }));
+}
+
+TaskGraph::NodeId TaskGraph::addNode(std::string name, AsyncNodeWork work) {
+    Node node;
+    node.name = std::move(name);
+    node.work = std::move(work);
+    m_nodes.push_back(std::move(node));
+    return m_nodes.size() - 1;
+}
+
+void TaskGraph::addEdge(NodeId from, NodeId to) {
+    if (from >= m_nodes.size() || to >= m_nodes.size()) {
+        throw std::out_of_range("TaskGraph edge refers to an unknown node.");
+    }
+    if (from == to) {
+        throw std::invalid_argument("TaskGraph node cannot depend on itself: " +
+                                    m_nodes[from].name);
+    }
+
+    m_nodes[from].successors.push_back(to);
+    m_nodes[to].pendingPredecessors++;
+}
+
+Task<bool> TaskGraph::run() {
+    checkAcyclic();
+    co_await CompletionAwaiter{*this};
+    co_return m_succeeded;
+}
+
+TaskGraph::NodeState TaskGraph::getNodeState(NodeId node) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nodes.at(node).state;
+}
+
+const std::string& TaskGraph::getNodeName(NodeId node) const {
+    return m_nodes.at(node).name;
+}
+
+size_t TaskGraph::getNumNodes() const {
+    return m_nodes.size();
+}
+
+bool TaskGraph::CompletionAwaiter::await_suspend(std::coroutine_handle<> continuation) {
+    std::vector<NodeId> roots;
+    {
+        std::lock_guard<std::mutex> lock(graph.m_mutex);
+        graph.m_continuation = continuation;
+        // The extra count keeps the continuation from resuming while roots are still launched
+        graph.m_outstanding = graph.m_nodes.size() + 1;
+
+        for (NodeId id = 0; id < graph.m_nodes.size(); ++id) {
+            if (graph.m_nodes[id].pendingPredecessors == 0) {
+                graph.m_nodes[id].state = NodeState::Running;
+                roots.push_back(id);
+            }
+        }
+    }
+
+    for (NodeId root : roots) {
+        graph.runNode(root);
+    }
+
+    std::lock_guard<std::mutex> lock(graph.m_mutex);
+    return --graph.m_outstanding != 0;
+}
+
+void TaskGraph::checkAcyclic() const {
+    std::vector<size_t> pending;
+    std::vector<NodeId> ready;
+    for (NodeId id = 0; id < m_nodes.size(); ++id) {
+        pending.push_back(m_nodes[id].pendingPredecessors);
+        if (pending.back() == 0) {
+            ready.push_back(id);
+        }
+    }
+
+    size_t visited = 0;
+    while (!ready.empty()) {
+        NodeId id = ready.back();
+        ready.pop_back();
+        visited++;
+
+        for (NodeId successor : m_nodes[id].successors) {
+            if (--pending[successor] == 0) {
+                ready.push_back(successor);
+            }
+        }
+    }
+
+    if (visited != m_nodes.size()) {
+        throw std::logic_error("TaskGraph contains a dependency cycle.");
+    }
+}
+
+detail::DetachedTask TaskGraph::runNode(NodeId node) {
+    co_await schedule(m_executor);
+
+    bool success = false;
+    try {
+        success = co_await m_nodes[node].work();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Task '" << m_nodes[node].name << "' threw: " << e.what()
+                  << std::endl;
+    } catch (...) {
+        std::cerr << "Error: Task '" << m_nodes[node].name << "' threw." << std::endl;
+    }
+
+    std::vector<NodeId> ready;
+    bool finished;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ready = completeLocked(node, success);
+        finished = m_outstanding == 0;
+    }
+
+    for (NodeId successor : ready) {
+        runNode(successor);
+    }
+
+    // Last action: the awaiting coroutine may destroy the graph once resumed
+    if (finished) {
+        m_continuation.resume();
+    }
+}
+
+std::vector<TaskGraph::NodeId> TaskGraph::completeLocked(NodeId node, bool success) {
+    std::vector<NodeId> ready;
+    std::vector<std::pair<NodeId, bool>> finished = {{node, success}};
+
+    while (!finished.empty()) {
+        auto [id, succeeded] = finished.back();
+        finished.pop_back();
+
+        Node& current = m_nodes[id];
+        if (current.state == NodeState::Running) {
+            current.state = succeeded ? NodeState::Succeeded : NodeState::Failed;
+        }
+        m_succeeded = m_succeeded && succeeded;
+        m_outstanding--;
+
+        for (NodeId successorId : current.successors) {
+            Node& successor = m_nodes[successorId];
+            successor.blocked = successor.blocked || !succeeded;
+            if (--successor.pendingPredecessors != 0) {
+                continue;
+            }
+
+            if (successor.blocked) {
+                successor.state = NodeState::Skipped;
+                finished.push_back({successorId, false});
+            } else {
+                successor.state = NodeState::Running;
+                ready.push_back(successorId);
+            }
+        }
+    }
+
+    return ready;
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,125 @@
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include <algorithm>
+#include <coroutine>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "AsyncTask.h"
+#include "ThreadPool.h"
+
+namespace MediaProcessor {
+
+/**
+ * @brief Dependency graph of processing steps executed on a long-lived ThreadPool.
+ *
+ * A node starts as soon as all of its predecessors have succeeded, independent of which
+ * stage the other nodes belong to. Nodes downstream of a failed node are skipped, while
+ * unrelated branches keep running so their results are not lost.
+ *
+ * Nodes are either regular callables, which run on a pool worker, or Task factories, which
+ * may additionally suspend (e.g. while waiting on FFmpeg) without holding a worker.
+ */
+class TaskGraph {
+   public:
+    using NodeId = size_t;
+    using NodeWork = std::function<bool()>;
+    using AsyncNodeWork = std::function<Task<bool>()>;
+
+    enum class NodeState { Pending, Running, Succeeded, Failed, Skipped };
+
+    explicit TaskGraph(ThreadPool& executor);
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    NodeId addNode(std::string name, NodeWork work);
+    NodeId addNode(std::string name, AsyncNodeWork work);
+
+    /**
+     * @brief Makes `to` wait until `from` has succeeded.
+     */
+    void addEdge(NodeId from, NodeId to);
+
+    /**
+     * @brief Executes the whole graph; a graph can only be run once.
+     *
+     * @return true if every node succeeded, false otherwise.
+     *
+     * @throws std::logic_error if the graph contains a cycle.
+     */
+    Task<bool> run();
+
+    NodeState getNodeState(NodeId node) const;
+    const std::string& getNodeName(NodeId node) const;
+    size_t getNumNodes() const;
+
+   private:
+    struct Node {
+        std::string name;
+        AsyncNodeWork work;
+        std::vector<NodeId> successors;
+        size_t pendingPredecessors = 0;
+        bool blocked = false;  // a predecessor failed or was skipped
+        NodeState state = NodeState::Pending;
+    };
+
+    struct CompletionAwaiter {
+        TaskGraph& graph;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+        bool await_suspend(std::coroutine_handle<> continuation);
+        void await_resume() const noexcept {}
+    };
+
+    void checkAcyclic() const;
+
+    /**
+     * @brief Runs a node on the executor, then launches the successors it unblocked.
+     */
+    detail::DetachedTask runNode(NodeId node);
+
+    /**
+     * @brief Records a finished node and returns the successors that became ready.
+     *
+     * Must be called with m_mutex held.
+     */
+    std::vector<NodeId> completeLocked(NodeId node, bool success);
+
+    ThreadPool& m_executor;
+    std::vector<Node> m_nodes;
+
+    mutable std::mutex m_mutex;
+    size_t m_outstanding = 0;
+    bool m_succeeded = true;
+    std::coroutine_handle<> m_continuation;
+};
+
+/**
+ * @brief Splits `[begin, end)` into ranges of at most `grainSize` and runs `body(first, last)`
+ *        for each range concurrently on `pool`.
+ *
+ * The awaiting coroutine continues once every range is done; the first exception thrown by
+ * `body` is rethrown.
+ */
+template <typename F>
+Task<void> parallelFor(ThreadPool& pool, size_t begin, size_t end, size_t grainSize, F body) {
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    std::vector<Task<void>> ranges;
+    for (size_t first = begin; first < end; first += grainSize) {
+        size_t last = std::min(first + grainSize, end);
+        ranges.push_back(runOn(pool, [&body, first, last]() { body(first, last); }));
+    }
+
+    co_await whenAll(std::move(ranges));
+}
+
+}  // namespace MediaProcessor
+
+#endif  // TASKGRAPH_H
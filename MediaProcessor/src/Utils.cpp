@@ -1,6 +1,15 @@
 #include "Utils.h"
 
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include <array>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
@@ -8,61 +17,191 @@
 #include <sstream>
 #include <stdexcept>
 #include <string_view>
+#include <thread>
 
 #include "CommandBuilder.h"
 #include "FFmpegSettingsManager.h"
 
 namespace MediaProcessor::Utils {
 
-bool runCommand(const std::string& command) {
-    std::array<char, 128> buffer;
-    std::string result;
-    std::string fullCommand = command + " 2>&1";  // Redirect stderr to stdout
-    FILE* pipe = popen(fullCommand.c_str(), "r");
-    if (!pipe) {
+namespace {
+
+constexpr int COMMAND_POLL_INTERVAL_MS = 100;
+
+struct CommandResult {
+    bool launched = false;
+    bool cancelled = false;
+    int returnCode = -1;
+    std::string output;
+};
+
+/**
+ * @brief Stops a child and everything it spawned: SIGTERM first, SIGKILL after a grace period.
+ */
+void terminateProcessGroup(pid_t pid) {
+    kill(-pid, SIGTERM);
+
+    auto deadline = std::chrono::steady_clock::now() + CHILD_TERMINATION_GRACE_PERIOD;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (waitpid(pid, nullptr, WNOHANG) == pid) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    kill(-pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+}
+
+/**
+ * @brief Runs `command` and collects its stdout, blocking the calling thread.
+ *
+ * Unlike popen(), the child can be killed: the token is polled while waiting for output and
+ * for the exit status, and the whole process group is terminated once it is cancelled.
+ */
+CommandResult executeCommand(const std::string& command, bool mergeStderr,
+                             const CancellationToken& token) {
+    CommandResult result;
+
+    std::optional<ChildProcess> child = spawnShellCommand(command, mergeStderr);
+    if (!child) {
+        return result;
+    }
+    result.launched = true;
+
+    pid_t pid = child->pid;
+    int outputFd = child->outputFd;
+
+    std::array<char, 4096> buffer;
+    pollfd pollFd{outputFd, POLLIN, 0};
+    bool outputOpen = true;
+    int status = 0;
+
+    while (true) {
+        if (token.isCancelled()) {
+            terminateProcessGroup(pid);
+            close(outputFd);
+            result.cancelled = true;
+            return result;
+        }
+
+        if (outputOpen) {
+            if (poll(&pollFd, 1, COMMAND_POLL_INTERVAL_MS) > 0) {
+                ssize_t bytesRead = read(outputFd, buffer.data(), buffer.size());
+                if (bytesRead > 0) {
+                    result.output.append(buffer.data(), bytesRead);
+                } else if (bytesRead == 0 || errno != EINTR) {
+                    outputOpen = false;
+                }
+            }
+            continue;
+        }
+
+        // Output closed; the child may still be running
+        pid_t waited = waitpid(pid, &status, WNOHANG);
+        if (waited == pid) {
+            break;
+        }
+        if (waited == -1 && errno != EINTR) {
+            status = -1;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(COMMAND_POLL_INTERVAL_MS / 10));
+    }
+    close(outputFd);
+
+    if (status == -1) {
+        result.returnCode = -1;
+    } else if (WIFEXITED(status)) {
+        result.returnCode = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        result.returnCode = 128 + WTERMSIG(status);
+    }
+
+    return result;
+}
+
+}  // namespace
+
+std::optional<ChildProcess> spawnShellCommand(const std::string& command, bool mergeStderr) {
+    int pipeFds[2];
+    if (pipe2(pipeFds, O_CLOEXEC) != 0) {
+        return std::nullopt;
+    }
+
+    const char* shellCommand = command.c_str();
+    pid_t pid = fork();
+    if (pid == -1) {
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        return std::nullopt;
+    }
+
+    if (pid == 0) {
+        // Child: only async-signal-safe calls until exec
+        setpgid(0, 0);
+        sigset_t emptySet;
+        sigemptyset(&emptySet);
+        sigprocmask(SIG_SETMASK, &emptySet, nullptr);
+
+        dup2(pipeFds[1], STDOUT_FILENO);
+        if (mergeStderr) {
+            dup2(pipeFds[1], STDERR_FILENO);
+        }
+        execl("/bin/sh", "sh", "-c", shellCommand, static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    setpgid(pid, pid);  // also set from the parent to avoid racing the child
+    close(pipeFds[1]);
+
+    return ChildProcess{pid, pipeFds[0]};
+}
+
+bool runCommand(const std::string& command, const CancellationToken& token) {
+    CommandResult result = executeCommand(command, true, token);  // stderr folded into stdout
+    if (!result.launched) {
         std::cerr << "Error: Failed to run command: " << command << std::endl;
         return false;
     }
 
-    while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-        result += buffer.data();
+    if (result.cancelled) {
+        std::cerr << "Command cancelled (" << token.getReason() << "): " << command << std::endl;
+        return false;
     }
 
-    int returnCode = pclose(pipe);
-    if (returnCode != 0) {
-        std::cerr << "Command failed with return code " << returnCode << ":" << std::endl;
-        std::cerr << result << std::endl;
+    if (result.returnCode != 0) {
+        std::cerr << "Command failed with return code " << result.returnCode << ":" << std::endl;
+        std::cerr << result.output << std::endl;
         return false;
     }
     return true;
 }
 
-std::optional<std::string> runCommand(const std::string& command, bool captureOutput) {
+std::optional<std::string> runCommand(const std::string& command, bool captureOutput,
+                                      const CancellationToken& token) {
     if (!captureOutput) {
-        return runCommand(command) ? std::optional<std::string>{} : std::nullopt;
+        return runCommand(command, token) ? std::optional<std::string>{} : std::nullopt;
     }
 
-    std::array<char, 128> buffer;
-    std::string result;
-    auto pipe = std::unique_ptr<FILE, decltype(&pclose)>(popen(command.c_str(), "r"), pclose);
-
-    if (!pipe) {
+    CommandResult result = executeCommand(command, false, token);
+    if (!result.launched) {
         std::cerr << "Error: Failed to run command: " << command << std::endl;
         return std::nullopt;
     }
 
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-        result += buffer.data();
+    if (result.cancelled) {
+        std::cerr << "Command cancelled (" << token.getReason() << "): " << command << std::endl;
+        return std::nullopt;
     }
 
-    int returnCode = pclose(pipe.release());
-    if (returnCode != 0) {
-        std::cerr << "Command failed with return code " << returnCode << ":" << std::endl;
-        std::cerr << result << std::endl;
+    if (result.returnCode != 0) {
+        std::cerr << "Command failed with return code " << result.returnCode << ":" << std::endl;
+        std::cerr << result.output << std::endl;
         return std::nullopt;
     }
 
-    return result.empty() ? std::nullopt : std::make_optional(result);
+    return result.output.empty() ? std::nullopt : std::make_optional(result.output);
 }
 
 std::pair<std::filesystem::path, std::filesystem::path> prepareOutputPaths(
@@ -81,6 +220,16 @@ fs::path prepareAudioOutputPath(const fs::path& inputPath) {
     return inputPath.parent_path() / (inputPath.stem().string() + "_processed.wav");
 }
 
+fs::path prepareRenditionPath(const fs::path& processedAudioPath, const std::string& renditionName,
+                              const std::string& extension) {
+    return processedAudioPath.parent_path() /
+           (processedAudioPath.stem().string() + "_" + renditionName + "." + extension);
+}
+
+fs::path prepareJobReportPath(const fs::path& inputPath) {
+    return inputPath.parent_path() / (inputPath.stem().string() + "_report.json");
+}
+
 bool ensureDirectoryExists(const std::filesystem::path& path) {
     if (!std::filesystem::exists(path)) {
         std::cout << "Output directory does not exist, creating it: " << path << std::endl;
@@ -99,10 +248,29 @@ bool removeFileIfExists(const std::filesystem::path& filePath) {
     return false;
 }
 
+bool renameNoReplace(const fs::path& from, const fs::path& to, std::error_code& ec) {
+    if (renameat2(AT_FDCWD, from.c_str(), AT_FDCWD, to.c_str(), RENAME_NOREPLACE) == 0) {
+        ec.clear();
+        return true;
+    }
+    ec = std::error_code(errno, std::generic_category());
+    return false;
+}
+
 bool containsWhitespace(const std::string& str) {
     return str.find(' ') != std::string::npos;
 }
 
+std::string sanitizeFilename(const std::string& filename) {
+    std::string sanitized = filename;
+    for (char& c : sanitized) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '_' && c != '-') {
+            c = '_';
+        }
+    }
+    return sanitized.starts_with('.') ? "" : sanitized;
+}
+
 std::string trimTrailingSpace(const std::string& str) {
     if (str.empty() || str.back() != ' ') {
         return str;
@@ -110,7 +278,7 @@ std::string trimTrailingSpace(const std::string& str) {
     return str.substr(0, str.size() - 1);
 }
 
-double getMediaDuration(const fs::path& mediaPath) {
+std::string buildMediaDurationCommand(const fs::path& mediaPath) {
     // Prepare ffprobe command
     CommandBuilder cmd;
     cmd.addArgument("ffprobe");
@@ -119,27 +287,49 @@ double getMediaDuration(const fs::path& mediaPath) {
     cmd.addFlag("-of", "default=noprint_wrappers=1:nokey=1");
     cmd.addArgument(mediaPath.string());
 
-    FILE* pipe = popen(cmd.build().c_str(), "r");
-    if (!pipe) {
+    return cmd.build();
+}
+
+double parseMediaDuration(const std::optional<std::string>& probeOutput) {
+    if (!probeOutput) {
         std::cerr << "Error: Failed to run ffprobe to get media duration." << std::endl;
         return -1;
     }
 
-    char buffer[128];
-    std::string result;
-    while (fgets(buffer, sizeof buffer, pipe) != nullptr) {
-        result += buffer;
-    }
-    pclose(pipe);
-
     try {
-        return std::stod(result);
+        return std::stod(*probeOutput);
     } catch (const std::exception& e) {
         std::cerr << "Error: Could not parse media duration." << std::endl;
         return -1;
     }
 }
 
+double getMediaDuration(const fs::path& mediaPath, const CancellationToken& token) {
+    return parseMediaDuration(runCommand(buildMediaDurationCommand(mediaPath), true, token));
+}
+
+void addFFmpegThreads(CommandBuilder& cmd, unsigned int threads) {
+    if (threads > 0) {
+        cmd.addFlag(FFMPEG_THREADS_FLAG, std::to_string(threads));
+    }
+}
+
+SNDFILE* openWavForWrite(const fs::path& path, SF_INFO& sfInfo) {
+    sfInfo.format = SF_FORMAT_RF64 | (sfInfo.format & SF_FORMAT_SUBMASK);
+
+    SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &sfInfo);
+    if (!file) {
+        std::cerr << "Error: Could not open WAV file for writing: " << path << " ("
+                  << sf_strerror(nullptr) << ")" << std::endl;
+        return nullptr;
+    }
+
+    // Finalize as plain RIFF WAV unless the data actually exceeds the 4 GiB limit
+    sf_command(file, SFC_RF64_AUTO_DOWNGRADE, nullptr, SF_TRUE);
+
+    return file;
+}
+
 template <typename T>
 std::string enumToString(const T& value, const std::unordered_map<T, std::string>& valueMap) {
     auto it = valueMap.find(value);
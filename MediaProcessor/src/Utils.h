@@ -1,13 +1,21 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <sndfile.h>
+#include <sys/types.h>
+
+#include <chrono>
 #include <filesystem>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <unordered_map>
 #include <utility>
 
+#include "CancellationToken.h"
+#include "CommandBuilder.h"
+
 namespace fs = std::filesystem;
 
 namespace MediaProcessor::Utils {
@@ -25,21 +33,51 @@ namespace MediaProcessor::Utils {
         }                                                    \
     }())
 
+/**
+ * @brief Time a cancelled child gets to exit after SIGTERM before it is sent SIGKILL.
+ */
+constexpr auto CHILD_TERMINATION_GRACE_PERIOD = std::chrono::seconds(2);
+
+/**
+ * @brief A child started by spawnShellCommand(): its pid (also its process group id) and the
+ *        read end of its stdout pipe.
+ */
+struct ChildProcess {
+    pid_t pid;
+    int outputFd;
+};
+
+/**
+ * @brief Starts `command` through `/bin/sh` in a new process group without waiting for it.
+ *
+ * The caller owns `outputFd` and must reap the child. Used by the blocking runCommand() and by
+ * the asynchronous ProcessReactor.
+ *
+ * @param mergeStderr Redirect the child's stderr into the same pipe as stdout.
+ * @return The started child, or std::nullopt if the pipe or fork failed.
+ */
+std::optional<ChildProcess> spawnShellCommand(const std::string& command, bool mergeStderr);
+
 /**
  * @brief Executes a command in the system shell.
  *
+ * The command runs in its own process group. If `token` is cancelled (explicitly or by a
+ * stage deadline) the whole group is terminated and the call returns immediately.
+ *
  * @return true if the command executes successfully, false otherwise.
  */
-bool runCommand(const std::string& command);
+bool runCommand(const std::string& command, const CancellationToken& token = CancellationToken());
 
 /**
  * @brief Executes a shell command and optionally returns its output
  *
  * This is used when the output of the command is of interest, and not just a success state.
+ * Cancellation behaves as for runCommand(const std::string&, const CancellationToken&).
  *
  * @return std::optional<std::string> possibly containing the command output.
  */
-std::optional<std::string> runCommand(const std::string& command, bool captureOutput);
+std::optional<std::string> runCommand(const std::string& command, bool captureOutput,
+                                      const CancellationToken& token = CancellationToken());
 
 /**
  * @brief Ensures that a directory exists, making it if necessary.
@@ -55,6 +93,13 @@ bool ensureDirectoryExists(const fs::path& path);
  */
 bool removeFileIfExists(const fs::path& filePath);
 
+/**
+ * @brief Renames `from` to `to` atomically unless `to` exists, which fails with EEXIST.
+ *
+ * @return true if the file was renamed, false otherwise with the reason in `ec`.
+ */
+bool renameNoReplace(const fs::path& from, const fs::path& to, std::error_code& ec);
+
 /**
  * @brief Checks if a string contains whitespace characters.
  *
@@ -62,6 +107,14 @@ bool removeFileIfExists(const fs::path& filePath);
  */
 bool containsWhitespace(const std::string& str);
 
+/**
+ * @brief Makes a client supplied file name safe to store, like the web frontend does.
+ *
+ * @return The name with every character but letters, digits, '.', '_' and '-' replaced by
+ *         '_', or an empty string if it would be empty or hidden (start with '.').
+ */
+std::string sanitizeFilename(const std::string& filename);
+
 /**
  * @brief Prepares the output paths for audio and video processing.
  *
@@ -76,6 +129,21 @@ std::pair<fs::path, fs::path> prepareOutputPaths(const fs::path& videoPath);
  */
 fs::path prepareAudioOutputPath(const fs::path& inputPath);
 
+/**
+ * @brief Prepares the output path of a rendition next to the processed audio.
+ *
+ * @return The processed audio's path with `_<renditionName>.<extension>` as its suffix.
+ */
+fs::path prepareRenditionPath(const fs::path& processedAudioPath, const std::string& renditionName,
+                              const std::string& extension);
+
+/**
+ * @brief Prepares the path of a job's report next to its input.
+ *
+ * @return The input's path with `_report.json` in place of its extension.
+ */
+fs::path prepareJobReportPath(const fs::path& inputPath);
+
 /**
  * @brief Trims trailing whitespace from a string.
  *
@@ -88,7 +156,53 @@ std::string trimTrailingSpace(const std::string& str);
  *
  * @return The duration of the media in seconds, or -1 if an error occurred.
  */
-double getMediaDuration(const fs::path& mediaPath);
+double getMediaDuration(const fs::path& mediaPath,
+                        const CancellationToken& token = CancellationToken());
+
+/**
+ * @brief Builds the ffprobe command used by getMediaDuration().
+ */
+std::string buildMediaDurationCommand(const fs::path& mediaPath);
+
+/**
+ * @brief Parses the output of buildMediaDurationCommand().
+ *
+ * @return The duration in seconds, or -1 if the probe failed or its output is not a number.
+ */
+double parseMediaDuration(const std::optional<std::string>& probeOutput);
+
+/**
+ * @brief FFmpeg WAV muxer flag that reserves room for an RF64 header.
+ *
+ * With `-rf64 auto`, FFmpeg writes a plain RIFF WAV and only promotes it to RF64 once the data
+ * chunk grows past the 4 GiB RIFF limit, so small intermediates stay byte-compatible.
+ */
+constexpr const char* FFMPEG_RF64_FLAG = "-rf64";
+constexpr const char* FFMPEG_RF64_MODE = "auto";
+
+/**
+ * @brief Caps the threads of an FFmpeg child to its share of the resource budget.
+ *
+ * Given before an input it bounds the decoder, before the output the encoder.
+ */
+constexpr const char* FFMPEG_THREADS_FLAG = "-threads";
+
+/**
+ * @brief Adds the threads flag for `threads` to `cmd`; 0 adds nothing and leaves FFmpeg its
+ *        own threading.
+ */
+void addFFmpegThreads(CommandBuilder& cmd, unsigned int threads);
+
+/**
+ * @brief Opens a WAV file for writing that transparently switches to RF64 beyond 4 GiB.
+ *
+ * The container of `sfInfo.format` is replaced with RF64 and libsndfile's auto-downgrade is
+ * enabled, so files that stay under the RIFF limit are finalized as regular WAV on close.
+ * The PCM subformat (e.g. `SF_FORMAT_PCM_16`) is preserved.
+ *
+ * @return A handle to the opened file, or nullptr on failure.
+ */
+SNDFILE* openWavForWrite(const fs::path& path, SF_INFO& sfInfo);
 
 /**
  * @brief Checks if a value is within a specified range (inclusive).
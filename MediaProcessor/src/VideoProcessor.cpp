@@ -1,8 +1,10 @@
 #include "VideoProcessor.h"
 
+#include <chrono>
 #include <iostream>
 
 #include "CommandBuilder.h"
+#include "CommandExecutor.h"
 #include "ConfigManager.h"
 #include "Utils.h"
 
@@ -11,13 +13,28 @@ namespace fs = std::filesystem;
 namespace MediaProcessor {
 
 VideoProcessor::VideoProcessor(const fs::path& videoPath, const fs::path& audioPath,
-                               const fs::path& outputPath)
+                               const fs::path& outputPath,
+                               const CancellationToken& cancellationToken)
     : m_videoPath(fs::absolute(videoPath)),
       m_audioPath(fs::absolute(audioPath)),
       m_outputPath(fs::absolute(outputPath)),
-      m_ffmpegPath(ConfigManager::getInstance().getFFmpegPath()) {}
+      m_ffmpegPath(ConfigManager::getInstance().getFFmpegPath()),
+      m_codecThreads(ConfigManager::getInstance().getResourceBudget().codecThreads),
+      m_cancellationToken(cancellationToken) {}
 
 bool VideoProcessor::mergeMedia() {
+    AsyncRuntime runtime(1);
+    if (!installCommandCassette(runtime, ConfigManager::getInstance().getCommandCassette())) {
+        return false;
+    }
+    return syncWait(mergeMediaAsync(runtime));
+}
+
+void VideoProcessor::setProgress(JobProgress* progress) {
+    m_progress = progress;
+}
+
+Task<bool> VideoProcessor::mergeMediaAsync(AsyncRuntime& runtime) {
     Utils::removeFileIfExists(m_outputPath);  // to avoid interactive ffmpeg prompt
 
     std::cout << "Merging video and audio..." << std::endl;
@@ -26,6 +43,7 @@ bool VideoProcessor::mergeMedia() {
     CommandBuilder cmd;
     cmd.addArgument(m_ffmpegPath.string());
     cmd.addFlag("-y");  // overwrite enabled
+    Utils::addFFmpegThreads(cmd, m_codecThreads);
     cmd.addFlag("-i", m_videoPath.string());
     cmd.addFlag("-i", m_audioPath.string());
     cmd.addFlag("-c:v", "copy");
@@ -34,21 +52,30 @@ bool VideoProcessor::mergeMedia() {
     cmd.addFlag("-map", "0:v:0");
     cmd.addFlag("-map", "1:a:0");
     cmd.addFlag("-shortest");
+    Utils::addFFmpegThreads(cmd, m_codecThreads);
     cmd.addArgument(m_outputPath.string());
 
     std::string ffmpegCommand = cmd.build();
 
     std::cout << "Running FFmpeg command: " << ffmpegCommand << std::endl;
-    bool success = Utils::runCommand(ffmpegCommand);
+    CancellationToken stageToken = m_cancellationToken.withTimeout(
+        ConfigManager::getInstance().getStageTimeout("merge_media"));
+    auto start = std::chrono::steady_clock::now();
+    bool success = co_await runtime.runCommand(ffmpegCommand, stageToken);
 
     if (!success) {
         std::cerr << "Error: Failed to merge audio and video using FFmpeg." << std::endl;
-        return false;
+        co_return false;
+    }
+
+    if (m_progress) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        m_progress->completeStep(JobStage::Mux, elapsed.count(), 1.0, "merge");
     }
 
     std::cout << "Merging completed successfully." << std::endl;
 
-    return true;
+    co_return true;
 }
 
 }  // namespace MediaProcessor
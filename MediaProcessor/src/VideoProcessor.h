@@ -3,6 +3,11 @@
 
 #include <filesystem>
 
+#include "AsyncRuntime.h"
+#include "AsyncTask.h"
+#include "CancellationToken.h"
+#include "CostModel.h"
+
 namespace fs = std::filesystem;
 
 namespace MediaProcessor {
@@ -14,9 +19,12 @@ class VideoProcessor {
    public:
     /**
      * @brief Initializes the VideoProcessor with paths for the video, audio, and output.
+     *
+     * @param cancellationToken Cancelling it terminates a running FFmpeg merge.
      */
     VideoProcessor(const fs::path& videoPath, const fs::path& audioPath,
-                   const fs::path& outputPath);
+                   const fs::path& outputPath,
+                   const CancellationToken& cancellationToken = CancellationToken());
 
     /**
      * @brief Merges the audio and video files into a single output file.
@@ -25,11 +33,24 @@ class VideoProcessor {
      */
     bool mergeMedia();
 
+    /**
+     * @brief Coroutine form of mergeMedia(); the FFmpeg wait is parked on the runtime's reactor.
+     */
+    Task<bool> mergeMediaAsync(AsyncRuntime& runtime);
+
+    /**
+     * @brief Reports the merge time to `progress` as the job's mux stage; nullptr disables it.
+     */
+    void setProgress(JobProgress* progress);
+
    private:
     fs::path m_videoPath;
     fs::path m_audioPath;
     fs::path m_outputPath;
     fs::path m_ffmpegPath;
+    unsigned int m_codecThreads;
+    CancellationToken m_cancellationToken;
+    JobProgress* m_progress = nullptr;
 };
 
 }  // namespace MediaProcessor
@@ -0,0 +1,285 @@
+#include "WatchFolder.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+
+#include "FolderWatcher.h"
+#include "RuntimeServices.h"
+#include "Utils.h"
+
+namespace MediaProcessor {
+
+namespace {
+
+constexpr unsigned int MAX_NAME_ATTEMPTS = 1000;
+
+// Taking a free name in a destination is a check followed by renames
+std::mutex publishMutex;
+
+/**
+ * @brief Names a file of the job whose input had `stem`, with `_<n>` after the stem if n > 0.
+ */
+fs::path numberedName(const fs::path& file, const std::string& stem, unsigned int n) {
+    const std::string name = file.filename().string();
+    if (n == 0) {
+        return name;
+    }
+    const std::string number = "_" + std::to_string(n);
+    if (name.starts_with(stem)) {
+        return stem + number + name.substr(stem.size());
+    }
+    return file.stem().string() + number + file.extension().string();
+}
+
+}  // namespace
+
+WatchFolder::WatchFolder(AsyncRuntime& runtime, CostModel& costModel, WatchFolderConfig config,
+                         const CancellationToken& cancellationToken)
+    : m_config(std::move(config)),
+      m_cancellationToken(cancellationToken),
+      m_scheduler(runtime, costModel, cancellationToken) {
+    m_scheduler.start();
+}
+
+size_t WatchFolder::submitBatch(const std::vector<fs::path>& files) {
+    std::vector<JobSubmission> submissions;
+    for (const fs::path& file : files) {
+        if (std::optional<ClaimedFile> claim = this->claim(file)) {
+            submissions.push_back({{claim->workPath},
+                                   [this, claim = *claim](JobStatus status) {
+                                       m_numCompleted += status == JobStatus::Completed;
+                                       finish(claim, status);
+                                   }});
+        }
+    }
+    if (submissions.empty()) {
+        return 0;
+    }
+
+    std::cout << "INFO: submitting a batch of " << submissions.size() << " file(s)." << std::endl;
+    const size_t numClaimed = submissions.size();
+    m_scheduler.submit(std::move(submissions));
+    return numClaimed;
+}
+
+void WatchFolder::drain() {
+    m_scheduler.stop();
+}
+
+size_t WatchFolder::getNumCompleted() const {
+    return m_numCompleted;
+}
+
+std::optional<WatchFolder::ClaimedFile> WatchFolder::claim(const fs::path& inboxPath) {
+    const fs::path workDirectory = m_config.outputPath / WATCH_WORK_DIRECTORY /
+                                   (std::to_string(getpid()) + "_" + std::to_string(m_nextClaim++));
+    const fs::path workPath = workDirectory / inboxPath.filename();
+
+    // The rename claims the file atomically: a second event for it finds nothing to move
+    std::error_code ec;
+    fs::create_directories(workDirectory, ec);
+    if (!ec) {
+        fs::rename(inboxPath, workPath, ec);
+    }
+    if (ec == std::errc::cross_device_link) {
+        ec.clear();
+        fs::copy_file(inboxPath, workPath, ec) && fs::remove(inboxPath, ec);
+    }
+    if (ec) {
+        if (ec != std::errc::no_such_file_or_directory) {
+            std::cerr << "Error: Could not claim " << inboxPath << ": " << ec.message()
+                      << std::endl;
+        }
+        fs::remove_all(workDirectory, ec);
+        return std::nullopt;
+    }
+    return ClaimedFile{inboxPath, workPath};
+}
+
+void WatchFolder::finish(const ClaimedFile& file, JobStatus status) {
+    // Shed or interrupted jobs are retried: back in the inbox, the file arrives anew
+    if (status == JobStatus::Busy ||
+        (status != JobStatus::Completed && m_cancellationToken.isCancelled())) {
+        returnToInbox(file);
+        return;
+    }
+
+    if (status == JobStatus::Completed) {
+        publish(file.workPath, m_config.outputPath);
+    } else {
+        std::cerr << "Error: " << file.inboxPath << " was not processed, moving it to "
+                  << WATCH_FAILED_DIRECTORY << "/." << std::endl;
+        publish(file.workPath, m_config.outputPath / WATCH_FAILED_DIRECTORY);
+    }
+}
+
+bool WatchFolder::returnToInbox(const ClaimedFile& file) {
+    const fs::path workDirectory = file.workPath.parent_path();
+    const fs::path inbox = file.inboxPath.parent_path();
+
+    // Staged under a hidden name first, so the file still arrives whole across file systems
+    const std::string stagedName =
+        "." + workDirectory.filename().string() + "_" + file.inboxPath.filename().string();
+    const fs::path staged = inbox / stagedName;
+    std::error_code ec;
+    fs::rename(file.workPath, staged, ec);
+    if (ec == std::errc::cross_device_link) {
+        ec.clear();
+        fs::copy_file(file.workPath, staged, ec) && fs::remove(file.workPath, ec);
+    }
+
+    // A file of the same name that arrived meanwhile is newer, so this one takes another name
+    const std::string stem = file.inboxPath.stem().string();
+    for (unsigned int n = 0; !ec && n < MAX_NAME_ATTEMPTS; ++n) {
+        const fs::path inboxPath = inbox / numberedName(file.inboxPath, stem, n);
+        if (Utils::renameNoReplace(staged, inboxPath, ec)) {
+            std::cout << "INFO: returned " << inboxPath << " to its inbox to be retried."
+                      << std::endl;
+            fs::remove_all(workDirectory, ec);
+            return true;
+        }
+        if (ec == std::errc::file_exists) {
+            ec.clear();
+        }
+    }
+    std::cerr << "Error: Could not return " << file.inboxPath.filename() << " to " << inbox
+              << (ec ? ": " + ec.message() : std::string()) << std::endl;
+    return false;
+}
+
+bool WatchFolder::publish(const fs::path& workPath, const fs::path& destination) {
+    const fs::path workDirectory = workPath.parent_path();
+    const fs::path reportPath = Utils::prepareJobReportPath(workPath);
+    std::error_code ec;
+    fs::create_directories(destination, ec);
+
+    // Renames within a file system are atomic, and the report arriving marks the job as done
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(workDirectory, ec)) {
+        if (entry.is_regular_file() && entry.path() != reportPath) {
+            files.push_back(entry.path());
+        }
+    }
+    if (fs::exists(reportPath)) {
+        files.push_back(reportPath);
+    }
+
+    // Outputs are named after the input, so a taken name renames all of the job's files alike
+    std::lock_guard<std::mutex> lock(publishMutex);
+    const std::string stem = workPath.stem().string();
+    unsigned int n = 0;
+    auto isTaken = [&](const fs::path& file) {
+        return fs::exists(destination / numberedName(file, stem, n));
+    };
+    while (n < MAX_NAME_ATTEMPTS && std::any_of(files.begin(), files.end(), isTaken)) {
+        ++n;
+    }
+    if (n == MAX_NAME_ATTEMPTS) {
+        std::cerr << "Error: No free name to publish " << workPath.filename() << " in "
+                  << destination << std::endl;
+        return false;
+    }
+    if (n > 0) {
+        std::cout << "INFO: " << workPath.filename() << " exists in " << destination
+                  << ", publishing it as " << numberedName(workPath, stem, n) << "."
+                  << std::endl;
+    }
+
+    bool success = !ec;
+    for (const fs::path& file : files) {
+        if (!Utils::renameNoReplace(file, destination / numberedName(file, stem, n), ec)) {
+            std::cerr << "Error: Could not move " << file << " to " << destination << ": "
+                      << ec.message() << std::endl;
+            success = false;
+        }
+    }
+    if (success) {
+        fs::remove_all(workDirectory, ec);
+    }
+    return success;
+}
+
+bool WatchFolder::serve(const CancellationToken& cancellationToken) {
+    ConfigManager& configManager = ConfigManager::getInstance();
+    if (!configManager.loadConfig("config.json")) {
+        std::cerr << "Error: Could not load configuration." << std::endl;
+        return false;
+    }
+
+    WatchFolderConfig config;
+    try {
+        config = configManager.getWatchFolderConfig();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return false;
+    }
+    if (config.directories.empty()) {
+        std::cerr << "Error: watch_folder.directories lists no directory to watch." << std::endl;
+        return false;
+    }
+    for (fs::path& directory : config.directories) {
+        directory = fs::absolute(directory);
+    }
+    config.outputPath = fs::absolute(config.outputPath);
+    std::error_code ec;
+    fs::create_directories(config.outputPath / WATCH_WORK_DIRECTORY, ec);
+    if (ec) {
+        std::cerr << "Error: Could not create " << config.outputPath << ": " << ec.message()
+                  << std::endl;
+        return false;
+    }
+
+    // Claims an interrupted run left behind cannot be told apart from failed jobs
+    for (const auto& entry : fs::directory_iterator(config.outputPath / WATCH_WORK_DIRECTORY)) {
+        for (const auto& file : fs::directory_iterator(entry.path(), ec)) {
+            std::cerr << "Warning: " << entry.path() << " was left by an interrupted run, moving "
+                      << "it to " << WATCH_FAILED_DIRECTORY << "/." << std::endl;
+            publish(file.path(), config.outputPath / WATCH_FAILED_DIRECTORY);
+            break;
+        }
+        fs::remove_all(entry.path(), ec);
+    }
+
+    std::unique_ptr<RuntimeServices> services = RuntimeServices::create(configManager);
+    if (!services) {
+        return false;
+    }
+
+    FolderWatcher watcher(config.directories, config.batchWindow);
+    if (!watcher.start()) {
+        return false;
+    }
+    WatchFolder watchFolder(services->getRuntime(), services->getCostModel(), config,
+                            cancellationToken);
+    std::cout << "INFO: watching " << config.directories.size() << " director"
+              << (config.directories.size() == 1 ? "y" : "ies") << ", publishing to "
+              << config.outputPath << "." << std::endl;
+
+    size_t numSaved = 0;
+    while (!cancellationToken.isCancelled()) {
+        std::vector<fs::path> batch = watcher.waitForBatch(cancellationToken);
+        if (!batch.empty()) {
+            watchFolder.submitBatch(batch);
+        }
+
+        // Jobs complete on their lanes while the next batch forms
+        const size_t numCompleted = watchFolder.getNumCompleted();
+        if (numCompleted > numSaved && services->saveCostModel()) {
+            numSaved = numCompleted;
+        }
+    }
+    std::cout << "INFO: shutting down: " << cancellationToken.getReason() << std::endl;
+    watchFolder.drain();
+    if (watchFolder.getNumCompleted() > numSaved) {
+        services->saveCostModel();
+    }
+    return true;
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,118 @@
+#ifndef WATCHFOLDER_H
+#define WATCHFOLDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "AsyncRuntime.h"
+#include "CancellationToken.h"
+#include "ConfigManager.h"
+#include "CostModel.h"
+#include "JobScheduler.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr const char* WATCH_WORK_DIRECTORY = ".work";
+constexpr const char* WATCH_FAILED_DIRECTORY = "failed";
+
+/**
+ * @brief Processes the files written into the `watch_folder` directories as they arrive.
+ *
+ * Settled files (see FolderWatcher) are claimed by moving them into a private work directory
+ * under `output_path`, so each is processed once even if it is written again meanwhile, and
+ * submitted to one JobScheduler for the whole run: each batch joins the jobs still running or
+ * queued, shortest predicted job first, on `max_concurrent_jobs` lanes, with admission and
+ * load shedding.
+ *
+ * Outputs are written inside the work directory and renamed into `output_path` when the job
+ * completes, the input with them and the job report last, so nothing there is ever partially
+ * written. Inputs of failed or rejected jobs are moved to `output_path/failed` with their
+ * report; jobs shed as busy go back to their inbox and arrive anew. Files never replace one
+ * of the same name: a job whose names are taken is published with `_<n>` after the input's
+ * stem, and a returned input whose name was reused meanwhile comes back as `<stem>_<n>`.
+ */
+class WatchFolder {
+   public:
+    /**
+     * @param costModel Shared by all jobs and updated from each completed one.
+     * @param cancellationToken Stops watching and cancels the queued and running jobs.
+     *
+     * The configuration must already be loaded.
+     */
+    WatchFolder(AsyncRuntime& runtime, CostModel& costModel, WatchFolderConfig config,
+                const CancellationToken& cancellationToken = CancellationToken());
+
+    /**
+     * @brief Claims `files` and submits them; their outputs are published as each job ends.
+     *
+     * @return The number of files claimed.
+     */
+    size_t submitBatch(const std::vector<fs::path>& files);
+
+    /**
+     * @brief Waits until every submitted job is done and published.
+     *
+     * No batch can be submitted afterwards.
+     */
+    void drain();
+
+    /**
+     * @brief Gets the number of jobs that completed so far.
+     */
+    size_t getNumCompleted() const;
+
+    /**
+     * @brief Watches the configured directories until `cancellationToken` is cancelled.
+     *
+     * Loads the configuration and the host's cost model, and saves the model whenever more
+     * jobs completed.
+     *
+     * @return true if watching ran and shut down cleanly, false if it could not start.
+     */
+    static bool serve(const CancellationToken& cancellationToken);
+
+   private:
+    struct ClaimedFile {
+        fs::path inboxPath;  // where the file arrived
+        fs::path workPath;   // where it is processed
+    };
+
+    /**
+     * @brief Moves an arrived file into a new work directory.
+     *
+     * @return The claim, or std::nullopt if the file is gone or could not be moved.
+     */
+    std::optional<ClaimedFile> claim(const fs::path& inboxPath);
+
+    /**
+     * @brief Moves the files in the work directory of `workPath` to `destination`, its job
+     *        report last, and removes the directory.
+     */
+    static bool publish(const fs::path& workPath, const fs::path& destination);
+
+    /**
+     * @brief Moves a claimed file back into its inbox, where it arrives anew.
+     */
+    static bool returnToInbox(const ClaimedFile& file);
+
+    /**
+     * @brief Publishes or returns a claimed file once its job is done; called from its lane.
+     */
+    void finish(const ClaimedFile& file, JobStatus status);
+
+    WatchFolderConfig m_config;
+    CancellationToken m_cancellationToken;
+    uint64_t m_nextClaim = 0;
+    std::atomic<size_t> m_numCompleted{0};
+    JobScheduler m_scheduler;  // last, so its lanes stop before what finish() uses goes away
+};
+
+}  // namespace MediaProcessor
+
+#endif  // WATCHFOLDER_H
@@ -0,0 +1,75 @@
+#include "WorkerContext.h"
+
+#include <algorithm>
+
+#include "Metrics.h"
+
+namespace MediaProcessor {
+
+WorkerContext::WorkerContext(size_t workerIndex) : m_workerIndex(workerIndex) {
+    Metrics::getInstance().inferenceWorkers.add(1);
+}
+
+WorkerContext::~WorkerContext() {
+    releaseFilterState();
+    Metrics::getInstance().inferenceWorkers.add(-1);
+}
+
+size_t WorkerContext::getWorkerIndex() const {
+    return m_workerIndex;
+}
+
+DFState* WorkerContext::acquireFilterState(const fs::path& modelPath, float attenuationLimit,
+                                           const char* logLevel) {
+    if (m_filterState && m_filterModelPath != modelPath) {
+        releaseFilterState();
+    }
+
+    if (!m_filterState) {
+        m_filterState = df_create(modelPath.c_str(), attenuationLimit, logLevel);
+        if (!m_filterState) {
+            return nullptr;
+        }
+        Metrics::getInstance().filterStates.add(1);
+        m_filterModelPath = modelPath;
+        m_filterAttenuationLimit = attenuationLimit;
+
+        size_t frameLength = df_get_frame_length(m_filterState);
+        m_inputBuffer.assign(frameLength, 0.0f);
+        m_outputBuffer.assign(frameLength, 0.0f);
+        return m_filterState;
+    }
+
+    if (m_filterAttenuationLimit != attenuationLimit) {
+        df_set_atten_lim(m_filterState, attenuationLimit);
+        m_filterAttenuationLimit = attenuationLimit;
+    }
+
+    std::fill(m_inputBuffer.begin(), m_inputBuffer.end(), 0.0f);
+    for (size_t i = 0; i < FILTER_STATE_FLUSH_FRAMES; ++i) {
+        df_process_frame(m_filterState, m_inputBuffer.data(), m_outputBuffer.data());
+    }
+    return m_filterState;
+}
+
+void WorkerContext::releaseFilterState() {
+    if (m_filterState) {
+        df_free(m_filterState);
+        m_filterState = nullptr;
+        Metrics::getInstance().filterStates.add(-1);
+    }
+}
+
+bool WorkerContext::hasFilterState() const {
+    return m_filterState != nullptr;
+}
+
+FrameBuffer& WorkerContext::getInputBuffer() {
+    return m_inputBuffer;
+}
+
+FrameBuffer& WorkerContext::getOutputBuffer() {
+    return m_outputBuffer;
+}
+
+}  // namespace MediaProcessor
@@ -0,0 +1,107 @@
+#ifndef WORKERCONTEXT_H
+#define WORKERCONTEXT_H
+
+#include <cstddef>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "DeepFilterNetFFI.h"
+
+namespace fs = std::filesystem;
+
+namespace MediaProcessor {
+
+constexpr size_t FRAME_BUFFER_ALIGNMENT = 64;  // one cache line
+
+/**
+ * @brief Frames fed to a reused DFState before its next chunk so no audio from the previous
+ *        chunk leaks through the model's delay lines (0.5 s at 48 kHz with 480-sample hops).
+ */
+constexpr size_t FILTER_STATE_FLUSH_FRAMES = 50;
+
+/**
+ * @brief Minimal allocator handing out `Alignment`-aligned storage.
+ */
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* pointer, size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return true;
+    }
+};
+
+using FrameBuffer = std::vector<float, AlignedAllocator<float, FRAME_BUFFER_ALIGNMENT>>;
+
+/**
+ * @brief Resources owned by a single runtime worker for its whole lifetime.
+ *
+ * Created by the worker's start hook and destroyed by its stop hook, on the worker thread
+ * itself, so nothing in here is shared between threads. The DeepFilterNet state is loaded on
+ * first use and then reused for every chunk the worker filters, instead of reloading the model
+ * per chunk.
+ */
+class WorkerContext {
+   public:
+    explicit WorkerContext(size_t workerIndex);
+    ~WorkerContext();
+
+    WorkerContext(const WorkerContext&) = delete;
+    WorkerContext& operator=(const WorkerContext&) = delete;
+
+    size_t getWorkerIndex() const;
+
+    /**
+     * @brief Returns a DFState for `modelPath`, ready to filter a new chunk.
+     *
+     * The state is created on first use or when the model changes. A reused state has its
+     * attenuation limit updated and is flushed with FILTER_STATE_FLUSH_FRAMES of silence.
+     *
+     * @return The state, or nullptr if it could not be created.
+     */
+    DFState* acquireFilterState(const fs::path& modelPath, float attenuationLimit,
+                                const char* logLevel);
+
+    /**
+     * @brief Frees the current DFState, e.g. after a failure left it in an unknown state.
+     */
+    void releaseFilterState();
+
+    bool hasFilterState() const;
+
+    FrameBuffer& getInputBuffer();
+    FrameBuffer& getOutputBuffer();
+
+   private:
+    size_t m_workerIndex;
+
+    DFState* m_filterState = nullptr;
+    fs::path m_filterModelPath;
+    float m_filterAttenuationLimit = 0.0f;
+
+    FrameBuffer m_inputBuffer;
+    FrameBuffer m_outputBuffer;
+};
+
+}  // namespace MediaProcessor
+
+#endif  // WORKERCONTEXT_H
@@ -1,13 +1,50 @@
+#include <signal.h>
+
 #include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
 
-#include "Engine.h"
+#include "CancellationToken.h"
+#include "JobScheduler.h"
+#include "MediaFrontend.h"
+#include "WatchFolder.h"
 
 using namespace MediaProcessor;
 
+constexpr int EXIT_CODE_CANCELLED = 130;
+constexpr int EXIT_CODE_BUSY = 75;  // EX_TEMPFAIL: shed under load, retry later
+constexpr std::string_view CALIBRATE_FLAG = "--calibrate";
+constexpr std::string_view TENANT_FLAG = "--tenant";
+constexpr std::string_view SERVE_FLAG = "--serve";
+constexpr std::string_view WATCH_FLAG = "--watch";
+
+/**
+ * @brief Cancels `token` when SIGINT or SIGTERM arrives.
+ *
+ * The signals are blocked in every thread and consumed by a dedicated `sigwait` thread, so
+ * cancellation runs in normal thread context instead of an async signal handler. Must be
+ * called before any other thread is started so the mask is inherited.
+ */
+static void cancelOnTerminationSignals(CancellationToken token) {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    std::thread([signals, token]() mutable {
+        int signal = 0;
+        if (sigwait(&signals, &signal) == 0) {
+            token.cancel(signal == SIGINT ? "interrupted (SIGINT)" : "terminated (SIGTERM)");
+        }
+    }).detach();
+}
+
 int main(int argc, char* argv[]) {
     /**
-     * @brief Processes a media file (audio or video) to isolate vocals and output the processed
-     * result.
+     * @brief Processes media files (audio or video) to isolate vocals and output the processed
+     * results.
      *
      * This program removes music, sound effects, and noise while retaining clear vocals.
      * It supports both audio and video files, adapting the workflow based on the file type.
@@ -22,26 +59,77 @@ int main(int argc, char* argv[]) {
      *      - Process the audio in chunks with parallel processing.
      *      - Merge the isolated vocals back with the original video.
      *
+     * Several files are scheduled shortest-predicted-first using the host's cost model, which
+     * is updated after every completed job. `--calibrate` discards the stored model so the
+     * given files (e.g. a representative benchmark set) calibrate it anew. Under load, jobs
+     * are shed or degraded according to `load_shedding`; every job gets a `_report.json`.
+     * `--tenant <name>` assigns the files after it to a tenant; concurrently running jobs
+     * share the inference workers by their tenants' `tenant_weights`.
+     *
+     * `--serve` instead runs the HTTP front end configured in `http_server` until SIGINT or
+     * SIGTERM: files uploaded to it are processed as they arrive and their outputs served.
+     * `--watch` likewise processes the files written into the `watch_folder` directories, in
+     * batches, and moves their outputs into its `output_path`.
+     *
      * @param argc Number of command-line arguments.
      * @param argv Array of command-line argument strings.
-     * @return Exit status code (0 for success, non-zero for failure).
+     * @return Exit status code (0 for success, EXIT_CODE_BUSY if jobs were rejected as busy,
+     *         other non-zero values for failure).
      *
-     * Usage: <executable> <media_file_path>
+     * Usage: <executable> [--calibrate] [[--tenant <name>] <media_file_path>...]...
+     *        <executable> --serve | --watch
      *
      * Example:
      *   - For video: <executable> input_video.mp4
      *   - For audio: <executable> input_audio.wav
+     *   - For a batch: <executable> episode1.mp4 episode2.mp4 podcast.wav
+     *   - For two tenants: <executable> --tenant studio ep1.mp4 --tenant bulk archive*.wav
+     *   - For uploads: <executable> --serve, then `curl -T talk.mp4 localhost:8090/upload/`
+     *   - For a drop folder: <executable> --watch, then `cp talk.mp4 inbox/`
      */
 
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <media_file_path>" << std::endl;
+    if (argc == 2 && argv[1] == SERVE_FLAG) {
+        CancellationToken shutdownToken;
+        cancelOnTerminationSignals(shutdownToken);
+        return MediaFrontend::serve(shutdownToken) ? 0 : 1;
+    }
+    if (argc == 2 && argv[1] == WATCH_FLAG) {
+        CancellationToken shutdownToken;
+        cancelOnTerminationSignals(shutdownToken);
+        return WatchFolder::serve(shutdownToken) ? 0 : 1;
+    }
+
+    bool recalibrate = false;
+    std::string tenant = DEFAULT_TENANT;
+    std::vector<JobRequest> requests;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] == CALIBRATE_FLAG) {
+            recalibrate = true;
+        } else if (argv[i] == TENANT_FLAG && i + 1 < argc) {
+            tenant = argv[++i];
+        } else {
+            requests.push_back({argv[i], tenant});
+        }
+    }
+
+    if (requests.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [" << CALIBRATE_FLAG << "] [[" << TENANT_FLAG
+                  << " <name>] <media_file_path>...]... | " << SERVE_FLAG << " | " << WATCH_FLAG
+                  << std::endl;
         return 1;
     }
 
-    MediaProcessor::Engine engine(argv[1]);
-    if (!engine.processMedia()) {
+    CancellationToken cancellationToken;
+    cancelOnTerminationSignals(cancellationToken);
+
+    BatchStatus status = JobScheduler::processFiles(requests, cancellationToken, recalibrate);
+    if (status == BatchStatus::Busy) {
+        std::cerr << "Busy: some jobs were rejected under load, retry them later." << std::endl;
+        return EXIT_CODE_BUSY;
+    }
+    if (status == BatchStatus::Failed) {
         std::cerr << "Media processing failed." << std::endl;
-        return 1;
+        return cancellationToken.isCancelled() ? EXIT_CODE_CANCELLED : 1;
     }
 
     return 0;
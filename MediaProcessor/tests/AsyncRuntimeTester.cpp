@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+
+#include "../src/AsyncRuntime.h"
+
+namespace MediaProcessor::Tests {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+Task<bool> runSleepCommands(AsyncRuntime& runtime, int count) {
+    std::vector<Task<bool>> commands;
+    for (int i = 0; i < count; ++i) {
+        commands.push_back(runtime.runCommand("sleep 0.3", CancellationToken()));
+    }
+
+    bool allSucceeded = true;
+    for (bool success : co_await whenAll(std::move(commands))) {
+        allSucceeded = allSucceeded && success;
+    }
+    co_return allSucceeded;
+}
+
+int throwOnWorker() {
+    throw std::runtime_error("worker failure");
+}
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(AsyncRuntimeTester, RunCommand_ManyCommandsOneWorker_WaitsConcurrently) {
+    AsyncRuntime runtime(1, 1);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(syncWait(runSleepCommands(runtime, 4)));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Waiting on the children must not occupy the single worker
+    EXPECT_LT(elapsed, 1s);
+}
+
+TEST(AsyncRuntimeTester, RunCommandCapture_CapturesOutput) {
+    AsyncRuntime runtime(1);
+
+    std::optional<std::string> output =
+        syncWait(runtime.runCommandCapture("echo async", CancellationToken()));
+
+    ASSERT_TRUE(output.has_value());
+    EXPECT_EQ(*output, "async\n");
+}
+
+TEST(AsyncRuntimeTester, RunCommand_StageDeadlineExceeded_KillsChildPromptly) {
+    AsyncRuntime runtime(1);
+    CancellationToken stageToken = CancellationToken().withTimeout(100ms);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(syncWait(runtime.runCommand("sleep 30", stageToken)));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_LT(elapsed, 5s);
+}
+
+TEST(AsyncRuntimeTester, RunOnWorkers_CallableThrows_RethrowsFromSyncWait) {
+    AsyncRuntime runtime(2);
+
+    EXPECT_EQ(syncWait(runtime.runOnWorkers([]() { return 42; })), 42);
+    EXPECT_THROW(syncWait(runtime.runOnWorkers(throwOnWorker)), std::runtime_error);
+}
+
+TEST(AsyncRuntimeTester, GetWorkerContext_OnWorker_ReturnsThatWorkersContext) {
+    AsyncRuntime runtime(2);
+
+    size_t workerIndex = syncWait(runtime.runOnWorkers(
+        [&runtime]() { return runtime.getWorkerContext().getWorkerIndex(); }));
+
+    EXPECT_LT(workerIndex, 2u);
+    EXPECT_THROW(runtime.getWorkerContext(), std::logic_error);
+}
+
+}  // namespace MediaProcessor::Tests
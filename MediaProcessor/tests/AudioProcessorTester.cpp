@@ -24,15 +24,13 @@ class AudioProcessorTester : public ::testing::Test {
     }
 
     void SetUp() override {
-        fs::path currentPath = fs::current_path();
-
         testVideoPath = testMediaPath / "test_video.mkv";
         testAudioProcessedPath = testMediaPath / "test_audio_processed.wav";
 
         assertFileExists(testVideoPath);
         assertFileExists(testAudioProcessedPath);
 
-        testOutputDir = currentPath / "test_output";
+        testOutputDir = TestUtils::getTestOutputDir();
         fs::create_directories(testOutputDir);
 
         testConfigFile.changeConfigOptions("use_thread_cap", true, "max_threads_if_capped", 1);
@@ -60,4 +58,19 @@ TEST_F(AudioProcessorTester, IsolateVocals_FiltersAudioCorrectly) {
         TestUtils::CompareFiles::compareAudioFiles(testAudioOutputPath, testAudioProcessedPath));
 }
 
+TEST_F(AudioProcessorTester, IsolateVocals_InputShorterThanItsCrossfades_UsesFewerChunks) {
+    testConfigFile.changeConfigOptions("use_thread_cap", true, "max_threads_if_capped", 8);
+    ConfigManager& configManager = ConfigManager::getInstance();
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()))
+        << "Unable to Load TestConfigFile";
+
+    // 8 chunks of 0.2s could not hold two 0.5s crossfades each
+    fs::path testAudioOutputPath = testOutputDir / "test_output_short_audio.wav";
+    AudioProcessor audioProcessor(testVideoPath, testAudioOutputPath);
+    audioProcessor.setPreviewDuration(1.6);
+
+    EXPECT_TRUE(audioProcessor.isolateVocals());
+    EXPECT_TRUE(fs::exists(testAudioOutputPath));
+}
+
 }  // namespace MediaProcessor::Tests
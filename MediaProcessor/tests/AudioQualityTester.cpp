@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+#include "../src/AudioProcessor.h"
+#include "../src/ConfigManager.h"
+#include "QualityMetrics.h"
+#include "TestUtils.h"
+
+namespace fs = std::filesystem;
+namespace MediaProcessor::Tests {
+
+using namespace QualityMetrics;
+
+/**
+ * @brief Guards output quality against performance work on the chunked pipeline.
+ *
+ * Every clip listed in `quality_thresholds.json` is processed as a single chunk, which is the
+ * reference, and again split across each of `chunked_workers`. The chunked outputs must stay
+ * within the configured SI-SDR and log-spectral distance of the reference and show no error
+ * burst or click at the chunk seams; the reference itself must stay close to the clip's
+ * checked-in golden output.
+ */
+class AudioQualityTester : public ::testing::Test {
+   protected:
+    fs::path testMediaPath = TEST_MEDIA_DIR;
+    fs::path testOutputDir;
+    nlohmann::json thresholds;
+    TestUtils::TestConfigFile testConfigFile;
+
+    void SetUp() override {
+        testOutputDir = fs::current_path() / "quality_output";
+        fs::create_directories(testOutputDir);
+
+        std::ifstream thresholdsFile(testMediaPath / "quality_thresholds.json");
+        ASSERT_TRUE(thresholdsFile.is_open());
+        thresholds = nlohmann::json::parse(thresholdsFile);
+    }
+
+    void TearDown() override {
+        fs::remove_all(testOutputDir);
+    }
+
+    /**
+     * @brief Isolates the vocals of `inputPath` split into `numWorkers` chunks.
+     */
+    Signal process(const fs::path& inputPath, unsigned int numWorkers) {
+        testConfigFile.changeConfigOptions("use_thread_cap", true, "max_threads_if_capped",
+                                           numWorkers);
+        EXPECT_TRUE(ConfigManager::getInstance().loadConfig(testConfigFile.getFilePath()));
+
+        fs::path outputPath = testOutputDir / (inputPath.stem().string() + "_" +
+                                               std::to_string(numWorkers) + "_workers.wav");
+        AudioProcessor audioProcessor(inputPath, outputPath);
+        EXPECT_TRUE(audioProcessor.isolateVocals());
+        return loadMono(outputPath);
+    }
+
+    /**
+     * @brief Both edges of the crossfade between every pair of neighbouring chunks.
+     */
+    static std::vector<double> getSeamTimes(const Signal& signal, unsigned int numChunks) {
+        const double chunkDuration =
+            double(signal.samples.size()) / signal.sampleRate / numChunks;
+        std::vector<double> seamTimes;
+        for (unsigned int i = 1; i < numChunks; ++i) {
+            seamTimes.push_back(i * chunkDuration);
+            seamTimes.push_back(i * chunkDuration + DEFAULT_OVERLAP_DURATION);
+        }
+        return seamTimes;
+    }
+};
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST_F(AudioQualityTester, IsolateVocals_ChunkedAcrossWorkers_MatchesSingleChunkReference) {
+    for (const auto& clip : thresholds.at("clips")) {
+        const fs::path inputPath = testMediaPath / clip.at("input").get<std::string>();
+        SCOPED_TRACE(inputPath.filename().string());
+
+        Signal reference = process(inputPath, 1);
+        ASSERT_FALSE(reference.samples.empty());
+
+        if (clip.contains("golden")) {
+            Signal golden = loadMono(testMediaPath / clip.at("golden").get<std::string>());
+            double goldenSiSdr = computeSiSdr(reference.samples, golden.samples);
+            std::cout << "QUALITY: " << inputPath.filename() << " reference vs golden: SI-SDR "
+                      << goldenSiSdr << " dB" << std::endl;
+            EXPECT_GE(goldenSiSdr, thresholds.at("min_golden_si_sdr_db").get<double>());
+        }
+
+        for (unsigned int numWorkers : thresholds.at("chunked_workers")) {
+            SCOPED_TRACE(std::to_string(numWorkers) + " workers");
+            Signal chunked = process(inputPath, numWorkers);
+
+            double siSdr = computeSiSdr(chunked.samples, reference.samples);
+            double spectralDistance =
+                computeLogSpectralDistance(chunked.samples, reference.samples);
+            std::cout << "QUALITY: " << inputPath.filename() << " with " << numWorkers
+                      << " workers: SI-SDR " << siSdr << " dB, log-spectral distance "
+                      << spectralDistance << " dB" << std::endl;
+            EXPECT_GE(siSdr, thresholds.at("min_si_sdr_db").get<double>());
+            EXPECT_LE(spectralDistance,
+                      thresholds.at("max_log_spectral_distance_db").get<double>());
+
+            for (const SeamReport& seam :
+                 analyzeSeams(chunked, reference, getSeamTimes(reference, numWorkers),
+                              thresholds.at("seam_window_seconds").get<double>())) {
+                std::cout << "QUALITY:   seam at " << seam.timeSeconds << "s: local error "
+                          << seam.localErrorDb << " dB, jump ratio " << seam.jumpRatio
+                          << std::endl;
+                EXPECT_LE(seam.localErrorDb, thresholds.at("max_seam_error_db").get<double>())
+                    << "Error burst at the seam at " << seam.timeSeconds << "s";
+                EXPECT_LE(seam.jumpRatio, thresholds.at("max_seam_jump_ratio").get<double>())
+                    << "Click at the seam at " << seam.timeSeconds << "s";
+            }
+        }
+    }
+}
+
+}  // namespace MediaProcessor::Tests
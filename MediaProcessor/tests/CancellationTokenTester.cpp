@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "../src/CancellationToken.h"
+
+namespace MediaProcessor::Tests {
+
+using namespace std::chrono_literals;
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(CancellationTokenTester, Cancel_SharedCopies_ObserveCancellation) {
+    CancellationToken token;
+    CancellationToken copy = token;
+
+    EXPECT_FALSE(copy.isCancelled());
+    token.cancel("user left");
+
+    EXPECT_TRUE(copy.isCancelled());
+    EXPECT_EQ(copy.getReason(), "user left");
+}
+
+TEST(CancellationTokenTester, WithTimeout_DeadlinePasses_CancelsOnlyChild) {
+    CancellationToken parent;
+    CancellationToken stage = parent.withTimeout(20ms);
+
+    EXPECT_FALSE(stage.isCancelled());
+    std::this_thread::sleep_for(40ms);
+
+    EXPECT_TRUE(stage.isCancelled());
+    EXPECT_EQ(stage.getReason(), "stage deadline exceeded");
+    EXPECT_FALSE(parent.isCancelled());
+}
+
+TEST(CancellationTokenTester, WithTimeout_ParentCancelled_PropagatesReason) {
+    CancellationToken parent;
+    CancellationToken stage = parent.withTimeout(std::chrono::seconds(0));
+
+    parent.cancel("terminated (SIGTERM)");
+
+    EXPECT_TRUE(stage.isCancelled());
+    EXPECT_EQ(stage.getReason(), "terminated (SIGTERM)");
+}
+
+}  // namespace MediaProcessor::Tests
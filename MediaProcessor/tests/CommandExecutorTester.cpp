@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "../src/AsyncRuntime.h"
+#include "../src/CommandBuilder.h"
+#include "../src/CommandExecutor.h"
+
+namespace MediaProcessor::Tests {
+
+namespace fs = std::filesystem;
+
+class CommandExecutorTest : public ::testing::Test {
+   protected:
+    fs::path testDir;
+    fs::path cassettePath;
+    fs::path recordRoot;
+    fs::path replayRoot;
+
+    void SetUp() override {
+        testDir = fs::temp_directory_path() / "command_executor_tester";
+        fs::remove_all(testDir);
+        cassettePath = testDir / "cassette";
+        recordRoot = testDir / "record root";
+        replayRoot = testDir / "replay_root";
+        fs::create_directories(recordRoot);
+        fs::create_directories(replayRoot);
+    }
+
+    void TearDown() override {
+        fs::remove_all(testDir);
+    }
+
+    static std::string copyCommand(const fs::path& root) {
+        CommandBuilder cmd;
+        cmd.addArgument("cp");
+        cmd.addArgument((root / "input.txt").string());
+        cmd.addArgument((root / "chunks" / "output.txt").string());
+        return cmd.build();
+    }
+
+    static std::string readFile(const fs::path& path) {
+        std::ifstream file(path);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+};
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST_F(CommandExecutorTest, Replay_RecordedInOtherRoot_RestoresOutputWithoutRunning) {
+    std::ofstream(recordRoot / "input.txt") << "recorded";
+    fs::create_directories(recordRoot / "chunks");
+    {
+        AsyncRuntime runtime(1);
+        ASSERT_TRUE(
+            installCommandCassette(runtime, {CassetteMode::Record, cassettePath, recordRoot}));
+        EXPECT_TRUE(syncWait(runtime.runCommand(copyCommand(recordRoot), CancellationToken())));
+        EXPECT_EQ(syncWait(runtime.runCommandCapture("echo recorded", CancellationToken())),
+                  "recorded\n");
+    }
+
+    // The replay root has no input, so running `cp` for real would fail
+    AsyncRuntime runtime(1);
+    ASSERT_TRUE(installCommandCassette(runtime, {CassetteMode::Replay, cassettePath, replayRoot}));
+
+    EXPECT_TRUE(syncWait(runtime.runCommand(copyCommand(replayRoot), CancellationToken())));
+    EXPECT_EQ(readFile(replayRoot / "chunks" / "output.txt"), "recorded");
+    EXPECT_FALSE(fs::exists(replayRoot / "input.txt"));
+    EXPECT_EQ(syncWait(runtime.runCommandCapture("echo recorded", CancellationToken())),
+              "recorded\n");
+}
+
+TEST_F(CommandExecutorTest, Replay_UnrecordedCommand_Fails) {
+    AsyncRuntime runtime(1);
+    auto cassette = std::make_shared<CommandCassette>(cassettePath, replayRoot);
+    runtime.setCommandExecutor(std::make_shared<ReplayCommandExecutor>(cassette));
+
+    EXPECT_FALSE(syncWait(runtime.runCommand("echo never recorded", CancellationToken())));
+}
+
+TEST_F(CommandExecutorTest, Auto_MissingRecording_RecordsForNextReplay) {
+    {
+        AsyncRuntime runtime(1);
+        ASSERT_TRUE(
+            installCommandCassette(runtime, {CassetteMode::Auto, cassettePath, recordRoot}));
+        EXPECT_FALSE(syncWait(runtime.runCommand("exit 3", CancellationToken())));
+    }
+
+    AsyncRuntime runtime(1);
+    ASSERT_TRUE(installCommandCassette(runtime, {CassetteMode::Replay, cassettePath, recordRoot}));
+    CommandCassette recording(cassettePath, recordRoot);
+    ASSERT_TRUE(recording.load());
+    ASSERT_TRUE(recording.find("exit 3").has_value());
+    EXPECT_EQ(recording.find("exit 3")->returnCode, 3);
+    EXPECT_FALSE(syncWait(runtime.runCommand("exit 3", CancellationToken())));
+}
+
+TEST_F(CommandExecutorTest, Replay_MissingCassette_FailsToInstall) {
+    AsyncRuntime runtime(1);
+    EXPECT_FALSE(installCommandCassette(runtime, {CassetteMode::Replay, cassettePath, replayRoot}));
+}
+
+TEST(CommandExecutorTester, SplitArguments_QuotedWhitespace_KeepsArgumentTogether) {
+    auto arguments = CommandCassette::splitArguments("ffmpeg -i \"my input.wav\"  out.wav");
+
+    ASSERT_EQ(arguments.size(), 4u);
+    EXPECT_EQ(arguments[2], "my input.wav");
+    EXPECT_EQ(arguments[3], "out.wav");
+}
+
+}  // namespace MediaProcessor::Tests
@@ -51,6 +51,159 @@ TEST_F(ConfigManagerTest, LoadValidConfigFile_Succeeds) {
               jsonObject["max_threads_if_capped"].get<unsigned int>());
     EXPECT_EQ(configManager.getFilterAttenuationLimit(),
               jsonObject["filter_attenuation_limit"].get<float>());
+
+    // Optional options fall back to their defaults
+    EXPECT_EQ(configManager.getChunkMaxAttempts(), DEFAULT_CHUNK_MAX_ATTEMPTS);
+}
+
+TEST_F(ConfigManagerTest, GetResourceBudget_PartialBudget_DerivesRemainingEntries) {
+    nlohmann::json jsonObject = {
+        {"use_thread_cap", true},
+        {"max_threads_if_capped", 1},
+        {"resource_budget", {{"total_cores", 8}, {"inference_workers", 6}}},
+    };
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+
+    ResourceBudget budget = configManager.getResourceBudget();
+    EXPECT_EQ(budget.totalCores, 8u);
+    EXPECT_EQ(budget.inferenceWorkers, 6u);
+    EXPECT_EQ(budget.ioThreads, DEFAULT_BUDGET_IO_THREADS);
+    EXPECT_EQ(budget.codecThreads, 2u);
+
+    // Inference cannot claim more than the whole budget, FFmpeg still gets a thread
+    jsonObject["resource_budget"]["inference_workers"] = 20;
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+
+    budget = configManager.getResourceBudget();
+    EXPECT_EQ(budget.inferenceWorkers, 8u);
+    EXPECT_EQ(budget.minInferenceWorkers, 8u);
+    EXPECT_EQ(budget.codecThreads, 1u);
+
+    // The memory budget caps the DFStates, the pool shrinks down to the minimum when idle
+    jsonObject["resource_budget"]["memory_budget_mb"] = 400;
+    jsonObject["resource_budget"]["filter_state_mb"] = 100;
+    jsonObject["resource_budget"]["min_inference_workers"] = 2;
+    jsonObject["resource_budget"]["worker_idle_seconds"] = 30;
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+
+    budget = configManager.getResourceBudget();
+    EXPECT_EQ(budget.inferenceWorkers, 4u);
+    EXPECT_EQ(budget.minInferenceWorkers, 2u);
+    EXPECT_EQ(budget.workerIdleTimeout, std::chrono::seconds(30));
+
+    // Real-time tuning of idle workers and their scheduling
+    jsonObject["resource_budget"]["worker_spin_microseconds"] = 50;
+    jsonObject["resource_budget"]["worker_yield_microseconds"] = 200;
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+
+    budget = configManager.getResourceBudget();
+    EXPECT_EQ(budget.workerSpinTime, std::chrono::microseconds(50));
+    EXPECT_EQ(budget.workerYieldTime, std::chrono::microseconds(200));
+
+    // Realtime workers may only spin briefly, yielding would starve the regular threads
+    jsonObject["resource_budget"]["inference_realtime_priority"] = 10;
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+    EXPECT_THROW(configManager.getResourceBudget(), std::runtime_error);
+
+    jsonObject["resource_budget"]["worker_yield_microseconds"] = 0;
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+    EXPECT_EQ(configManager.getResourceBudget().inferencePriority, 10);
+
+    jsonObject["resource_budget"]["worker_spin_microseconds"] = MAX_REALTIME_SPIN_MICROSECONDS + 1;
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+    EXPECT_THROW(configManager.getResourceBudget(), std::runtime_error);
+
+    jsonObject["resource_budget"]["worker_spin_microseconds"] = 0;
+    jsonObject["resource_budget"]["inference_realtime_priority"] = 100;
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+    EXPECT_THROW(configManager.getResourceBudget(), std::runtime_error);
+
+    // Without a budget everything follows the thread cap
+    jsonObject.erase("resource_budget");
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+
+    budget = configManager.getResourceBudget();
+    EXPECT_EQ(budget.totalCores, 1u);
+    EXPECT_EQ(budget.inferenceWorkers, 1u);
+    EXPECT_EQ(budget.codecThreads, 0u);  // FFmpeg keeps its own threading
+}
+
+TEST_F(ConfigManagerTest, GetRenditions_ParsesOptionalFieldsAndRejectsIncompleteEntries) {
+    nlohmann::json jsonObject = {
+        {"use_thread_cap", false},
+        {"renditions",
+         {{{"name", "mobile"}, {"codec", "libopus"}, {"bitrate", "48k"}, {"extension", "opus"}},
+          {{"name", "asr"},
+           {"codec", "pcm_s16le"},
+           {"sample_rate", 16000},
+           {"channels", 1},
+           {"extension", "wav"}}}},
+    };
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+
+    std::vector<Rendition> renditions = configManager.getRenditions();
+    ASSERT_EQ(renditions.size(), 2u);
+    EXPECT_EQ(renditions[0].bitrate, "48k");
+    EXPECT_EQ(renditions[0].sampleRate, 0u);
+    EXPECT_TRUE(renditions[1].bitrate.empty());
+    EXPECT_EQ(renditions[1].sampleRate, 16000u);
+    EXPECT_EQ(renditions[1].channels, 1u);
+
+    jsonObject["renditions"][0].erase("codec");
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+    EXPECT_THROW(configManager.getRenditions(), std::runtime_error);
+}
+
+TEST_F(ConfigManagerTest, GetLoadShedding_FastTierWithoutModel_Throws) {
+    nlohmann::json jsonObject = {
+        {"use_thread_cap", false},
+        {"load_shedding",
+         {{"policy", "degrade"}, {"max_queue_wait_seconds", 600}, {"preview_seconds", 20}}},
+    };
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+
+    LoadSheddingConfig loadShedding = configManager.getLoadShedding();
+    EXPECT_EQ(loadShedding.policy, SheddingPolicy::Degrade);
+    EXPECT_EQ(loadShedding.maxQueueWait, std::chrono::seconds(600));
+    EXPECT_EQ(loadShedding.degradeTier, QualityTier::Preview);
+    EXPECT_DOUBLE_EQ(loadShedding.previewSeconds, 20.0);
+
+    jsonObject["load_shedding"]["degrade_to"] = "fast";
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+    EXPECT_THROW(configManager.getLoadShedding(), std::runtime_error);
+}
+
+TEST_F(ConfigManagerTest, GetTenantWeights_NonPositiveWeight_Throws) {
+    nlohmann::json jsonObject = {{"use_thread_cap", false}};
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+    EXPECT_TRUE(configManager.getTenantWeights().empty());
+
+    jsonObject["tenant_weights"] = {{"studio", 4}, {"bulk", 0.5}};
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+    std::map<std::string, double> weights = configManager.getTenantWeights();
+    ASSERT_EQ(weights.size(), 2u);
+    EXPECT_DOUBLE_EQ(weights["studio"], 4.0);
+    EXPECT_DOUBLE_EQ(weights["bulk"], 0.5);
+
+    jsonObject["tenant_weights"]["bulk"] = 0;
+    testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+    ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()));
+    EXPECT_THROW(configManager.getTenantWeights(), std::runtime_error);
 }
 
 TEST_F(ConfigManagerTest, LoadInvalidConfigFile) {
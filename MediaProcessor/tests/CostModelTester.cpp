@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "../src/CostModel.h"
+
+namespace MediaProcessor::Tests {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+JobFeatures makeFeatures(double durationSeconds, unsigned int numWorkers, bool isVideo) {
+    JobFeatures features;
+    features.durationSeconds = durationSeconds;
+    features.channels = 2;
+    features.numWorkers = numWorkers;
+    features.isVideo = isVideo;
+    return features;
+}
+
+JobReport makeReport(const JobFeatures& features, double inferenceCoreSeconds,
+                     double wallSeconds) {
+    JobReport report;
+    report.features = features;
+    report.stageTimes.decodeSeconds = 2.0;
+    report.stageTimes.inferenceCoreSeconds = inferenceCoreSeconds;
+    report.stageTimes.encodeSeconds = 1.0;
+    report.wallSeconds = wallSeconds;
+    return report;
+}
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(CostModelTester, Predict_MoreWorkers_ShortensOnlyInference) {
+    CostModel model;
+
+    CostEstimate serial = model.predict(makeFeatures(100.0, 1, false));
+    CostEstimate parallel = model.predict(makeFeatures(100.0, 4, false));
+
+    EXPECT_DOUBLE_EQ(parallel.inferenceSeconds, serial.inferenceSeconds / 4);
+    EXPECT_DOUBLE_EQ(parallel.decodeSeconds, serial.decodeSeconds);
+    EXPECT_DOUBLE_EQ(serial.muxSeconds, 0.0);
+    EXPECT_GT(model.predict(makeFeatures(100.0, 1, true)).muxSeconds, 0.0);
+}
+
+TEST(CostModelTester, Update_FirstReport_CalibratesExactly) {
+    CostModel model;
+    JobFeatures features = makeFeatures(100.0, 4, false);
+
+    model.update(makeReport(features, 40.0, 14.0));
+
+    CostCoefficients coefficients = model.getCoefficients();
+    EXPECT_DOUBLE_EQ(coefficients.decodeRtfPerChannel, 2.0 / (100.0 * 2));
+    EXPECT_DOUBLE_EQ(coefficients.inferenceRtfPerCore, 0.4);
+    EXPECT_DOUBLE_EQ(coefficients.encodeRtf, 0.01);
+    EXPECT_DOUBLE_EQ(coefficients.fixedOverheadSeconds, 14.0 - (2.0 + 40.0 / 4 + 1.0));
+    EXPECT_DOUBLE_EQ(model.predict(features).getTotalSeconds(), 14.0);
+}
+
+TEST(CostModelTester, Update_LaterReports_MoveTowardsObservation) {
+    CostModel model(0.5);
+    JobFeatures features = makeFeatures(100.0, 1, false);
+
+    model.update(makeReport(features, 40.0, 50.0));
+    model.update(makeReport(features, 80.0, 90.0));
+
+    EXPECT_DOUBLE_EQ(model.getCoefficients().inferenceRtfPerCore, 0.6);
+    EXPECT_EQ(model.getNumObservations(), 2u);
+
+    model.reset();
+    EXPECT_EQ(model.getNumObservations(), 0u);
+}
+
+TEST(CostModelTester, SaveAndLoad_RoundTrip_KeepsCoefficients) {
+    fs::path modelPath = fs::temp_directory_path() / "cost_model_tester.json";
+    CostModel model;
+    model.update(makeReport(makeFeatures(60.0, 2, true), 30.0, 25.0));
+    ASSERT_TRUE(model.save(modelPath));
+
+    CostModel loaded;
+    ASSERT_TRUE(loaded.load(modelPath));
+    EXPECT_DOUBLE_EQ(loaded.getCoefficients().inferenceRtfPerCore,
+                     model.getCoefficients().inferenceRtfPerCore);
+    EXPECT_EQ(loaded.getNumObservations(), 1u);
+
+    fs::remove(modelPath);
+    EXPECT_FALSE(loaded.load(modelPath));
+}
+
+TEST(CostModelTester, JobProgress_CompletedSteps_AccumulateStageTimesAndProgress) {
+    CostModel model;
+    JobProgress progress("job", model.predict(makeFeatures(100.0, 2, false)));
+
+    progress.completeStep(JobStage::Inference, 3.0, 0.5, "filter_0");
+    progress.completeStep(JobStage::Inference, 4.0, 0.5, "filter_1");
+    progress.completeStep(JobStage::Encode, 1.0, 0.0, "crossfade_0");
+
+    StageTimes times = progress.getStageTimes();
+    EXPECT_DOUBLE_EQ(times.inferenceCoreSeconds, 7.0);
+    EXPECT_DOUBLE_EQ(times.encodeSeconds, 1.0);
+    EXPECT_GT(progress.getRemainingSeconds(), 0.0);
+}
+
+TEST(CostModelTester, EtaTracker_AllStagesComplete_ReportsDone) {
+    CostEstimate estimate;
+    estimate.decodeSeconds = 1.0;
+    estimate.inferenceSeconds = 3.0;
+    estimate.overheadSeconds = 5.0;
+    EtaTracker tracker(estimate);
+
+    EXPECT_DOUBLE_EQ(tracker.getFractionDone(), 0.0);
+    tracker.complete(1.0);
+    EXPECT_DOUBLE_EQ(tracker.getFractionDone(), 0.25);
+    tracker.complete(3.0);
+    EXPECT_DOUBLE_EQ(tracker.getFractionDone(), 1.0);
+    EXPECT_DOUBLE_EQ(tracker.getRemainingSeconds(), 0.0);
+}
+
+}  // namespace MediaProcessor::Tests
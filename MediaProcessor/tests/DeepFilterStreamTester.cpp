@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <vector>
+
+#include "../src/DeepFilterStream.h"
+
+namespace fs = std::filesystem;
+namespace MediaProcessor::Tests {
+
+namespace {
+
+const fs::path modelPath = fs::path(TEST_MEDIA_DIR).parent_path().parent_path() /
+                           "res/DeepFilterNet3_ll_onnx.tar.gz";
+
+std::vector<float> makeSignal(size_t numSamples) {
+    std::vector<float> signal(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        double t = i / DEEPFILTER_SAMPLE_RATE;
+        signal[i] = static_cast<float>(0.3 * std::sin(2.0 * std::numbers::pi * 220.0 * t) +
+                                       0.1 * std::sin(2.0 * std::numbers::pi * 3100.0 * t));
+    }
+    return signal;
+}
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(DeepFilterStreamTester, Process_OddBlockSizes_MatchesWholeHops) {
+    DeepFilterStream hopStream(modelPath, 100.0f);
+    DeepFilterStream blockStream(modelPath, 100.0f);
+    const size_t hopLength = hopStream.getHopLength();
+    ASSERT_GT(hopLength, 0u);
+
+    const std::vector<float> input = makeSignal(hopLength * 40);
+    std::vector<float> expected(input.size());
+    for (size_t offset = 0; offset < input.size(); offset += hopLength) {
+        hopStream.process(input.data() + offset, expected.data() + offset, hopLength);
+    }
+
+    // Host blocks rarely line up with hops; filtered in place like many hosts do
+    std::vector<float> inPlace = input;
+    size_t blockSize = 1;
+    for (size_t offset = 0; offset < inPlace.size(); offset += blockSize) {
+        blockSize = std::min(blockSize * 7 % 997, inPlace.size() - offset);
+        blockStream.process(inPlace.data() + offset, inPlace.data() + offset, blockSize);
+    }
+
+    EXPECT_EQ(inPlace, expected);
+    for (size_t i = 0; i < hopLength; ++i) {
+        ASSERT_EQ(expected[i], 0.0f) << "Output before the first hop must be silent";
+    }
+}
+
+TEST(DeepFilterStreamTester, Flush_BorrowedState_MatchesDirectHopLoop) {
+    DFState* filterState = df_create(modelPath.c_str(), 100.0f, nullptr);
+    DFState* referenceState = df_create(modelPath.c_str(), 100.0f, nullptr);
+    ASSERT_TRUE(filterState && referenceState);
+    const size_t hopLength = df_get_frame_length(filterState);
+    const size_t modelDelay = getModelDelay(modelPath, hopLength);
+    const size_t latency = hopLength + modelDelay;
+
+    // The reference runs the model hop by hop on the input padded with silence, as many hops as
+    // the stream completes, and drops the model's own delay
+    const std::vector<float> input = makeSignal(hopLength * 10 + hopLength / 3);
+    std::vector<float> padded = input;
+    padded.resize((input.size() + latency) / hopLength * hopLength, 0.0f);
+    std::vector<float> expected(padded.size());
+    std::vector<float> expectedLsnrs;
+    for (size_t offset = 0; offset < padded.size(); offset += hopLength) {
+        expectedLsnrs.push_back(
+            df_process_frame(referenceState, padded.data() + offset, expected.data() + offset));
+    }
+    expected.erase(expected.begin(), expected.begin() + modelDelay);
+    expected.resize(input.size());
+
+    {
+        DeepFilterStream stream(filterState, modelPath, 100.0f);
+        ASSERT_EQ(stream.getLatency(), latency);
+        std::vector<float> output(input.size() + latency);
+        std::vector<float> lsnrs;
+        auto onHop = [&lsnrs](float lsnr, const float*) { lsnrs.push_back(lsnr); };
+        stream.process(input.data(), output.data(), input.size(), onHop);
+        stream.flush(output.data() + input.size(), onHop);
+
+        output.erase(output.begin(), output.begin() + latency);
+        EXPECT_EQ(output, expected);
+        EXPECT_EQ(lsnrs, expectedLsnrs);
+    }
+
+    // The stream left the borrowed state alive
+    df_free(filterState);
+    df_free(referenceState);
+}
+
+TEST(DeepFilterStreamTester, Reset_AfterAudio_StartsLikeAFreshStream) {
+    DeepFilterStream stream(modelPath, 100.0f);
+    const size_t hopLength = stream.getHopLength();
+    std::vector<float> input = makeSignal(hopLength * 10);
+    std::vector<float> output(input.size());
+    stream.process(input.data(), output.data(), input.size() - hopLength / 2);
+
+    stream.reset();
+    std::vector<float> silence(hopLength, 0.0f);
+    std::vector<float> flushed(hopLength, 1.0f);
+    stream.process(silence.data(), flushed.data(), hopLength);
+    for (float sample : flushed) {
+        ASSERT_EQ(sample, 0.0f) << "Buffered audio leaked past reset()";
+    }
+}
+
+TEST(DeepFilterStreamTester, GetModelDelay_ModelConfigs_AddsOverlapAndLookahead) {
+    // The bundled low-latency model has a two-hop window and no lookahead
+    EXPECT_EQ(getModelDelay(modelPath, 480), 480u);
+    EXPECT_EQ(getModelDelay(fs::temp_directory_path() / "missing.tar.gz", 480), 480u);
+
+    const fs::path modelDir = fs::temp_directory_path() / "DeepFilterStreamTester_model";
+    fs::create_directories(modelDir / "tmp/export");
+    {
+        std::ofstream config(modelDir / "tmp/export/config.ini");
+        config << "[df]\nfft_size = 960\nhop_size = 480\ndf_lookahead = 2\n"
+               << "[deepfilternet]\nconv_lookahead = 1\n";
+    }
+    EXPECT_EQ(getModelDelay(modelDir, 480), 480u + 2 * 480u);
+    EXPECT_EQ(getModelDelay(modelDir.string() + ".tar.gz", 480), 480u + 2 * 480u);
+    fs::remove_all(modelDir);
+}
+
+}  // namespace MediaProcessor::Tests
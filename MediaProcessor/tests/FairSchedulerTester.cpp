@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <time.h>
+
+#include <algorithm>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../src/AsyncTask.h"
+#include "../src/FairScheduler.h"
+
+namespace MediaProcessor::Tests {
+
+namespace {
+
+Task<void> runTenantTask(FairScheduler& scheduler, std::string tenant,
+                         std::vector<std::string>& order) {
+    FairScheduler::Lease lease = co_await scheduler.acquire(tenant, 1.0);
+    order.push_back(tenant);
+}
+
+double getThreadCpuSeconds() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+Task<void> openGate(std::promise<void>& gate) {
+    gate.set_value();
+    co_return;
+}
+
+/**
+ * @brief Queues `tenants` in the given order while the only worker is held, so the admission
+ *        order is decided by the scheduler alone, then runs them all.
+ */
+std::vector<std::string> runInFairOrder(const std::vector<std::string>& tenants,
+                                        const std::map<std::string, double>& weights) {
+    ThreadPool pool(1);
+    FairScheduler scheduler(pool, 1);
+    scheduler.setWeights(weights);
+
+    std::promise<void> gate;
+    pool.post([opened = gate.get_future()]() { opened.wait(); });
+
+    std::vector<std::string> order;
+    std::vector<Task<void>> tasks;
+    for (const auto& tenant : tenants) {
+        tasks.push_back(runTenantTask(scheduler, tenant, order));
+    }
+    tasks.push_back(openGate(gate));
+    syncWait(whenAll(std::move(tasks)));
+    return order;
+}
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(FairSchedulerTester, Acquire_BacklogOfOneTenant_DoesNotStarveLaterTenant) {
+    std::vector<std::string> tenants(6, "bulk");
+    tenants.insert(tenants.end(), 2, "interactive");
+
+    std::vector<std::string> order = runInFairOrder(tenants, {});
+
+    ASSERT_EQ(order.size(), tenants.size());
+    EXPECT_EQ(order[1], "interactive");
+    EXPECT_EQ(order[3], "interactive");
+}
+
+TEST(FairSchedulerTester, Acquire_WeightedTenants_AdmitsInProportionToWeight) {
+    std::vector<std::string> tenants(8, "gold");
+    tenants.insert(tenants.end(), 8, "bronze");
+
+    std::vector<std::string> order = runInFairOrder(tenants, {{"gold", 3.0}, {"bronze", 1.0}});
+
+    ASSERT_EQ(order.size(), tenants.size());
+    EXPECT_EQ(std::count(order.begin(), order.begin() + 8, "gold"), 6);
+}
+
+TEST(FairSchedulerTester, GetUsage_CompletedTasks_AccountsCpuTimePerTenant) {
+    ThreadPool pool(2);
+    FairScheduler scheduler(pool, 2);
+    scheduler.setWeight("busy", 2.0);
+
+    auto spin = [&scheduler](std::string tenant, double cpuSeconds) -> Task<void> {
+        FairScheduler::Lease lease = co_await scheduler.acquire(tenant, 1.0);
+        // Spins on CPU time rather than wall time, so a loaded machine cannot shorten it
+        const double end = getThreadCpuSeconds() + cpuSeconds;
+        while (getThreadCpuSeconds() < end) {
+        }
+    };
+    std::vector<Task<void>> tasks;
+    tasks.push_back(spin("busy", 0.1));
+    tasks.push_back(spin("idle", 0.0));
+    syncWait(whenAll(std::move(tasks)));
+
+    std::map<std::string, TenantUsage> usage = scheduler.getUsage();
+    EXPECT_DOUBLE_EQ(usage["busy"].weight, 2.0);
+    EXPECT_EQ(usage["busy"].completedTasks, 1u);
+    EXPECT_GE(usage["busy"].cpuSeconds, 0.1);
+    EXPECT_LT(usage["idle"].cpuSeconds, 0.05);
+    EXPECT_EQ(usage["idle"].queuedTasks, 0u);
+}
+
+}  // namespace MediaProcessor::Tests
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "../src/FolderWatcher.h"
+
+namespace fs = std::filesystem;
+namespace MediaProcessor::Tests {
+
+namespace {
+
+constexpr auto BATCH_WINDOW = std::chrono::milliseconds(100);
+
+class FolderWatcherTester : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        m_inbox = fs::temp_directory_path() /
+                  ("folder_watcher_test_" + std::to_string(getpid()) + "_" +
+                   ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(m_inbox);
+        fs::create_directories(m_inbox);
+    }
+
+    void TearDown() override { fs::remove_all(m_inbox); }
+
+    void write(const fs::path& path, const std::string& content) {
+        std::ofstream(path, std::ios::app) << content;
+    }
+
+    fs::path m_inbox;
+};
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST_F(FolderWatcherTester, WaitForBatch_FilesPresentAtStart_AreReported) {
+    write(m_inbox / "b.wav", "b");
+    write(m_inbox / "a.wav", "a");
+    write(m_inbox / ".a.wav.part", "partial");
+
+    FolderWatcher watcher({m_inbox}, BATCH_WINDOW);
+    ASSERT_TRUE(watcher.start());
+    EXPECT_EQ(watcher.waitForBatch(CancellationToken()),
+              (std::vector<fs::path>{m_inbox / "a.wav", m_inbox / "b.wav"}));
+}
+
+TEST_F(FolderWatcherTester, WaitForBatch_FileStillWrittenAtStart_IsReportedOnceItSettles) {
+    std::ofstream upload(m_inbox / "upload.wav");
+    upload << "chunk" << std::flush;
+
+    FolderWatcher watcher({m_inbox}, BATCH_WINDOW);
+    ASSERT_TRUE(watcher.start());
+
+    // Written without closing the file, so only its size tells the watcher it is not done
+    std::thread writer([&upload] {
+        for (int i = 0; i < 6; ++i) {
+            std::this_thread::sleep_for(BATCH_WINDOW / 2);
+            upload << "chunk" << std::flush;
+        }
+    });
+    auto start = std::chrono::steady_clock::now();
+    std::vector<fs::path> batch = watcher.waitForBatch(CancellationToken());
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    writer.join();
+
+    EXPECT_EQ(batch, std::vector<fs::path>{m_inbox / "upload.wav"});
+    EXPECT_GE(elapsed, 3 * BATCH_WINDOW);
+}
+
+TEST_F(FolderWatcherTester, WaitForBatch_FileRewrittenWithinWindow_IsReportedOnceAfterIt) {
+    FolderWatcher watcher({m_inbox}, BATCH_WINDOW);
+    ASSERT_TRUE(watcher.start());
+
+    std::thread writer([this] {
+        for (int i = 0; i < 5; ++i) {
+            write(m_inbox / "take.wav", "chunk");
+            std::this_thread::sleep_for(BATCH_WINDOW / 4);
+        }
+    });
+    auto start = std::chrono::steady_clock::now();
+    std::vector<fs::path> batch = watcher.waitForBatch(CancellationToken());
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    writer.join();
+
+    EXPECT_EQ(batch, std::vector<fs::path>{m_inbox / "take.wav"});
+    EXPECT_GE(elapsed, BATCH_WINDOW);  // the last write restarted the window
+}
+
+TEST_F(FolderWatcherTester, WaitForBatch_HiddenAndMovedInFiles_OnlyMovedInIsReported) {
+    FolderWatcher watcher({m_inbox}, BATCH_WINDOW);
+    ASSERT_TRUE(watcher.start());
+
+    write(m_inbox / ".upload.part", "partial");
+    write(m_inbox.parent_path() / (m_inbox.filename().string() + ".staged"), "whole");
+    fs::rename(m_inbox.parent_path() / (m_inbox.filename().string() + ".staged"),
+               m_inbox / "moved.wav");
+    EXPECT_EQ(watcher.waitForBatch(CancellationToken()),
+              std::vector<fs::path>{m_inbox / "moved.wav"});
+}
+
+TEST_F(FolderWatcherTester, WaitForBatch_Cancelled_ReturnsEmptyBatch) {
+    FolderWatcher watcher({m_inbox}, BATCH_WINDOW);
+    ASSERT_TRUE(watcher.start());
+
+    CancellationToken token;
+    std::thread canceller([token]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        token.cancel();
+    });
+    EXPECT_TRUE(watcher.waitForBatch(token).empty());
+    canceller.join();
+}
+
+TEST_F(FolderWatcherTester, Start_MissingDirectory_Fails) {
+    FolderWatcher watcher({m_inbox / "missing"}, BATCH_WINDOW);
+    EXPECT_FALSE(watcher.start());
+}
+
+}  // namespace MediaProcessor::Tests
@@ -0,0 +1,150 @@
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "../src/HttpServer.h"
+#include "TestUtils.h"
+
+namespace MediaProcessor::Tests {
+
+namespace fs = std::filesystem;
+using TestUtils::getBody;
+using TestUtils::requestLocalhost;
+
+namespace {
+
+constexpr uint64_t MAX_TEST_UPLOAD_BYTES = 8 << 20;
+
+}  // namespace
+
+class HttpServerTest : public ::testing::Test {
+   protected:
+    fs::path testDir = fs::temp_directory_path() / "http_server_tester";
+    HttpServer server{"127.0.0.1:0", 2};
+
+    void SetUp() override {
+        fs::create_directories(testDir);
+        server.addRoute("GET", "/files/", [this](const HttpRequest& request, HttpConnection& c) {
+            c.sendFile(request, testDir / request.path.substr(7));
+        });
+        server.addRoute("HEAD", "/files/", [this](const HttpRequest& request, HttpConnection& c) {
+            c.sendFile(request, testDir / request.path.substr(7));
+        });
+        server.addRoute("PUT", "/upload", [this](const HttpRequest& request, HttpConnection& c) {
+            int status = c.receiveBody(request, testDir / "upload.bin", MAX_TEST_UPLOAD_BYTES);
+            c.sendResponse(status == 0 ? 200 : status, "text/plain", "done\n");
+        });
+        ASSERT_TRUE(server.start());
+    }
+
+    void TearDown() override { fs::remove_all(testDir); }
+};
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST_F(HttpServerTest, SendFile_RangeRequests_ServesPartialContent) {
+    std::string content;
+    for (int i = 0; i < 100; ++i) {
+        content += "0123456789";
+    }
+    std::ofstream(testDir / "clip.webm", std::ios::binary) << content;
+    const uint16_t port = server.getPort();
+
+    std::string response = requestLocalhost(port, "GET /files/clip.webm HTTP/1.1\r\n\r\n");
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 200 OK\r\n"));
+    EXPECT_NE(response.find("Content-Type: video/webm\r\n"), std::string::npos);
+    EXPECT_NE(response.find("Accept-Ranges: bytes\r\n"), std::string::npos);
+    EXPECT_EQ(getBody(response), content);
+
+    response =
+        requestLocalhost(port, "GET /files/clip.webm HTTP/1.1\r\nRange: bytes=15-24\r\n\r\n");
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 206 Partial Content\r\n"));
+    EXPECT_NE(response.find("Content-Range: bytes 15-24/1000\r\n"), std::string::npos);
+    EXPECT_EQ(getBody(response), "5678901234");
+
+    response = requestLocalhost(port, "GET /files/clip.webm HTTP/1.1\r\nrange: bytes=-3\r\n\r\n");
+    EXPECT_NE(response.find("Content-Range: bytes 997-999/1000\r\n"), std::string::npos);
+    EXPECT_EQ(getBody(response), "789");
+
+    response =
+        requestLocalhost(port, "GET /files/clip.webm HTTP/1.1\r\nRange: bytes=1000-\r\n\r\n");
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 416 Range Not Satisfiable\r\n"));
+    EXPECT_NE(response.find("Content-Range: bytes */1000\r\n"), std::string::npos);
+
+    response = requestLocalhost(port, "HEAD /files/clip.webm HTTP/1.1\r\n\r\n");
+    EXPECT_NE(response.find("Content-Length: 1000\r\n"), std::string::npos);
+    EXPECT_TRUE(getBody(response).empty());
+
+    response = requestLocalhost(port, "GET /files/missing.wav HTTP/1.1\r\n\r\n");
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 404 Not Found\r\n"));
+    response = requestLocalhost(port, "DELETE /files/clip.webm HTTP/1.1\r\n\r\n");
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 404 Not Found\r\n"));
+}
+
+TEST_F(HttpServerTest, ReceiveBody_LargeUpload_StreamsBodyToFile) {
+    std::string body(3 << 20, '\0');
+    for (size_t i = 0; i < body.size(); ++i) {
+        body[i] = static_cast<char>(i * 31 % 251);
+    }
+    const uint16_t port = server.getPort();
+
+    std::string response = requestLocalhost(
+        port, "PUT /upload HTTP/1.1\r\nContent-Length: " + std::to_string(body.size()) +
+                  "\r\n\r\n" + body);
+    ASSERT_TRUE(response.starts_with("HTTP/1.1 200 OK\r\n"));
+    std::ifstream upload(testDir / "upload.bin", std::ios::binary);
+    std::string received((std::istreambuf_iterator<char>(upload)), {});
+    EXPECT_EQ(received.size(), body.size());
+    EXPECT_TRUE(received == body);
+
+    response = requestLocalhost(port, "PUT /upload HTTP/1.1\r\n\r\n");
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 411 Length Required\r\n"));
+
+    response = requestLocalhost(port, "PUT /upload HTTP/1.1\r\nContent-Length: " +
+                                          std::to_string(MAX_TEST_UPLOAD_BYTES + 1) + "\r\n\r\n");
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 413 Content Too Large\r\n"));
+}
+
+TEST_F(HttpServerTest, ReceiveBody_ExpectContinue_AnswersContinueBeforeBodyIsSent) {
+    const std::string body = "take";
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(server.getPort());
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    timeval timeout{2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    const std::string header = "PUT /upload HTTP/1.1\r\nExpect: 100-continue\r\nContent-Length: " +
+                               std::to_string(body.size()) + "\r\n\r\n";
+    send(fd, header.data(), header.size(), MSG_NOSIGNAL);
+    char buffer[4096];
+    ssize_t bytesRead = recv(fd, buffer, sizeof(buffer), 0);
+    EXPECT_EQ(std::string(buffer, std::max<ssize_t>(bytesRead, 0)),
+              "HTTP/1.1 100 Continue\r\n\r\n");
+
+    send(fd, body.data(), body.size(), MSG_NOSIGNAL);
+    std::string response;
+    while ((bytesRead = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, bytesRead);
+    }
+    close(fd);
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 200 OK\r\n"));
+    std::ifstream upload(testDir / "upload.bin", std::ios::binary);
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(upload), {}), body);
+}
+
+TEST(HttpServerTester, GetContentType_ByExtension) {
+    EXPECT_EQ(getContentType("talk_processed_video.mp4"), "video/mp4");
+    EXPECT_EQ(getContentType("talk_isolated_audio.WAV"), "audio/wav");
+    EXPECT_EQ(getContentType("talk_mobile.opus"), "audio/ogg");
+    EXPECT_EQ(getContentType("talk.unknown"), "application/octet-stream");
+}
+
+}  // namespace MediaProcessor::Tests
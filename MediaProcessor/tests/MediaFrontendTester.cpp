@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+
+#include "../src/AsyncRuntime.h"
+#include "../src/ConfigManager.h"
+#include "../src/CostModel.h"
+#include "../src/HttpServer.h"
+#include "../src/MediaFrontend.h"
+#include "TestUtils.h"
+
+namespace fs = std::filesystem;
+namespace MediaProcessor::Tests {
+
+namespace {
+
+constexpr auto JOB_TIMEOUT = std::chrono::seconds(10);
+
+class MediaFrontendTester : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        m_uploads = fs::temp_directory_path() /
+                    ("media_frontend_test_" + std::to_string(getpid()) + "_" +
+                     ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(m_uploads);
+        fs::create_directories(m_uploads);
+
+        nlohmann::json config = {{"ffmpeg_path", "/usr/bin/ffmpeg"},
+                                 {"deep_filter_path", "missing"},
+                                 {"filter_attenuation_limit", 100.0f},
+                                 {"use_thread_cap", false},
+                                 {"max_threads_if_capped", 1},
+                                 {"max_concurrent_jobs", 1}};
+        m_configFile.generateConfigFile(m_uploads.parent_path() / (m_uploads.filename().string() +
+                                                                   ".json"),
+                                        config);
+        ASSERT_TRUE(ConfigManager::getInstance().loadConfig(m_configFile.getFilePath()));
+
+        m_runtime.setCommandExecutor(std::make_shared<TestUtils::ProbeOnlyExecutor>());
+        m_frontend = std::make_unique<MediaFrontend>(
+            m_runtime, m_costModel, HttpServerConfig{"127.0.0.1:0", 2, 0, m_uploads});
+        m_server = std::make_unique<HttpServer>("127.0.0.1:0", 2);
+        m_frontend->registerRoutes(*m_server);
+        ASSERT_TRUE(m_server->start());
+    }
+
+    void TearDown() override {
+        m_server.reset();
+        m_frontend.reset();
+        fs::remove_all(m_uploads);
+    }
+
+    std::string upload(const std::string& name, const std::string& content) {
+        return TestUtils::requestLocalhost(
+            m_server->getPort(), "PUT /upload/" + name + " HTTP/1.1\r\nHost: localhost\r\n" +
+                                     "Content-Length: " + std::to_string(content.size()) +
+                                     "\r\n\r\n" + content);
+    }
+
+    nlohmann::json getJob(const std::string& name) {
+        std::string response = TestUtils::requestLocalhost(
+            m_server->getPort(), "GET /jobs/" + name + " HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        return nlohmann::json::parse(TestUtils::getBody(response), nullptr, false);
+    }
+
+    fs::path m_uploads;
+    TestUtils::TestConfigFile m_configFile;
+    AsyncRuntime m_runtime{1};
+    CostModel m_costModel;
+    std::unique_ptr<MediaFrontend> m_frontend;
+    std::unique_ptr<HttpServer> m_server;
+};
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST_F(MediaFrontendTester, Upload_AdmittedJob_AnswersQueuedThenReportsItsStatus) {
+    std::string response = upload("take.wav", "take");
+
+    ASSERT_TRUE(response.starts_with("HTTP/1.1 202 Accepted\r\n")) << response;
+    nlohmann::json body = nlohmann::json::parse(TestUtils::getBody(response));
+    EXPECT_EQ(body["status"], "queued");
+    EXPECT_EQ(body["status_url"], "/jobs/take.wav");
+    EXPECT_EQ(body["report_url"], "/media/take_report.json");
+
+    // The job fails without FFmpeg, which the status reports once it is done
+    nlohmann::json job = getJob("take.wav");
+    const auto deadline = std::chrono::steady_clock::now() + JOB_TIMEOUT;
+    while (job.value("status", "") == "queued" && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        job = getJob("take.wav");
+    }
+    EXPECT_EQ(job["status"], "failed");
+    EXPECT_FALSE(job.contains("media_url"));
+}
+
+TEST_F(MediaFrontendTester, Upload_NameTaken_IsRefusedAndLeavesTheFileAlone) {
+    std::ofstream(m_uploads / "take.wav") << "earlier";
+
+    EXPECT_TRUE(upload("take.wav", "take").starts_with("HTTP/1.1 409 Conflict\r\n"));
+    std::ifstream file(m_uploads / "take.wav");
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(file), {}), "earlier");
+    EXPECT_EQ(std::distance(fs::directory_iterator(m_uploads), fs::directory_iterator()), 1);
+}
+
+TEST_F(MediaFrontendTester, Upload_OutputNameTaken_IsRefused) {
+    std::ofstream(m_uploads / "take_processed.wav") << "earlier";
+
+    EXPECT_TRUE(upload("take.wav", "take").starts_with("HTTP/1.1 409 Conflict\r\n"));
+    EXPECT_FALSE(fs::exists(m_uploads / "take.wav"));
+}
+
+TEST_F(MediaFrontendTester, Upload_NotMedia_AnswersUnprocessableAndLeavesNothing) {
+    EXPECT_TRUE(
+        upload("broken.wav", "broken").starts_with("HTTP/1.1 422 Unprocessable Content\r\n"));
+    EXPECT_TRUE(fs::is_empty(m_uploads));
+}
+
+}  // namespace MediaProcessor::Tests
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include "../src/Metrics.h"
+#include "../src/MetricsServer.h"
+
+namespace MediaProcessor::Tests {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * @brief Sends `request` to the Unix socket at `socketPath` and returns the whole response.
+ */
+std::string requestUnixSocket(const fs::path& socketPath, const std::string& request) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        close(fd);
+        return "";
+    }
+
+    send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char buffer[4096];
+    ssize_t bytesRead;
+    while ((bytesRead = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, bytesRead);
+    }
+    close(fd);
+    return response;
+}
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(MetricsTester, Observe_Durations_RendersCumulativeBuckets) {
+    Histogram histogram;
+    histogram.observe(0.2);
+    histogram.observe(0.25);
+    histogram.observe(1000.0);
+
+    EXPECT_EQ(histogram.getBucketCount(3), 2u);  // le="0.25" includes its bound
+    EXPECT_EQ(histogram.getBucketCount(LATENCY_BUCKET_BOUNDS.size()), 1u);
+    EXPECT_EQ(histogram.getCount(), 3u);
+    EXPECT_DOUBLE_EQ(histogram.getSum(), 1000.45);
+
+    Metrics& metrics = Metrics::getInstance();
+    metrics.observeStep(JobStage::Mux, 0.2);
+    metrics.observeStep(JobStage::Mux, 1000.0);
+    const std::string text = metrics.render();
+
+    EXPECT_NE(text.find("# TYPE mediaprocessor_step_seconds histogram"), std::string::npos);
+    EXPECT_NE(text.find("mediaprocessor_step_seconds_bucket{stage=\"mux\",le=\"0.25\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("mediaprocessor_step_seconds_bucket{stage=\"mux\",le=\"+Inf\"} 2\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("mediaprocessor_step_seconds_count{stage=\"mux\"} 2\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("process_resident_memory_bytes "), std::string::npos);
+}
+
+TEST(MetricsTester, Start_UnixSocket_ServesMetricsAndRemovesSocket) {
+    const fs::path socketPath = fs::temp_directory_path() / "metrics_tester.sock";
+    Metrics::getInstance().childProcesses.add(3);
+    {
+        MetricsServer server(std::string(LISTENER_UNIX_PREFIX) + socketPath.string());
+        ASSERT_TRUE(server.start());
+
+        std::string response =
+            requestUnixSocket(socketPath, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        EXPECT_TRUE(response.starts_with("HTTP/1.1 200 OK\r\n"));
+        EXPECT_NE(response.find("\nmediaprocessor_child_processes 3\n"), std::string::npos);
+
+        response = requestUnixSocket(socketPath, "GET / HTTP/1.1\r\n\r\n");
+        EXPECT_TRUE(response.starts_with("HTTP/1.1 404 Not Found\r\n"));
+    }
+    Metrics::getInstance().childProcesses.add(-3);
+
+    EXPECT_FALSE(fs::exists(socketPath));
+}
+
+}  // namespace MediaProcessor::Tests
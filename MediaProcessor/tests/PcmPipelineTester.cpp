@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../src/PcmPipeline.h"
+
+namespace MediaProcessor::Tests {
+
+namespace {
+
+template <typename Sample>
+std::vector<Sample> makeSamples(size_t numSamples, float amplitude) {
+    std::vector<Sample> samples(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        samples[i] = static_cast<Sample>(amplitude * (float((i * 7919) % 2001) / 1000.0f - 1.0f));
+    }
+    return samples;
+}
+
+template <typename Sample, int Channels>
+void expectMatchesGeneric(float amplitude) {
+    using Specialised = PcmPipeline<Sample, Channels>;
+    using Generic = PcmPipeline<Sample, DYNAMIC_CHANNELS>;
+    const size_t numFrames = 1001;  // odd, so vector epilogues run too
+    const std::vector<Sample> tail = makeSamples<Sample>(numFrames * Channels, amplitude);
+    const std::vector<Sample> head = makeSamples<Sample>(numFrames * Channels, -amplitude);
+
+    std::vector<Sample> expected(tail.size()), actual(tail.size());
+    Generic::crossfade(tail.data(), head.data(), expected.data(), 0, numFrames, numFrames,
+                       Channels);
+    Specialised::crossfade(tail.data(), head.data(), actual.data(), 0, numFrames, numFrames, 0);
+    EXPECT_EQ(actual, expected);
+
+    expected = tail;
+    actual = tail;
+    Generic::applyGain(expected.data(), numFrames, Channels, 1.7f);
+    Specialised::applyGain(actual.data(), numFrames, 0, 1.7f);
+    EXPECT_EQ(actual, expected);
+
+    std::vector<float> expectedFloat(tail.size()), actualFloat(tail.size());
+    Generic::toFloat(tail.data(), expectedFloat.data(), numFrames, Channels);
+    Specialised::toFloat(tail.data(), actualFloat.data(), numFrames, 0);
+    EXPECT_EQ(actualFloat, expectedFloat);
+
+    Generic::fromFloat(expectedFloat.data(), expected.data(), numFrames, Channels);
+    Specialised::fromFloat(actualFloat.data(), actual.data(), numFrames, 0);
+    EXPECT_EQ(actual, expected);
+}
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(PcmPipelineTester, Specialisations_CommonLayouts_MatchGenericPipeline) {
+    expectMatchesGeneric<int16_t, 1>(30000.0f);
+    expectMatchesGeneric<int16_t, 2>(30000.0f);
+    expectMatchesGeneric<float, 1>(0.9f);
+    expectMatchesGeneric<float, 2>(0.9f);
+}
+
+TEST(PcmPipelineTester, Crossfade_Int16_IsTriangular) {
+    const size_t numFrames = 4;
+    const std::vector<int16_t> tail(numFrames * 2, 1000);
+    const std::vector<int16_t> head(numFrames * 2, -1000);
+    std::vector<int16_t> seam(tail.size());
+    getPcmKernels<int16_t>(2).crossfade(tail.data(), head.data(), seam.data(), 0, numFrames,
+                                        numFrames, 2);
+
+    // fadeOut = (3 - frame) / 4, fadeIn = frame / 4
+    const std::vector<int16_t> expected = {750, 750, 250, 250, -250, -250, -750, -750};
+    EXPECT_EQ(seam, expected);
+}
+
+TEST(PcmPipelineTester, FromFloat_OutOfRange_Saturates) {
+    const std::vector<float> input = {-2.0f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 2.0f};
+    std::vector<int16_t> output(input.size());
+    getPcmKernels<int16_t>(1).fromFloat(input.data(), output.data(), input.size(), 1);
+
+    const std::vector<int16_t> expected = {std::numeric_limits<int16_t>::min(),
+                                           std::numeric_limits<int16_t>::min(),
+                                           -16384,
+                                           0,
+                                           16384,
+                                           std::numeric_limits<int16_t>::max(),
+                                           std::numeric_limits<int16_t>::max()};
+    EXPECT_EQ(output, expected);
+
+    std::vector<int16_t> loud = {20000, -20000, 100};
+    getPcmKernels<int16_t>(3).applyGain(loud.data(), 1, 3, 2.0f);
+    EXPECT_EQ(loud, (std::vector<int16_t>{std::numeric_limits<int16_t>::max(),
+                                          std::numeric_limits<int16_t>::min(), 200}));
+}
+
+TEST(PcmPipelineTester, ToFloat_Int16_RoundTripsExactly) {
+    std::vector<int16_t> input;
+    for (int value = std::numeric_limits<int16_t>::min();
+         value <= std::numeric_limits<int16_t>::max(); ++value) {
+        input.push_back(static_cast<int16_t>(value));
+    }
+    std::vector<float> floats(input.size());
+    std::vector<int16_t> output(input.size());
+    const PcmKernels<int16_t> kernels = getPcmKernels<int16_t>(2);
+    kernels.toFloat(input.data(), floats.data(), input.size() / 2, 2);
+    kernels.fromFloat(floats.data(), output.data(), input.size() / 2, 2);
+
+    EXPECT_EQ(output, input);
+    EXPECT_EQ(floats.front(), -1.0f);
+}
+
+}  // namespace MediaProcessor::Tests
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <numbers>
+#include <vector>
+
+#include "../src/DeepFilterStream.h"
+#include "../src/Metrics.h"
+#include "../src/PcmStreamClient.h"
+#include "../src/PcmStreamServer.h"
+#include "../src/SharedPcmRing.h"
+
+namespace fs = std::filesystem;
+namespace MediaProcessor::Tests {
+
+namespace {
+
+const fs::path modelPath = fs::path(TEST_MEDIA_DIR).parent_path().parent_path() /
+                           "res/DeepFilterNet3_ll_onnx.tar.gz";
+
+fs::path getSocketPath() {
+    return fs::temp_directory_path() / ("pcm_stream_test_" + std::to_string(getpid()) + ".sock");
+}
+
+std::vector<float> makeSignal(size_t numSamples) {
+    std::vector<float> signal(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        double t = i / DEEPFILTER_SAMPLE_RATE;
+        signal[i] = static_cast<float>(0.3 * std::sin(2.0 * std::numbers::pi * 220.0 * t) +
+                                       0.1 * std::sin(2.0 * std::numbers::pi * 3100.0 * t));
+    }
+    return signal;
+}
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(PcmStreamTester, SharedPcmRing_AttachedPeer_SeesFramesAcrossTheWrap) {
+    auto producer = SharedPcmRing::create(5, 2, 48000);
+    ASSERT_TRUE(producer);
+    auto consumer = SharedPcmRing::attach(dup(producer->getMemoryFd()),
+                                          dup(producer->getDataEventFd()),
+                                          dup(producer->getSpaceEventFd()));
+    ASSERT_TRUE(consumer);
+    EXPECT_EQ(consumer->getCapacityFrames(), 5u);
+    EXPECT_EQ(consumer->getChannels(), 2u);
+
+    float next = 0.0f, expected = 0.0f;
+    for (int round = 0; round < 4; ++round) {
+        // 3 frames per round, so the ring wraps and regions end at the buffer's end
+        size_t written = 0;
+        while (written < 3) {
+            std::span<float> region = producer->acquireWrite(3 - written);
+            ASSERT_FALSE(region.empty());
+            for (float& sample : region) {
+                sample = next++;
+            }
+            producer->commitWrite(region.size() / 2);
+            written += region.size() / 2;
+        }
+        EXPECT_LE(producer->acquireWrite().size(), (5u - 3u) * 2);  // wraps at the end
+
+        ASSERT_TRUE(consumer->waitReadable(1000));
+        size_t read = 0;
+        while (read < 3) {
+            std::span<const float> region = consumer->acquireRead();
+            ASSERT_FALSE(region.empty());
+            for (float sample : region) {
+                ASSERT_EQ(sample, expected++);
+            }
+            consumer->commitRead(region.size() / 2);
+            read += region.size() / 2;
+        }
+    }
+
+    EXPECT_FALSE(consumer->waitReadable(0));
+    producer->close();
+    EXPECT_TRUE(consumer->waitReadable(0));
+    EXPECT_TRUE(consumer->isClosed());
+    EXPECT_TRUE(consumer->acquireRead().empty());
+}
+
+TEST(PcmStreamTester, SharedPcmRing_AttachForgedCapacity_Fails) {
+    auto ring = SharedPcmRing::create(5, 2, 48000);
+    ASSERT_TRUE(ring);
+    void* mapping =
+        mmap(nullptr, sizeof(SharedPcmRingHeader), PROT_READ | PROT_WRITE, MAP_SHARED,
+             ring->getMemoryFd(), 0);
+    ASSERT_NE(mapping, MAP_FAILED);
+    auto* header = static_cast<SharedPcmRingHeader*>(mapping);
+
+    // 2^61 frames of 2 floats wrap the size to 0 bytes, which would fit any mapping
+    header->capacityFrames = uint64_t(1) << 61;
+    EXPECT_FALSE(SharedPcmRing::attach(dup(ring->getMemoryFd()), dup(ring->getDataEventFd()),
+                                       dup(ring->getSpaceEventFd())));
+
+    header->capacityFrames = 6;  // one frame more than the memory holds
+    EXPECT_FALSE(SharedPcmRing::attach(dup(ring->getMemoryFd()), dup(ring->getDataEventFd()),
+                                       dup(ring->getSpaceEventFd())));
+    munmap(mapping, sizeof(SharedPcmRingHeader));
+}
+
+TEST(PcmStreamTester, Filter_BufferLongerThanRings_MatchesAlignedStream) {
+    const fs::path socketPath = getSocketPath();
+    PcmStreamServer server(socketPath, modelPath, 1, 1000);
+    ASSERT_TRUE(server.start());
+
+    PcmStreamClient client;
+    ASSERT_TRUE(client.open(socketPath, 100.0f));
+    const size_t latency = client.getLatency();
+    ASSERT_GT(latency, 0u);
+
+    // Not a multiple of the hop, so the flush at the end is partial
+    const std::vector<float> input = makeSignal(latency * 25 + latency / 3);
+    std::vector<float> output(input.size());
+    ASSERT_TRUE(client.filter(input.data(), output.data(), input.size(), 10000));
+
+    DeepFilterStream reference(modelPath, 100.0f);
+    std::vector<float> padded = input;
+    padded.resize(input.size() + latency, 0.0f);
+    std::vector<float> expected(padded.size());
+    reference.process(padded.data(), expected.data(), padded.size());
+    expected.erase(expected.begin(), expected.begin() + latency);
+    EXPECT_EQ(output, expected);
+}
+
+TEST(PcmStreamTester, Open_InvalidRequestOrMissingServer_Fails) {
+    const fs::path socketPath = getSocketPath();
+    PcmStreamClient noServer;
+    EXPECT_FALSE(noServer.open(socketPath, 100.0f));
+
+    PcmStreamServer server(socketPath, modelPath, 1, 1000);
+    ASSERT_TRUE(server.start());
+    PcmStreamClient outOfRange;
+    EXPECT_FALSE(outOfRange.open(socketPath, 150.0f));
+
+    PcmStreamClient valid;
+    EXPECT_TRUE(valid.open(socketPath, 100.0f));
+}
+
+TEST(PcmStreamTester, Open_AllSessionsTaken_IsRefusedAsBusy) {
+    const fs::path socketPath = getSocketPath();
+    PcmStreamServer server(socketPath, modelPath, 1, 1000);
+    ASSERT_TRUE(server.start());
+
+    PcmStreamClient first;
+    ASSERT_TRUE(first.open(socketPath, 100.0f));
+    EXPECT_EQ(Metrics::getInstance().pcmStreamSessions.get(), 1);
+
+    // Refused right away instead of waiting for the first session to end
+    const uint64_t rejected = Metrics::getInstance().pcmStreamRejected.get();
+    PcmStreamClient second;
+    testing::internal::CaptureStderr();
+    EXPECT_FALSE(second.open(socketPath, 100.0f, 5000));
+    EXPECT_NE(testing::internal::GetCapturedStderr().find(PCM_STREAM_BUSY), std::string::npos);
+    EXPECT_EQ(Metrics::getInstance().pcmStreamRejected.get(), rejected + 1);
+}
+
+TEST(PcmStreamTester, Open_ServerNeverAnswers_TimesOut) {
+    // A bare listening socket accepts the connection but never replies
+    const fs::path socketPath = getSocketPath();
+    int listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, socketPath.c_str());
+    fs::remove(socketPath);
+    ASSERT_EQ(bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(listen(listenFd, 1), 0);
+
+    auto start = std::chrono::steady_clock::now();
+    PcmStreamClient client;
+    EXPECT_FALSE(client.open(socketPath, 100.0f, 200));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+
+    close(listenFd);
+    fs::remove(socketPath);
+}
+
+}  // namespace MediaProcessor::Tests
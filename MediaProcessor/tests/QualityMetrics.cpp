@@ -0,0 +1,196 @@
+#include "QualityMetrics.h"
+
+#include <sndfile.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <numeric>
+#include <stdexcept>
+
+namespace MediaProcessor::QualityMetrics {
+
+namespace {
+
+constexpr double POWER_FLOOR = 1e-10;  // keeps log spectra of silent bins finite
+constexpr double ENERGY_FLOOR = 1e-12;
+constexpr double STEP_FLOOR = 1e-3;  // steps below ~-60 dBFS are not audible as clicks
+
+/**
+ * @brief In-place iterative radix-2 FFT; `bins.size()` must be a power of two.
+ */
+void fft(std::vector<std::complex<double>>& bins) {
+    const size_t n = bins.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(bins[i], bins[j]);
+        }
+    }
+
+    for (size_t length = 2; length <= n; length <<= 1) {
+        const double angle = -2.0 * std::numbers::pi / length;
+        const std::complex<double> step(std::cos(angle), std::sin(angle));
+        for (size_t start = 0; start < n; start += length) {
+            std::complex<double> twiddle(1.0);
+            for (size_t k = 0; k < length / 2; ++k) {
+                std::complex<double> even = bins[start + k];
+                std::complex<double> odd = bins[start + k + length / 2] * twiddle;
+                bins[start + k] = even + odd;
+                bins[start + k + length / 2] = even - odd;
+                twiddle *= step;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Log power spectrum (dB) of the Hann-windowed frame starting at `offset`.
+ */
+std::vector<double> computeLogSpectrum(const std::vector<float>& samples, size_t offset,
+                                       size_t frameSize) {
+    std::vector<std::complex<double>> bins(frameSize);
+    for (size_t i = 0; i < frameSize; ++i) {
+        double window = 0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * i / frameSize);
+        bins[i] = samples[offset + i] * window;
+    }
+    fft(bins);
+
+    std::vector<double> spectrum(frameSize / 2 + 1);
+    for (size_t i = 0; i < spectrum.size(); ++i) {
+        spectrum[i] = 10.0 * std::log10(std::norm(bins[i]) + POWER_FLOOR);
+    }
+    return spectrum;
+}
+
+double getMaxStep(const std::vector<float>& samples, size_t first, size_t last) {
+    double maxStep = 0.0;
+    for (size_t i = first + 1; i < last; ++i) {
+        maxStep = std::max(maxStep, double(std::fabs(samples[i] - samples[i - 1])));
+    }
+    return maxStep;
+}
+
+}  // namespace
+
+Signal loadMono(const fs::path& path) {
+    SF_INFO sfInfo{};
+    SNDFILE* file = sf_open(path.c_str(), SFM_READ, &sfInfo);
+    if (!file) {
+        throw std::runtime_error("Failed to open audio file: " + path.string());
+    }
+
+    std::vector<float> interleaved(sfInfo.frames * sfInfo.channels);
+    sf_count_t framesRead = sf_readf_float(file, interleaved.data(), sfInfo.frames);
+    sf_close(file);
+
+    Signal signal;
+    signal.sampleRate = sfInfo.samplerate;
+    signal.samples.resize(framesRead);
+    for (sf_count_t frame = 0; frame < framesRead; ++frame) {
+        float sum = 0.0f;
+        for (int c = 0; c < sfInfo.channels; ++c) {
+            sum += interleaved[frame * sfInfo.channels + c];
+        }
+        signal.samples[frame] = sum / sfInfo.channels;
+    }
+    return signal;
+}
+
+double computeSiSdr(const std::vector<float>& estimate, const std::vector<float>& reference) {
+    const size_t length = std::min(estimate.size(), reference.size());
+    if (length == 0) {
+        return 0.0;
+    }
+    const double estimateMean =
+        std::accumulate(estimate.begin(), estimate.begin() + length, 0.0) / length;
+    const double referenceMean =
+        std::accumulate(reference.begin(), reference.begin() + length, 0.0) / length;
+
+    double dot = 0.0, referenceEnergy = 0.0;
+    for (size_t i = 0; i < length; ++i) {
+        dot += (estimate[i] - estimateMean) * (reference[i] - referenceMean);
+        referenceEnergy += (reference[i] - referenceMean) * (reference[i] - referenceMean);
+    }
+    if (referenceEnergy < ENERGY_FLOOR) {
+        return 0.0;
+    }
+
+    // Project the estimate onto the reference; what is left over is distortion
+    const double scale = dot / referenceEnergy;
+    double targetEnergy = 0.0, distortionEnergy = 0.0;
+    for (size_t i = 0; i < length; ++i) {
+        double target = scale * (reference[i] - referenceMean);
+        double distortion = (estimate[i] - estimateMean) - target;
+        targetEnergy += target * target;
+        distortionEnergy += distortion * distortion;
+    }
+    if (distortionEnergy < ENERGY_FLOOR) {
+        return MAX_SI_SDR_DB;
+    }
+    return std::min(10.0 * std::log10(targetEnergy / distortionEnergy), MAX_SI_SDR_DB);
+}
+
+double computeLogSpectralDistance(const std::vector<float>& estimate,
+                                  const std::vector<float>& reference, size_t frameSize) {
+    const size_t length = std::min(estimate.size(), reference.size());
+    if (length < frameSize) {
+        return 0.0;
+    }
+
+    double totalDistance = 0.0;
+    size_t numFrames = 0;
+    for (size_t offset = 0; offset + frameSize <= length; offset += frameSize / 2) {
+        std::vector<double> estimateSpectrum = computeLogSpectrum(estimate, offset, frameSize);
+        std::vector<double> referenceSpectrum = computeLogSpectrum(reference, offset, frameSize);
+        double squaredSum = 0.0;
+        for (size_t i = 0; i < estimateSpectrum.size(); ++i) {
+            double difference = estimateSpectrum[i] - referenceSpectrum[i];
+            squaredSum += difference * difference;
+        }
+        totalDistance += std::sqrt(squaredSum / estimateSpectrum.size());
+        ++numFrames;
+    }
+    return totalDistance / numFrames;
+}
+
+std::vector<SeamReport> analyzeSeams(const Signal& estimate, const Signal& reference,
+                                     const std::vector<double>& seamTimes, double windowSeconds) {
+    const size_t length = std::min(estimate.samples.size(), reference.samples.size());
+    auto errorEnergy = [&](size_t first, size_t last) {
+        double energy = 0.0;
+        for (size_t i = first; i < last; ++i) {
+            double error = estimate.samples[i] - reference.samples[i];
+            energy += error * error;
+        }
+        return energy / std::max<size_t>(last - first, 1);
+    };
+    const double averageError = errorEnergy(0, length);
+
+    std::vector<SeamReport> reports;
+    const auto window = static_cast<size_t>(windowSeconds * reference.sampleRate);
+    for (double seamTime : seamTimes) {
+        const auto seam = static_cast<size_t>(seamTime * reference.sampleRate);
+        const size_t first = seam > window ? seam - window : 0;
+        const size_t last = std::min(seam + window, length);
+        if (first >= last) {
+            continue;
+        }
+
+        SeamReport report;
+        report.timeSeconds = seamTime;
+        report.localErrorDb = 10.0 * std::log10((errorEnergy(first, last) + ENERGY_FLOOR) /
+                                                (averageError + ENERGY_FLOOR));
+        report.jumpRatio = getMaxStep(estimate.samples, first, last) /
+                           std::max(getMaxStep(reference.samples, first, last), STEP_FLOOR);
+        reports.push_back(report);
+    }
+    return reports;
+}
+
+}  // namespace MediaProcessor::QualityMetrics
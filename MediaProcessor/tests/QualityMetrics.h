@@ -0,0 +1,66 @@
+#ifndef QUALITYMETRICS_H
+#define QUALITYMETRICS_H
+
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+namespace MediaProcessor::QualityMetrics {
+
+constexpr double MAX_SI_SDR_DB = 100.0;  // reported for (near) identical signals
+constexpr size_t DEFAULT_SPECTRUM_FRAME_SIZE = 1024;
+
+/**
+ * @brief A mono signal and its sample rate.
+ */
+struct Signal {
+    std::vector<float> samples;
+    int sampleRate = 0;
+};
+
+/**
+ * @brief How far the output deviates from the reference around one chunk seam.
+ */
+struct SeamReport {
+    double timeSeconds;
+    double localErrorDb;  // error energy near the seam relative to the whole clip's average
+    double jumpRatio;     // largest sample-to-sample step near the seam relative to the reference's
+};
+
+/**
+ * @brief Reads an audio file, averaging its channels.
+ *
+ * @throws std::runtime_error if the file cannot be read.
+ */
+Signal loadMono(const fs::path& path);
+
+/**
+ * @brief Scale-invariant signal-to-distortion ratio of `estimate` against `reference`, in dB.
+ *
+ * Both signals are compared over their common length after removing their means. Capped at
+ * MAX_SI_SDR_DB.
+ */
+double computeSiSdr(const std::vector<float>& estimate, const std::vector<float>& reference);
+
+/**
+ * @brief Log-spectral distance between the two signals, in dB.
+ *
+ * The RMS difference of the Hann-windowed log power spectra of `frameSize` samples (a power
+ * of two) at half-frame hops, averaged over all frames.
+ */
+double computeLogSpectralDistance(const std::vector<float>& estimate,
+                                  const std::vector<float>& reference,
+                                  size_t frameSize = DEFAULT_SPECTRUM_FRAME_SIZE);
+
+/**
+ * @brief Measures the error around every chunk seam of a chunked output.
+ *
+ * @param seamTimes Where neighbouring chunks were stitched, in seconds.
+ * @param windowSeconds Half-width of the window examined around each seam.
+ */
+std::vector<SeamReport> analyzeSeams(const Signal& estimate, const Signal& reference,
+                                     const std::vector<double>& seamTimes, double windowSeconds);
+
+}  // namespace MediaProcessor::QualityMetrics
+
+#endif  // QUALITYMETRICS_H
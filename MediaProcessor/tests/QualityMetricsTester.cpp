@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "QualityMetrics.h"
+
+namespace MediaProcessor::Tests {
+
+using namespace QualityMetrics;
+
+namespace {
+
+constexpr int TEST_SAMPLE_RATE = 16000;
+
+Signal makeTone(double frequency, double seconds) {
+    Signal signal;
+    signal.sampleRate = TEST_SAMPLE_RATE;
+    signal.samples.resize(static_cast<size_t>(seconds * TEST_SAMPLE_RATE));
+    for (size_t i = 0; i < signal.samples.size(); ++i) {
+        signal.samples[i] =
+            0.5f * std::sin(2.0 * std::numbers::pi * frequency * i / TEST_SAMPLE_RATE);
+    }
+    return signal;
+}
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(QualityMetricsTester, ComputeSiSdr_ScaledAndNoisyCopies_MatchesInjectedSnr) {
+    Signal reference = makeTone(440.0, 1.0);
+
+    std::vector<float> scaled = reference.samples;
+    for (float& sample : scaled) {
+        sample *= 0.25f;
+    }
+    EXPECT_DOUBLE_EQ(computeSiSdr(scaled, reference.samples), MAX_SI_SDR_DB);
+
+    // White noise 20 dB below the tone
+    std::mt19937 generator(7);
+    std::normal_distribution<float> noise(0.0f, 0.5f / std::sqrt(2.0f) / 10.0f);
+    std::vector<float> noisy = reference.samples;
+    for (float& sample : noisy) {
+        sample += noise(generator);
+    }
+    EXPECT_NEAR(computeSiSdr(noisy, reference.samples), 20.0, 0.5);
+}
+
+TEST(QualityMetricsTester, ComputeLogSpectralDistance_DifferentTone_IsLarge) {
+    Signal reference = makeTone(440.0, 1.0);
+    EXPECT_DOUBLE_EQ(computeLogSpectralDistance(reference.samples, reference.samples), 0.0);
+
+    Signal other = makeTone(3000.0, 1.0);
+    EXPECT_GT(computeLogSpectralDistance(other.samples, reference.samples), 10.0);
+}
+
+TEST(QualityMetricsTester, AnalyzeSeams_ClickAtSeam_IsFlagged) {
+    Signal reference = makeTone(440.0, 1.0);
+    Signal estimate = reference;
+    estimate.samples[TEST_SAMPLE_RATE / 2] += 0.8f;
+
+    std::vector<SeamReport> reports = analyzeSeams(estimate, reference, {0.25, 0.5}, 0.01);
+    ASSERT_EQ(reports.size(), 2u);
+    EXPECT_LT(reports[0].localErrorDb, -50.0);
+    EXPECT_NEAR(reports[0].jumpRatio, 1.0, 1e-6);
+    EXPECT_GT(reports[1].localErrorDb, 10.0);
+    EXPECT_GT(reports[1].jumpRatio, 2.0);
+}
+
+}  // namespace MediaProcessor::Tests
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+#include "../src/ConfigManager.h"
+#include "../src/RenditionEncoder.h"
+#include "TestUtils.h"
+
+namespace fs = std::filesystem;
+namespace MediaProcessor::Tests {
+
+class RenditionEncoderTester : public ::testing::Test {
+   protected:
+    TestUtils::TestConfigFile testConfigFile;
+    ConfigManager& configManager;
+
+    RenditionEncoderTester() : configManager(ConfigManager::getInstance()) {}
+
+    void SetUp() override {
+        nlohmann::json jsonObject = {
+            {"ffmpeg_path", "/usr/bin/ffmpeg"},
+            {"deep_filter_path", "MediaProcessor/res/deep-filter-0.5.6-x86_64-unknown-linux-musl"},
+            {"downloads_path", "downloads"},
+            {"uploads_path", "uploads"},
+            {"use_thread_cap", true},
+            {"max_threads_if_capped", 4},
+            {"resource_budget", {{"inference_workers", 2}, {"codec_threads", 2}}},
+            {"renditions",
+             {{{"name", "web"}, {"codec", "aac"}, {"bitrate", "128k"}, {"extension", "m4a"}},
+              {{"name", "asr"},
+               {"codec", "pcm_s16le"},
+               {"sample_rate", 16000},
+               {"channels", 1},
+               {"extension", "wav"}}}}};
+        testConfigFile.generateConfigFile("testConfig.json", jsonObject);
+
+        ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()))
+            << "Failed to load test configuration file.";
+    }
+};
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST_F(RenditionEncoderTester, BuildCommand_TwoRenditions_DecodesOnceAndMapsEachOutput) {
+    RenditionEncoder encoder("/media/song_isolated_audio.wav", configManager.getRenditions());
+
+    const std::string expected =
+        "/usr/bin/ffmpeg -y -threads 2 -i /media/song_isolated_audio.wav "
+        "-map 0:a:0 -c:a aac -b:a 128k -threads 2 /media/song_isolated_audio_web.m4a "
+        "-map 0:a:0 -c:a pcm_s16le -ar 16000 -ac 1 -threads 2 "
+        "/media/song_isolated_audio_asr.wav";
+    EXPECT_EQ(encoder.buildCommand(), expected);
+}
+
+TEST_F(RenditionEncoderTester, Encode_NoRenditions_SucceedsWithoutRunningFFmpeg) {
+    RenditionEncoder encoder("/nonexistent/song_isolated_audio.wav", {});
+
+    EXPECT_TRUE(encoder.getOutputPaths().empty());
+    EXPECT_TRUE(encoder.encode());
+}
+
+}  // namespace MediaProcessor::Tests
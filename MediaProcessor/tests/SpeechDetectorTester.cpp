@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <vector>
+
+#include "../src/SpeechDetector.h"
+
+namespace MediaProcessor::Tests {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr unsigned int TEST_SAMPLE_RATE = 48000;
+constexpr size_t TEST_FRAME_SIZE = 480;  // 10 ms
+
+void addFrames(SpeechDetector& detector, double seconds, float lsnr, float amplitude) {
+    std::vector<float> frame(TEST_FRAME_SIZE, amplitude);
+    const int numFrames = static_cast<int>(seconds * TEST_SAMPLE_RATE / TEST_FRAME_SIZE + 0.5);
+    for (int i = 0; i < numFrames; ++i) {
+        detector.addFrame(lsnr, frame.data(), frame.size());
+    }
+}
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(SpeechDetectorTester, Finish_ShortPauseAndBurst_BridgesPauseAndDropsBurst) {
+    SpeechSegmentConfig config;
+    config.enabled = true;
+    SpeechDetector detector(TEST_SAMPLE_RATE, config);
+
+    addFrames(detector, 0.5, -10.0f, 0.0f);  // silence
+    addFrames(detector, 1.0, 20.0f, 0.1f);   // speech
+    addFrames(detector, 0.1, -5.0f, 0.1f);   // breath, shorter than min_gap_seconds
+    addFrames(detector, 0.5, 20.0f, 0.1f);   // speech
+    addFrames(detector, 1.0, 20.0f, 0.0f);   // confident but silent
+    addFrames(detector, 0.1, 20.0f, 0.1f);   // burst, shorter than min_speech_seconds
+    addFrames(detector, 0.5, -10.0f, 0.0f);
+
+    std::vector<SpeechSegment> segments = detector.finish();
+    ASSERT_EQ(segments.size(), 1u);
+    EXPECT_NEAR(segments[0].start, 0.5, 1e-9);
+    EXPECT_NEAR(segments[0].end, 2.1, 1e-9);
+    EXPECT_GT(segments[0].confidence, 0.5);
+    EXPECT_LT(segments[0].confidence, 1.0);
+}
+
+TEST(SpeechDetectorTester, MergeChunks_OverlappingSeam_JoinsIntoOneSegment) {
+    std::vector<std::vector<SpeechSegment>> chunkSegments = {
+        {{0.0, 1.0, 0.8}, {9.0, 10.5, 1.0}},
+        {{0.0, 2.0, 0.5}},
+    };
+
+    std::vector<SpeechSegment> segments =
+        SpeechDetector::mergeChunks(chunkSegments, {0.0, 10.0}, 0.3);
+
+    ASSERT_EQ(segments.size(), 2u);
+    EXPECT_DOUBLE_EQ(segments[0].end, 1.0);
+    EXPECT_DOUBLE_EQ(segments[1].start, 9.0);
+    EXPECT_DOUBLE_EQ(segments[1].end, 12.0);
+    EXPECT_NEAR(segments[1].confidence, (1.0 * 1.5 + 0.5 * 2.0) / 3.5, 1e-9);
+}
+
+TEST(SpeechDetectorTester, SaveAndLoad_RoundTripsSegments) {
+    const fs::path sidecarPath = fs::temp_directory_path() / "speech_detector_tester.speech.json";
+    ASSERT_TRUE(SpeechDetector::save(sidecarPath, {{0.5, 2.1, 0.9}}));
+
+    auto segments = SpeechDetector::load(sidecarPath);
+    fs::remove(sidecarPath);
+
+    ASSERT_TRUE(segments.has_value());
+    ASSERT_EQ(segments->size(), 1u);
+    EXPECT_DOUBLE_EQ((*segments)[0].end, 2.1);
+    EXPECT_FALSE(SpeechDetector::load(sidecarPath).has_value());
+}
+
+}  // namespace MediaProcessor::Tests
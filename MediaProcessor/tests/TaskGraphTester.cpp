@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/TaskGraph.h"
+
+namespace MediaProcessor::Tests {
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(TaskGraphTester, Run_DiamondGraph_RunsNodesAfterTheirPredecessors) {
+    ThreadPool pool(4);
+    TaskGraph graph(pool);
+
+    std::mutex orderMutex;
+    std::vector<std::string> order;
+    auto record = [&](std::string name) {
+        return [&, name]() {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(name);
+            return true;
+        };
+    };
+
+    auto split = graph.addNode("split", record("split"));
+    auto left = graph.addNode("left", record("left"));
+    auto right = graph.addNode("right", record("right"));
+    auto join = graph.addNode("join", record("join"));
+    graph.addEdge(split, left);
+    graph.addEdge(split, right);
+    graph.addEdge(left, join);
+    graph.addEdge(right, join);
+
+    EXPECT_TRUE(syncWait(graph.run()));
+
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_EQ(order.front(), "split");
+    EXPECT_EQ(order.back(), "join");
+}
+
+TEST(TaskGraphTester, Run_NodeFails_SkipsOnlyItsDependents) {
+    ThreadPool pool(2);
+    TaskGraph graph(pool);
+
+    std::atomic<bool> dependentRan{false};
+    auto failing = graph.addNode("failing", []() { return false; });
+    auto dependent = graph.addNode("dependent", [&]() {
+        dependentRan = true;
+        return true;
+    });
+    auto independent = graph.addNode("independent", []() { return true; });
+    auto throwing = graph.addNode("throwing", []() -> bool { throw std::runtime_error("boom"); });
+    graph.addEdge(failing, dependent);
+
+    EXPECT_FALSE(syncWait(graph.run()));
+
+    EXPECT_FALSE(dependentRan);
+    EXPECT_EQ(graph.getNodeState(failing), TaskGraph::NodeState::Failed);
+    EXPECT_EQ(graph.getNodeState(dependent), TaskGraph::NodeState::Skipped);
+    EXPECT_EQ(graph.getNodeState(independent), TaskGraph::NodeState::Succeeded);
+    EXPECT_EQ(graph.getNodeState(throwing), TaskGraph::NodeState::Failed);
+}
+
+TEST(TaskGraphTester, Run_Cycle_Throws) {
+    ThreadPool pool(1);
+    TaskGraph graph(pool);
+
+    auto first = graph.addNode("first", []() { return true; });
+    auto second = graph.addNode("second", []() { return true; });
+    graph.addEdge(first, second);
+    graph.addEdge(second, first);
+
+    EXPECT_THROW(syncWait(graph.run()), std::logic_error);
+}
+
+TEST(TaskGraphTester, ParallelFor_VisitsEverySampleOnce) {
+    ThreadPool pool(4);
+    std::vector<int> visits(10007, 0);
+
+    syncWait(parallelFor(pool, 0, visits.size(), 1000, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            visits[i]++;
+        }
+    }));
+
+    EXPECT_EQ(std::accumulate(visits.begin(), visits.end(), 0), static_cast<int>(visits.size()));
+    EXPECT_EQ(*std::max_element(visits.begin(), visits.end()), 1);
+}
+
+}  // namespace MediaProcessor::Tests
@@ -1,14 +1,74 @@
 #include "TestUtils.h"
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
 #include <sndfile.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
+#include "../src/CommandExecutor.h"
+
 namespace MediaProcessor::TestUtils {
 
+nlohmann::json getCommandCassetteConfig() {
+    const fs::path testMediaPath = TEST_MEDIA_DIR;
+    const fs::path cassettePath = testMediaPath / "cassette";
+
+    const std::string mode = TEST_COMMAND_CASSETTE;
+    if (mode == "replay" && !fs::exists(cassettePath / CASSETTE_INDEX_FILENAME)) {
+        throw std::runtime_error("TEST_COMMAND_CASSETTE is replay, but no cassette is recorded at " +
+                                 cassettePath.string() +
+                                 "; record it or configure with -DTEST_COMMAND_CASSETTE=off");
+    }
+    return {{"mode", mode},
+            {"path", cassettePath.string()},
+            {"root", testMediaPath.parent_path().parent_path().string()}};
+}
+
+fs::path getTestOutputDir() {
+    return fs::path(TEST_MEDIA_DIR).parent_path() / "test_output";
+}
+
+std::string requestLocalhost(uint16_t port, const std::string& request) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        close(fd);
+        return "";
+    }
+
+    size_t sent = 0;
+    while (sent < request.size()) {
+        ssize_t result = send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (result <= 0) {
+            break;
+        }
+        sent += result;
+    }
+    std::string response;
+    char buffer[4096];
+    ssize_t bytesRead;
+    while ((bytesRead = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, bytesRead);
+    }
+    close(fd);
+    return response;
+}
+
+std::string getBody(const std::string& response) {
+    size_t headerEnd = response.find("\r\n\r\n");
+    return headerEnd == std::string::npos ? "" : response.substr(headerEnd + 4);
+}
+
 void TestConfigFile::writeJsonToFile(const fs::path& path, const nlohmann::json& jsonObject) const {
     std::ofstream file(m_filePath);
     if (!file.is_open()) {
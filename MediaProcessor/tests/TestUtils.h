@@ -1,15 +1,41 @@
 #ifndef TESTUTILS_H
 #define TESTUTILS_H
 
+#include <cstdint>
 #include <filesystem>
 #include <nlohmann/json.hpp>
 #include <stdexcept>
+#include <string>
+
+#include "../src/ICommandExecutor.h"
 
 namespace fs = std::filesystem;
 namespace MediaProcessor::TestUtils {
 
 constexpr const char* DEFAULT_TEST_CONFIG_FILE_PATH = "testConfig.json";
 
+#ifndef TEST_COMMAND_CASSETTE
+#define TEST_COMMAND_CASSETTE "off"
+#endif
+
+/**
+ * @brief Gets the `command_cassette` option the processor tests run FFmpeg and FFprobe with.
+ *
+ * The mode is TEST_COMMAND_CASSETTE and the cassette is `TestMedia/cassette`.
+ *
+ * @throws std::runtime_error If the mode is "replay" but that cassette is not recorded, so the
+ *         tests fail instead of quietly running FFmpeg.
+ */
+nlohmann::json getCommandCassetteConfig();
+
+/**
+ * @brief Gets the directory the processor tests write their outputs to.
+ *
+ * Fixed below the cassette's root rather than the working directory, since the recorded
+ * commands name the outputs and only replay if every build writes them to the same place.
+ */
+fs::path getTestOutputDir();
+
 /**
  * @brief Generate a test configuration file.
  */
@@ -88,7 +114,9 @@ class TestConfigFile {
         {"uploads_path", "uploads"},
         {"use_thread_cap", false},
         {"max_threads_if_capped", 6},
-        {"filter_attenuation_limit", 100.0f}};
+        {"filter_attenuation_limit", 100.0f},
+        {"chunk_max_attempts", 3},
+        {"command_cassette", getCommandCassetteConfig()}};
 };
 
 /**
@@ -132,6 +160,36 @@ class CompareFiles {
                                             double relativeTolerance = 1.0);
 };
 
+/**
+ * @brief Probes inputs as a minute of mono audio, unless their name says "broken", and fails
+ *        every other command, so jobs are admitted and then fail without FFmpeg.
+ */
+class ProbeOnlyExecutor : public ICommandExecutor {
+   public:
+    Task<CommandOutcome> execute(std::string command, bool, CancellationToken) override {
+        CommandOutcome outcome;
+        outcome.launched = true;
+        outcome.returnCode = 1;
+        if (command.starts_with("ffprobe") && command.find("broken") == std::string::npos) {
+            outcome.returnCode = 0;
+            outcome.output =
+                R"({"streams": [{"codec_type": "audio", "channels": 1}],)"
+                R"( "format": {"duration": "60.0"}})";
+        }
+        co_return outcome;
+    }
+};
+
+/**
+ * @brief Sends `request` to 127.0.0.1:`port` and returns the whole response.
+ */
+std::string requestLocalhost(uint16_t port, const std::string& request);
+
+/**
+ * @brief Gets the body of an HTTP response, or an empty string if it has none.
+ */
+std::string getBody(const std::string& response);
+
 }  // namespace MediaProcessor::TestUtils
 
 #endif  // TESTUTILS_H
\ No newline at end of file
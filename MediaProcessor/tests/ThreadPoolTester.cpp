@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <latch>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace MediaProcessor::Tests {
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST(ThreadPoolTester, MoveOnlyTask_SmallAndLargeCallables_InvokeAfterMove) {
+    int calls = 0;
+    std::array<char, 2 * MoveOnlyTask::INLINE_CAPACITY> padding{};
+    auto small = [&calls]() { calls++; };
+    auto large = [&calls, padding]() { calls += 1 + padding[0]; };
+    static_assert(MoveOnlyTask::storedInline<decltype(small)>());
+    static_assert(!MoveOnlyTask::storedInline<decltype(large)>());
+
+    MoveOnlyTask first(small);
+    MoveOnlyTask second(large);
+    MoveOnlyTask moved = std::move(first);
+    second = std::move(moved);
+
+    EXPECT_FALSE(first);
+    EXPECT_FALSE(moved);
+    second();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(ThreadPoolTester, MoveOnlyTask_Destroyed_ReleasesCapturedState) {
+    auto resource = std::make_shared<int>(0);
+    {
+        MoveOnlyTask task([resource]() {});
+        EXPECT_EQ(resource.use_count(), 2);
+    }
+    EXPECT_EQ(resource.use_count(), 1);
+}
+
+TEST(ThreadPoolTester, Enqueue_MoveOnlyArgument_ReturnsResult) {
+    ThreadPool pool(2);
+
+    auto result = pool.enqueue([](const std::unique_ptr<int>& value) { return *value * 2; },
+                               std::make_unique<int>(21));
+
+    EXPECT_EQ(result.get(), 42);
+}
+
+TEST(ThreadPoolTester, Post_WithLatch_RunsEveryTask) {
+    ThreadPool pool(4);
+    std::atomic<int> counter{0};
+    std::latch done(1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        pool.post([&counter]() { counter++; }, done);
+    }
+    done.wait();
+
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(ThreadPoolTester, PostBulk_RunsEachIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(257);
+    std::latch done(visits.size());
+
+    auto body = [&visits](size_t index) { visits[index]++; };
+    pool.postBulk(visits.size(), body, done);
+    done.wait();
+
+    for (const auto& visit : visits) {
+        EXPECT_EQ(visit.load(), 1);
+    }
+}
+
+TEST(ThreadPoolTester, WorkerHooks_EachWorker_StartsAndStopsOnItsOwnThread) {
+    std::vector<std::atomic<int>> starts(3), stops(3);
+    std::vector<std::optional<size_t>> observedIndices(3);
+    {
+        ThreadPool* poolPointer = nullptr;
+        ThreadPool pool(3, WorkerHooks{[&](size_t index) { starts[index]++; },
+                                       [&](size_t index) {
+                                           observedIndices[index] =
+                                               poolPointer->currentWorkerIndex();
+                                           stops[index]++;
+                                       },
+                                       nullptr});
+        poolPointer = &pool;
+
+        EXPECT_FALSE(pool.currentWorkerIndex().has_value());
+        EXPECT_TRUE(pool.enqueue([&pool]() { return pool.currentWorkerIndex(); }).get());
+    }
+
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(starts[i].load(), 1);
+        EXPECT_EQ(stops[i].load(), 1);
+        EXPECT_EQ(observedIndices[i], i);
+    }
+}
+
+TEST(ThreadPoolTester, Elastic_QueueDepth_GrowsToMaxAndRetiresIdleWorkers) {
+    using namespace std::chrono_literals;
+    std::atomic<int> idleCalls = 0;
+    ThreadPool pool(ElasticLimits{1, 3, 50ms},
+                    WorkerHooks{nullptr, nullptr, [&](size_t) { idleCalls++; }});
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_EQ(pool.maxSize(), 3u);
+
+    // Three blocked tasks need three workers; the fourth waits for one of them
+    std::latch release(1);
+    std::latch done(4);
+    for (int i = 0; i < 4; ++i) {
+        pool.post([&release]() { release.wait(); }, done);
+    }
+    EXPECT_EQ(pool.size(), 3u);
+    release.count_down();
+    done.wait();
+
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while ((pool.size() > 1 || idleCalls.load() == 0) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    PoolStats stats = pool.stats();
+    EXPECT_EQ(stats.threads, 1u);
+    EXPECT_EQ(stats.peak, 3u);
+    EXPECT_EQ(stats.started, 3u);
+    EXPECT_EQ(stats.retired, 2u);
+    EXPECT_GE(idleCalls.load(), 1);  // the remaining worker was told it is idle
+    EXPECT_EQ(pool.sizeHistory().back().threads, 1u);
+
+    // Retired slots are reused
+    EXPECT_TRUE(pool.enqueue([&pool]() { return pool.currentWorkerIndex(); }).get());
+}
+
+TEST(ThreadPoolTester, Elastic_TaskQueuedWhileRetiringWorkerStops_StartsWorkerInItsSlot) {
+    using namespace std::chrono_literals;
+    std::atomic<bool> stopping = false;
+    std::atomic<bool> hooksOverlapped = false;
+    // Stopping takes a while, as freeing a worker's inference state does
+    ThreadPool pool(ElasticLimits{0, 1, 10ms},
+                    WorkerHooks{[&](size_t) { hooksOverlapped = hooksOverlapped || stopping; },
+                                [&](size_t) {
+                                    stopping = true;
+                                    std::this_thread::sleep_for(100ms);
+                                    stopping = false;
+                                }});
+
+    pool.enqueue([]() {}).get();
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!stopping && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_TRUE(stopping.load());
+
+    auto task = pool.enqueue([]() {});
+    EXPECT_EQ(task.wait_for(2s), std::future_status::ready);
+    EXPECT_FALSE(hooksOverlapped.load());  // the new worker started after the old one stopped
+    EXPECT_EQ(pool.stats().started, 2u);
+}
+
+TEST(ThreadPoolTester, IdleStrategy_PollingWorkers_RunEveryTaskAndShutDown) {
+    using namespace std::chrono_literals;
+    ThreadPool pool(ElasticLimits{2, 2}, {}, IdleStrategy{200us, 1ms});
+
+    // Spaced so the worker is polling, yielding or parked when the next task arrives
+    std::atomic<int> ran = 0;
+    for (std::chrono::microseconds gap : {0us, 50us, 500us, 5000us}) {
+        for (int i = 0; i < 20; ++i) {
+            std::this_thread::sleep_for(gap);
+            pool.post([&ran]() { ran++; });
+        }
+    }
+    std::latch done(1);
+    pool.post([]() {}, done);
+    done.wait();
+
+    EXPECT_EQ(ran.load(), 80);
+}
+
+TEST(ThreadPoolTester, IdleStrategy_BurstWhileOneWorkerPollsAndOneParks_StartsBothTasks) {
+    using namespace std::chrono_literals;
+    ThreadPool pool(ElasticLimits{2, 2}, {}, IdleStrategy{0us, 500ms});
+
+    // Both workers poll out their yield time and park, then the one woken here polls again
+    std::this_thread::sleep_for(700ms);
+    pool.enqueue([]() {}).get();
+
+    // Each task only returns true if the other one started while it was running
+    std::atomic<int> started = 0;
+    auto task = [&started]() {
+        started++;
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (started.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        return started.load() == 2;
+    };
+    auto first = pool.enqueue(task);
+    auto second = pool.enqueue(task);
+
+    EXPECT_TRUE(first.get());
+    EXPECT_TRUE(second.get());
+}
+
+}  // namespace MediaProcessor::Tests
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
+#include <sys/resource.h>
 
+#include <chrono>
+#include <cstdlib>
 #include <filesystem>
+#include <vector>
 
 #include "../src/Utils.h"
 
@@ -38,4 +42,113 @@ TEST(UtilsTester, TrimTrailingSpaces) {
     EXPECT_EQ(inputWithoutTrailingSpace, Utils::trimTrailingSpace(inputWithoutTrailingSpace));
 }
 
+TEST(UtilsTester, SanitizeFilename_ReplacesUnsafeCharactersAndRejectsHiddenNames) {
+    EXPECT_EQ(Utils::sanitizeFilename("my talk (final).mp4"), "my_talk__final_.mp4");
+    EXPECT_EQ(Utils::sanitizeFilename("../config.json"), "");
+    EXPECT_EQ(Utils::sanitizeFilename("a/../../b.wav"), "a_.._.._b.wav");
+    EXPECT_EQ(Utils::sanitizeFilename(".hidden"), "");
+}
+
+TEST(UtilsTester, RunCommand_CapturesOutput) {
+    auto output = Utils::runCommand("echo hello", true);
+
+    ASSERT_TRUE(output.has_value());
+    EXPECT_EQ(*output, "hello\n");
+    EXPECT_FALSE(Utils::runCommand("exit 3"));
+}
+
+TEST(UtilsTester, RunCommand_StageDeadlineExceeded_KillsChildPromptly) {
+    CancellationToken stageToken = CancellationToken().withTimeout(std::chrono::milliseconds(200));
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(Utils::runCommand("sleep 30", stageToken));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(stageToken.isCancelled());
+    EXPECT_LT(elapsed, std::chrono::seconds(5));
+}
+
+TEST(UtilsTester, OpenWavForWrite_SmallFile_DowngradesToRiffWav) {
+    fs::path wavPath = fs::temp_directory_path() / "test_small_rf64.wav";
+
+    SF_INFO sfInfo{};
+    sfInfo.samplerate = 48000;
+    sfInfo.channels = 1;
+    sfInfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+
+    SNDFILE* file = Utils::openWavForWrite(wavPath, sfInfo);
+    ASSERT_NE(file, nullptr);
+    std::vector<float> block(4800, 0.25f);
+    EXPECT_EQ(sf_writef_float(file, block.data(), block.size()),
+              static_cast<sf_count_t>(block.size()));
+    sf_close(file);
+
+    SF_INFO readInfo{};
+    file = sf_open(wavPath.c_str(), SFM_READ, &readInfo);
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(readInfo.format & SF_FORMAT_TYPEMASK, SF_FORMAT_WAV);
+    EXPECT_EQ(readInfo.format & SF_FORMAT_SUBMASK, SF_FORMAT_PCM_16);
+    EXPECT_EQ(readInfo.frames, static_cast<sf_count_t>(block.size()));
+    sf_close(file);
+
+    fs::remove(wavPath);
+}
+
+TEST(UtilsTester, OpenWavForWrite_StreamBeyond4GiB_WritesRF64InBoundedMemory) {
+    /*
+     * Writes ~4.1 GiB of synthetic PCM to disk in fixed-size blocks, the same way the filter
+     * loop streams chunks. Opt in with MEDIAPROCESSOR_LARGE_FILE_TESTS=1 since it needs the disk.
+     */
+    if (!std::getenv("MEDIAPROCESSOR_LARGE_FILE_TESTS")) {
+        GTEST_SKIP() << "Set MEDIAPROCESSOR_LARGE_FILE_TESTS=1 to run the >4 GiB stream test.";
+    }
+
+    constexpr sf_count_t blockFrames = 48000;
+    constexpr sf_count_t totalFrames = (4LL * 1024 * 1024 * 1024) / 2 + 10 * blockFrames;
+    constexpr long maxRssGrowthKb = 64 * 1024;
+
+    fs::path wavPath = fs::temp_directory_path() / "test_large_rf64.wav";
+
+    rusage usageBefore{};
+    getrusage(RUSAGE_SELF, &usageBefore);
+
+    SF_INFO sfInfo{};
+    sfInfo.samplerate = 48000;
+    sfInfo.channels = 1;
+    sfInfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+
+    SNDFILE* file = Utils::openWavForWrite(wavPath, sfInfo);
+    ASSERT_NE(file, nullptr);
+
+    std::vector<float> block(blockFrames);
+    for (sf_count_t written = 0; written < totalFrames; written += blockFrames) {
+        sf_count_t framesToWrite = std::min(blockFrames, totalFrames - written);
+        for (sf_count_t i = 0; i < framesToWrite; ++i) {
+            block[i] = static_cast<float>((written + i) % 200) / 400.0f;
+        }
+        ASSERT_EQ(sf_writef_float(file, block.data(), framesToWrite), framesToWrite);
+    }
+    sf_close(file);
+
+    SF_INFO readInfo{};
+    file = sf_open(wavPath.c_str(), SFM_READ, &readInfo);
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(readInfo.format & SF_FORMAT_TYPEMASK, SF_FORMAT_RF64);
+    EXPECT_EQ(readInfo.frames, totalFrames);
+
+    // Samples past the 4 GiB boundary must read back intact
+    sf_count_t tailStart = totalFrames - blockFrames;
+    ASSERT_EQ(sf_seek(file, tailStart, SEEK_SET), tailStart);
+    ASSERT_EQ(sf_readf_float(file, block.data(), blockFrames), blockFrames);
+    for (sf_count_t i = 0; i < blockFrames; i += 997) {
+        EXPECT_NEAR(block[i], static_cast<float>((tailStart + i) % 200) / 400.0f, 1e-4);
+    }
+    sf_close(file);
+    fs::remove(wavPath);
+
+    rusage usageAfter{};
+    getrusage(RUSAGE_SELF, &usageAfter);
+    EXPECT_LT(usageAfter.ru_maxrss - usageBefore.ru_maxrss, maxRssGrowthKb);
+}
+
 }  // namespace MediaProcessor::Tests
\ No newline at end of file
@@ -3,8 +3,9 @@
 #include <filesystem>
 #include <string>
 
+#include "../src/AsyncRuntime.h"
+#include "../src/CommandExecutor.h"
 #include "../src/ConfigManager.h"
-#include "../src/Utils.h"
 #include "../src/VideoProcessor.h"
 #include "TestUtils.h"
 
@@ -34,7 +35,7 @@ class VideoProcessorTester : public ::testing::Test {
         assertFileExists(testVideoPath);
         assertFileExists(testAudioPath);
 
-        testOutputDir = fs::current_path() / "test_output";
+        testOutputDir = TestUtils::getTestOutputDir();
         fs::create_directories(testOutputDir);
 
         nlohmann::json jsonObject = {
@@ -43,7 +44,8 @@ class VideoProcessorTester : public ::testing::Test {
             {"downloads_path", "downloads"},
             {"uploads_path", "uploads"},
             {"use_thread_cap", true},
-            {"max_threads_if_capped", 4}};
+            {"max_threads_if_capped", 4},
+            {"command_cassette", TestUtils::getCommandCassetteConfig()}};
         testConfigFile.generateConfigFile("testConfig.json", jsonObject);
 
         ASSERT_TRUE(configManager.loadConfig(testConfigFile.getFilePath()))
@@ -69,8 +71,13 @@ TEST_F(VideoProcessorTester, MergeMedia_MergesAudioAndVideoCorrectly) {
     EXPECT_EQ(videoProcessor.mergeMedia(), true);
     EXPECT_TRUE(fs::exists(testOutputVideoPath));
 
-    double originalDuration = MediaProcessor::Utils::getMediaDuration(testVideoPath);
-    double outputDuration = MediaProcessor::Utils::getMediaDuration(testOutputVideoPath);
+    // Probed through the cassette as well, so replaying needs no FFprobe either
+    AsyncRuntime runtime(1);
+    ASSERT_TRUE(installCommandCassette(runtime, configManager.getCommandCassette()));
+    double originalDuration =
+        syncWait(runtime.getMediaDuration(testVideoPath, CancellationToken()));
+    double outputDuration =
+        syncWait(runtime.getMediaDuration(testOutputVideoPath, CancellationToken()));
     EXPECT_NEAR(originalDuration, outputDuration, 0.5)
         << "Duration of the merged video differs significantly from the original.";
 }
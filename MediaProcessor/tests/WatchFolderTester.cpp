@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+
+#include "../src/AsyncRuntime.h"
+#include "../src/ConfigManager.h"
+#include "../src/CostModel.h"
+#include "../src/WatchFolder.h"
+#include "TestUtils.h"
+
+namespace fs = std::filesystem;
+namespace MediaProcessor::Tests {
+
+namespace {
+
+class WatchFolderTester : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        m_root = fs::temp_directory_path() /
+                 ("watch_folder_test_" + std::to_string(getpid()) + "_" +
+                  ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(m_root);
+        fs::create_directories(inbox());
+        m_config.directories = {inbox()};
+        m_config.outputPath = m_root / "output";
+        m_runtime.setCommandExecutor(std::make_shared<TestUtils::ProbeOnlyExecutor>());
+        loadConfig(nlohmann::json::object());
+    }
+
+    void TearDown() override { fs::remove_all(m_root); }
+
+    void loadConfig(const nlohmann::json& options) {
+        nlohmann::json config = {{"ffmpeg_path", "/usr/bin/ffmpeg"},
+                                 {"deep_filter_path", "missing"},
+                                 {"filter_attenuation_limit", 100.0f},
+                                 {"use_thread_cap", false},
+                                 {"max_threads_if_capped", 1},
+                                 {"max_concurrent_jobs", 1}};
+        config.update(options);
+        m_configFile.generateConfigFile(m_root / "config.json", config);
+        ASSERT_TRUE(ConfigManager::getInstance().loadConfig(m_configFile.getFilePath()));
+    }
+
+    fs::path inbox() const { return m_root / "inbox"; }
+    fs::path failed() const { return m_config.outputPath / WATCH_FAILED_DIRECTORY; }
+
+    static std::string read(const fs::path& path) {
+        std::stringstream content;
+        content << std::ifstream(path).rdbuf();
+        return content.str();
+    }
+
+    fs::path m_root;
+    WatchFolderConfig m_config;
+    AsyncRuntime m_runtime{1};
+    CostModel m_costModel;
+    TestUtils::TestConfigFile m_configFile;
+};
+
+}  // namespace
+
+// ClassName_MethodName_StateUnderTest_ExpectedBehavior gtest std naming convention
+TEST_F(WatchFolderTester, SubmitBatch_JobFails_ClaimsInputAndPublishesItToFailed) {
+    std::ofstream(inbox() / "take.wav") << "take";
+    WatchFolder watchFolder(m_runtime, m_costModel, m_config);
+
+    EXPECT_EQ(watchFolder.submitBatch({inbox() / "take.wav"}), 1u);
+    EXPECT_FALSE(fs::exists(inbox() / "take.wav"));  // claimed at once
+    watchFolder.drain();
+
+    EXPECT_EQ(watchFolder.getNumCompleted(), 0u);
+    EXPECT_EQ(read(failed() / "take.wav"), "take");
+    EXPECT_TRUE(fs::exists(failed() / "take_report.json"));
+    EXPECT_TRUE(fs::is_empty(m_config.outputPath / WATCH_WORK_DIRECTORY));
+}
+
+TEST_F(WatchFolderTester, SubmitBatch_PublishedNameTaken_KeepsBothUnderNumberedName) {
+    fs::create_directories(failed());
+    std::ofstream(failed() / "take.wav") << "earlier";
+    std::ofstream(inbox() / "take.wav") << "take";
+    WatchFolder watchFolder(m_runtime, m_costModel, m_config);
+
+    watchFolder.submitBatch({inbox() / "take.wav"});
+    watchFolder.drain();
+
+    EXPECT_EQ(read(failed() / "take.wav"), "earlier");
+    EXPECT_EQ(read(failed() / "take_1.wav"), "take");
+    EXPECT_TRUE(fs::exists(failed() / "take_1_report.json"));
+}
+
+TEST_F(WatchFolderTester, SubmitBatch_ShedAsBusy_ReturnsInputToInbox) {
+    loadConfig({{"load_shedding", {{"policy", "reject"}, {"max_queue_wait_seconds", 1}}}});
+    std::ofstream(inbox() / "a.wav") << "a";
+    std::ofstream(inbox() / "b.wav") << "b";
+    WatchFolder watchFolder(m_runtime, m_costModel, m_config);
+
+    // Both are predicted alike, so the second waits for all of the first on the one lane
+    EXPECT_EQ(watchFolder.submitBatch({inbox() / "a.wav", inbox() / "b.wav"}), 2u);
+    watchFolder.drain();
+
+    EXPECT_EQ(read(failed() / "a.wav"), "a");
+    EXPECT_EQ(read(inbox() / "b.wav"), "b");
+    EXPECT_FALSE(fs::exists(failed() / "b.wav"));
+    EXPECT_TRUE(fs::is_empty(m_config.outputPath / WATCH_WORK_DIRECTORY));
+}
+
+TEST_F(WatchFolderTester, SubmitBatch_MissingFile_IsNotClaimed) {
+    WatchFolder watchFolder(m_runtime, m_costModel, m_config);
+
+    EXPECT_EQ(watchFolder.submitBatch({inbox() / "gone.wav"}), 0u);
+    watchFolder.drain();
+    EXPECT_FALSE(fs::exists(failed()));
+}
+
+}  // namespace MediaProcessor::Tests
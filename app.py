@@ -151,20 +151,31 @@ class MediaHandler:
         try:
             logging.info(f"Processing media file with path: {media_path}")
 
-            result = subprocess.run(
-                ["./MediaProcessor/build/MediaProcessor", str(media_path)], capture_output=True, text=True
+            process = subprocess.Popen(
+                ["./MediaProcessor/build/MediaProcessor", str(media_path)],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
             )
+            try:
+                stdout, stderr = process.communicate()
+            finally:
+                # Should waiting be interrupted (e.g. the worker shuts down), SIGTERM cancels the
+                # job and its FFmpeg children; a client disconnect is not noticed while waiting
+                if process.poll() is None:
+                    process.terminate()
+                    process.wait()
 
             # Propagate MediaProcessor outputs
-            logging.debug(f"MediaProcessor stdout: {result.stdout}")
-            logging.error(f"MediaProcessor stderr: {result.stderr}")
+            logging.debug(f"MediaProcessor stdout: {stdout}")
+            logging.error(f"MediaProcessor stderr: {stderr}")
 
-            if result.returncode != 0:
+            if process.returncode != 0:
                 logging.error("MediaProcessor returned a non-zero exit code.")
                 return None
 
             # Parse output
-            for line in result.stdout.splitlines():
+            for line in stdout.splitlines():
                 if "Video processed successfully" in line or "Audio processed successfully" in line:
                     processed_media_path = line.split(": ", 1)[1].strip()
 